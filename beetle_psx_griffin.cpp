@@ -1,14 +1,27 @@
+// Ahead of pgxp_gte.h and its max() macro, which the STL headers they use can't survive.
+#ifdef HAVE_CPU_PROFILER
+#include "mednafen/psx/profiler.cpp"
+#endif
+#ifdef HAVE_GPU_PROFILER
+#include "mednafen/psx/gpu_profiler.cpp"
+#endif
+
 
 #include "mednafen/psx/irq.cpp"
 #include "mednafen/psx/timer.cpp"
 #include "mednafen/psx/frontio.cpp"
 #include "mednafen/psx/cpu.cpp"
+#include "mednafen/psx/bios.cpp"
 #include "mednafen/psx/gte.cpp"
 #include "mednafen/psx/dis.cpp"
 #include "mednafen/psx/cdc.cpp"
 #include "mednafen/psx/spu.cpp"
 #include "mednafen/psx/gpu.cpp"
+#include "mednafen/psx/gpu_threads.cpp"
 #include "mednafen/psx/mdec.cpp"
+#ifdef HAVE_JIT
+#include "mednafen/psx/decomp.cpp"
+#endif
 #include "mednafen/psx/input/gamepad.cpp"
 #include "mednafen/psx/input/dualanalog.cpp"
 #include "mednafen/psx/input/dualshock.cpp"
@@ -1,7 +1,10 @@
 #include <jit/jit.h>
 #include <stdint.h>
 
-// This is passed as an array of uint32_t
+#include "psx.h"
+#include "decomp.h"
+
+// Blocks are passed PS_CPU's GPR file as an array of uint32_t; see decomp.h.
 typedef struct state_s {
 	uint32_t reg[32];
 	uint32_t pc;
@@ -10,136 +13,199 @@ typedef struct state_s {
 
 bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t inst, bool &branched);
 
-jit_value_t _make_uint(jit_function_t func, uint32_t val) {
+struct decomp_runtime decomp_rt;
+
+static jit_context_t context;
+static jit_type_t sig_1, sig_2, sig_3, block_sig;
+
+static jit_value_t _make_uint(jit_function_t func, uint32_t val) {
 	return jit_value_create_nint_constant(func, jit_type_uint, val);
 }
 #define make_uint(val) _make_uint(func, (val))
 
-jit_type_t sig_1, sig_2, sig_3;
-void store_memory(int size, uint32_t ptr, uint32_t val) {
+static jit_value_t _make_ptr(jit_function_t func, void *ptr) {
+	return jit_value_create_nint_constant(func, jit_type_void_ptr, (jit_nint) ptr);
 }
+#define make_ptr(ptr) _make_ptr(func, (ptr))
 
-void call_store_memory(jit_function_t func, int size, jit_value_t ptr, jit_value_t val) {
-	jit_value_t args[] = {make_uint(size), ptr, val};
-	jit_insn_call_native(func, 0, (void *) store_memory, sig_3, args, 3, 0);
+static int32_t signext(int size, uint32_t imm) {
+	return ((int32_t) (imm << (32 - size))) >> (32 - size);
 }
 
-uint32_t load_memory(int size, uint32_t ptr) {
-	return 0;
+// Leaves the block, with the PC of the current instruction in state.
+static void emit_exit(jit_function_t func, uint32_t status) {
+	jit_insn_store_relative(func, make_ptr(&decomp_rt.exit), 0, make_uint(status));
+	jit_insn_return(func, NULL);
 }
 
-jit_value_t call_load_memory(jit_function_t func, int size, jit_value_t ptr) {
-	jit_value_t args[] = {make_uint(size), ptr};
-	return jit_insn_call_native(func, 0, (void *) load_memory, sig_2, args, 2, 0);
+// Leaves the block if a runtime helper reported a fault; must directly follow the helper call,
+// before any architectural state is written.
+static void emit_fault_check(jit_function_t func) {
+	jit_label_t ok = jit_label_undefined;
+	jit_value_t status = jit_insn_load_relative(func, make_ptr(&decomp_rt.exit), 0, jit_type_uint);
+	jit_insn_branch_if_not(func, jit_insn_eq(func, status, make_uint(DECOMP_EXIT_FAULT)), &ok);
+	jit_insn_return(func, NULL);
+	jit_insn_label(func, &ok);
 }
 
-uint32_t read_copreg(int cop, int reg) {
-	return 0;
+// Leaves the block after a completed instruction if a helper asked for it.
+static void emit_sync_check(jit_function_t func) {
+	jit_label_t ok = jit_label_undefined;
+	jit_value_t status = jit_insn_load_relative(func, make_ptr(&decomp_rt.exit), 0, jit_type_uint);
+	jit_insn_branch_if_not(func, status, &ok);
+	jit_insn_return(func, NULL);
+	jit_insn_label(func, &ok);
 }
 
-jit_value_t call_read_copreg(jit_function_t func, int cop, int reg) {
-	jit_value_t args[] = {make_uint(cop), make_uint(reg)};
-	return jit_insn_call_native(func, 0, (void *) read_copreg, sig_2, args, 2, 0);
+static void emit_timestamp_add(jit_function_t func, unsigned cycles) {
+	if(!cycles)
+		return;
+
+	jit_value_t ptr = make_ptr(&decomp_rt.timestamp);
+	jit_value_t ts = jit_insn_load_relative(func, ptr, 0, jit_type_int);
+	jit_insn_store_relative(func, ptr, 0, jit_insn_add(func, ts, jit_value_create_nint_constant(func, jit_type_int, cycles)));
 }
 
-uint32_t read_copcreg(int cop, int reg) {
+static uint32_t store_memory(uint32_t size, uint32_t ptr, uint32_t val) {
+	CPU->JIT_Store(size, ptr, val);
 	return 0;
 }
 
-jit_value_t call_read_copcreg(jit_function_t func, int cop, int reg) {
-	jit_value_t args[] = {make_uint(cop), make_uint(reg)};
-	return jit_insn_call_native(func, 0, (void *) read_copcreg, sig_2, args, 2, 0);
+static void call_store_memory(jit_function_t func, int size, jit_value_t ptr, jit_value_t val) {
+	jit_value_t args[] = {make_uint(size), ptr, val};
+	jit_insn_call_native(func, 0, (void *) store_memory, sig_3, args, 3, 0);
+	emit_fault_check(func);
 }
 
-void write_copreg(int cop, int reg, uint32_t val) {
+static uint32_t load_memory(uint32_t size, uint32_t ptr) {
+	return CPU->JIT_Load(size, ptr);
 }
 
-void call_write_copreg(jit_function_t func, int cop, int reg, jit_value_t val) {
-	jit_value_t args[] = {make_uint(cop), make_uint(reg), val};
-	jit_insn_call_native(func, 0, (void *) write_copreg, sig_3, args, 3, 0);
+static jit_value_t call_load_memory(jit_function_t func, int size, jit_value_t ptr) {
+	jit_value_t args[] = {make_uint(size), ptr};
+	jit_value_t ret = jit_insn_call_native(func, 0, (void *) load_memory, sig_2, args, 2, 0);
+	emit_fault_check(func);
+	return ret;
 }
 
-void write_copcreg(int cop, int reg, uint32_t val) {
+// Only the GTE is reachable from translated code; other coprocessor accesses are
+// left to the interpreter.
+static uint32_t read_gte(uint32_t control, uint32_t reg) {
+	return CPU->JIT_ReadGTE(control, reg);
 }
 
-void call_write_copcreg(jit_function_t func, int cop, int reg, jit_value_t val) {
-	jit_value_t args[] = {make_uint(cop), make_uint(reg), val};
-	jit_insn_call_native(func, 0, (void *) write_copcreg, sig_3, args, 3, 0);
+static jit_value_t call_read_gte(jit_function_t func, int cop, int reg, bool control) {
+	if(cop != 2) {
+		emit_exit(func, DECOMP_EXIT_FAULT);
+		return make_uint(0);
+	}
+
+	jit_value_t args[] = {make_uint(control), make_uint(reg)};
+	return jit_insn_call_native(func, 0, (void *) read_gte, sig_2, args, 2, 0);
 }
 
-void copfun(int cop, int cofun) {
+static jit_value_t call_read_copreg(jit_function_t func, int cop, int reg) {
+	return call_read_gte(func, cop, reg, false);
 }
 
-jit_value_t call_copfun(jit_function_t func, int cop, int cofun) {
-	jit_value_t args[] = {make_uint(cop), make_uint(cofun)};
-	return jit_insn_call_native(func, 0, (void *) copfun, sig_2, args, 2, 0);
+static jit_value_t call_read_copcreg(jit_function_t func, int cop, int reg) {
+	return call_read_gte(func, cop, reg, true);
 }
 
-int32_t signext(int size, uint32_t imm) {
-	if(size == 8)
-		return (int32_t) ((int8_t) ((uint8_t) imm));
-	else if(size == 16)
-		return (int32_t) ((int16_t) ((uint16_t) imm));
-	return (int32_t) imm;
+static uint32_t write_gte(uint32_t control, uint32_t reg, uint32_t val) {
+	CPU->JIT_WriteGTE(control, reg, val);
+	return 0;
 }
 
-jit_value_t call_signext(jit_function_t func, int size, jit_value_t val) {
-	jit_value_t args[] = {make_uint(size), val};
-	return jit_insn_call_native(func, 0, (void *) signext, sig_2, args, 2, 0);
+static void call_write_gte(jit_function_t func, int cop, int reg, jit_value_t val, bool control) {
+	if(cop != 2) {
+		emit_exit(func, DECOMP_EXIT_FAULT);
+		return;
+	}
+
+	jit_value_t args[] = {make_uint(control), make_uint(reg), val};
+	jit_insn_call_native(func, 0, (void *) write_gte, sig_3, args, 3, 0);
 }
 
-void syscall(int code) {
+static void call_write_copreg(jit_function_t func, int cop, int reg, jit_value_t val) {
+	call_write_gte(func, cop, reg, val, false);
 }
 
-void call_syscall(jit_function_t func, uint32_t code) {
-	jit_value_t args[] = {make_uint(code)};
-	jit_insn_call_native(func, 0, (void *) syscall, sig_1, args, 1, 0);
+static void call_write_copcreg(jit_function_t func, int cop, int reg, jit_value_t val) {
+	call_write_gte(func, cop, reg, val, true);
 }
 
-void break_(int code) {
+static uint32_t gte_instruction(uint32_t instr) {
+	CPU->JIT_GTEInstruction(instr);
+	return 0;
 }
 
-void call_break(jit_function_t func, uint32_t code) {
-	jit_value_t args[] = {make_uint(code)};
-	jit_insn_call_native(func, 0, (void *) break_, sig_1, args, 1, 0);
+static void call_copfun(jit_function_t func, int cop, int cofun) {
+	if(cop != 2) {
+		emit_exit(func, DECOMP_EXIT_FAULT);
+		return;
+	}
+
+	jit_value_t args[] = {make_uint((0x12 << 26) | (1 << 25) | cofun)};
+	jit_insn_call_native(func, 0, (void *) gte_instruction, sig_1, args, 1, 0);
 }
 
-void branch(uint32_t target) {
+static jit_value_t call_signext(jit_function_t func, int size, jit_value_t val) {
+	jit_value_t narrow = jit_insn_convert(func, val, size == 8 ? jit_type_sbyte : jit_type_short, 0);
+	return jit_insn_convert(func, narrow, jit_type_int, 0);
 }
 
-void call_branch(jit_function_t func, jit_value_t val) {
-	jit_value_t args[] = {val};
-	jit_insn_call_native(func, 0, (void *) branch, sig_1, args, 1, 0);
+// Exceptions are raised by the interpreter, which re-executes the instruction.
+static void call_syscall(jit_function_t func, uint32_t code) {
+	emit_exit(func, DECOMP_EXIT_FAULT);
 }
 
-void overflow(uint32_t a, uint32_t b, int dir) {
+static void call_break(jit_function_t func, uint32_t code) {
+	emit_exit(func, DECOMP_EXIT_FAULT);
 }
 
-void call_overflow(jit_function_t func, jit_value_t a, jit_value_t b, int dir) {
-	jit_value_t args[] = {a, b, make_uint(dir)};
-	jit_insn_call_native(func, 0, (void *) overflow, sig_3, args, 3, 0);
+static void call_branch(jit_function_t func, jit_value_t val) {
+	jit_insn_store_relative(func, make_ptr(&decomp_rt.branch_target), 0, val);
+	jit_insn_store_relative(func, make_ptr(&decomp_rt.branch_taken), 0, make_uint(1));
 }
 
-jit_context_t context;
+static void call_overflow(jit_function_t func, jit_value_t a, jit_value_t b, int dir) {
+	jit_label_t ok = jit_label_undefined;
+	jit_value_t result = dir > 0 ? jit_insn_add(func, a, b) : jit_insn_sub(func, a, b);
+	// Same test as the interpreter: operand signs agree (add) or differ (sub), and the result's sign differs from a.
+	jit_value_t ops = dir > 0 ? jit_insn_not(func, jit_insn_xor(func, a, b)) : jit_insn_xor(func, a, b);
+	jit_value_t ov = jit_insn_and(func, jit_insn_and(func, ops, jit_insn_xor(func, a, result)), make_uint(0x80000000));
+	jit_insn_branch_if_not(func, ov, &ok);
+	emit_exit(func, DECOMP_EXIT_FAULT);
+	jit_insn_label(func, &ok);
+}
 
-jit_type_t block_sig;
+// Instructions whose translation calls back into the emulator (memory, GTE) or can fault.
+static bool needs_sync(uint32_t inst) {
+	const uint32_t op = inst >> 26;
 
-void init_decompiler() {
+	if(op >= 0x20 || op == 0x12 || op == 0x08)
+		return true;
+
+	return op == 0 && ((inst & 0x3F) == 0x20 || (inst & 0x3F) == 0x22);
+}
+
+void decomp_init(void) {
+	jit_init();
 	context = jit_context_create();
-	jit_context_build_start(context);
 
 	jit_type_t s3params[3];
 	s3params[0] = jit_type_uint;
 	s3params[1] = jit_type_uint;
 	s3params[2] = jit_type_uint;
 	sig_3 = jit_type_create_signature(jit_abi_cdecl, jit_type_uint, s3params, 3, 1);
-	
+
 	jit_type_t sparams[2];
 	sparams[0] = jit_type_uint;
 	sparams[1] = jit_type_uint;
 	sig_2 = jit_type_create_signature(jit_abi_cdecl, jit_type_uint, sparams, 2, 1);
-	
-	jit_type_t lparams[2];
+
+	jit_type_t lparams[1];
 	lparams[0] = jit_type_uint;
 	sig_1 = jit_type_create_signature(jit_abi_cdecl, jit_type_uint, lparams, 1, 1);
 
@@ -148,9 +214,72 @@ void init_decompiler() {
 	block_sig = jit_type_create_signature(jit_abi_cdecl, jit_type_void, params, 1, 1);
 }
 
-jit_function_t create_function() {
-	auto func = jit_function_create(context, signature);
-	auto statevar = jit_value_get_param(func, 0);
-	decompile(func, statevar, 0xDEADBEE0, 0x0, branched);
-	return 0;
-}
\ No newline at end of file
+void decomp_kill(void) {
+	if(!context)
+		return;
+
+	jit_context_destroy(context);
+	context = NULL;
+
+	jit_type_free(sig_1);
+	jit_type_free(sig_2);
+	jit_type_free(sig_3);
+	jit_type_free(block_sig);
+}
+
+void decomp_reset(void) {
+	// libjit cannot free single functions, so drop the whole context.
+	if(context)
+		jit_context_destroy(context);
+	context = jit_context_create();
+}
+
+decomp_block_fn decomp_translate(uint32_t pc, const uint32_t *insts, unsigned count, unsigned inst_cycles) {
+	jit_function_t func;
+	jit_value_t state;
+	unsigned pending = 0;
+	void *closure;
+
+	jit_context_build_start(context);
+
+	func = jit_function_create(context, block_sig);
+	state = jit_value_get_param(func, 0);
+
+	for(unsigned i = 0; i < count; i++) {
+		const uint32_t inst = insts[i];
+		const bool sync = needs_sync(inst);
+		bool branched = false;
+
+		pending += inst_cycles;
+
+		// Helpers see the timestamp as of the current instruction.
+		if(sync) {
+			emit_timestamp_add(func, pending);
+			pending = 0;
+		}
+
+		if(!decompile(func, state, pc + i * 4, inst, branched)) {
+			emit_timestamp_add(func, pending);
+			jit_insn_store_relative(func, state, 32*4, make_uint(pc + i * 4));
+			emit_exit(func, DECOMP_EXIT_FAULT);
+			break;
+		}
+
+		if(sync)
+			emit_sync_check(func);
+	}
+
+	emit_timestamp_add(func, pending);
+	jit_insn_return(func, NULL);
+
+	if(!jit_function_compile(func)) {
+		jit_function_abandon(func);
+		jit_context_build_end(context);
+		return NULL;
+	}
+
+	jit_context_build_end(context);
+
+	closure = jit_function_to_closure(func);
+	return (decomp_block_fn) closure;
+}
@@ -101,7 +101,9 @@ def output(expr, top=True):
 	elif op in gops:
 		return output(gops[op](*expr[1:]))
 	elif op == 'zeroext':
-		return output(expr[1])
+		return '(%s) & 0x%x' % (output(expr[2], top=False), (1 << expr[1]) - 1)
+	elif op == 'signed':
+		return '(int32_t) (%s)' % output(expr[1], top=False)
 	else:
 		return '%s(%s)%s' % (op, ', '.join(output(x, top=False) for x in expr[1:]), ';' if top else '')
 
@@ -222,11 +224,19 @@ def tempname():
 	temp_i += 1
 	return 'temp_%i' % temp_i
 
+def is_dynamic(val):
+	return val.startswith('jit_') or val.startswith('call_')
+
 def to_val(val):
-	if val.startswith('jit_') or val.startswith('call_'):
+	if is_dynamic(val):
 		return val
 	return 'jit_value_create_nint_constant(func, jit_type_uint, %s)' % val
 
+def is_signed(sexp):
+	if isinstance(sexp, list) and len(sexp) == 1:
+		sexp = sexp[0]
+	return isinstance(sexp, tuple) and sexp[0] == 'signed'
+
 def emitter(sexp, storing=False):
 	if isinstance(sexp, list):
 		if len(sexp) == 1:
@@ -247,7 +257,7 @@ def emitter(sexp, storing=False):
 		if isinstance(lvalue, list) and len(lvalue) == 1:
 			lvalue = lvalue[0]
 		if lvalue[0] == 'reg':
-			return 'jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, %s, %s)), 0, %s);' % (to_val(emitter(lvalue[1])), to_val('4'), to_val(emitter(sexp[2])))
+			return 'jit_insn_store_relative(func, state, (%s) * 4, %s);' % (emitter(lvalue[1]), to_val(emitter(sexp[2])))
 		elif lvalue[0] == 'pc':
 			return 'jit_insn_store_relative(func, state, 32*4, %s);' % to_val(emitter(sexp[2]))
 		elif lvalue[0] == 'hi':
@@ -262,7 +272,7 @@ def emitter(sexp, storing=False):
 			print 'Unknown lvalue', lvalue
 			raise False
 	elif op == 'reg':
-		return 'jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, %s, %s)), 0, jit_type_uint)' % (to_val(emitter(sexp[1])), to_val('4'))
+		return 'jit_insn_load_relative(func, state, (%s) * 4, jit_type_uint)' % emitter(sexp[1])
 	elif op == 'pc':
 		return 'jit_insn_load_relative(func, state, 32*4, jit_type_uint)'
 	elif op == 'hi':
@@ -292,7 +302,7 @@ def emitter(sexp, storing=False):
 		end = tempname()
 		return [
 			'jit_label_t %s = jit_label_undefined, %s = jit_label_undefined;' % (temp, end), 
-			'jit_insn_branch_if(func, %s, &%s);' % (to_val(emitter(sexp[1])), temp), 
+			'jit_insn_branch_if_not(func, %s, &%s);' % (to_val(emitter(sexp[1])), temp), 
 			emitter(sexp[2]), 
 			'jit_insn_branch(func, &%s);' % end, 
 			'jit_insn_label(func, &%s);' % temp, 
@@ -316,6 +326,22 @@ def emitter(sexp, storing=False):
 		return emitter(sexp[2], storing=storing)
 	elif op == 'signext':
 		return 'call_signext(func, %i, %s)' % (sexp[1], emitter(sexp[2], storing=storing))
+	elif op == 'signed':
+		value = emitter(sexp[1], storing=storing)
+		if is_dynamic(value):
+			return 'jit_insn_convert(func, %s, jit_type_int, 0)' % value
+		return 'jit_value_create_nint_constant(func, jit_type_int, (int32_t) (%s))' % value
+	elif op in ('shl', 'shra', 'shrl'):
+		# Shift amounts coming from a register only use the low 5 bits.
+		value = ('signed', sexp[1]) if op == 'shra' else sexp[1]
+		count = emitter(sexp[2], storing=storing)
+		if is_dynamic(count):
+			count = 'jit_insn_and(func, %s, %s)' % (count, to_val('0x1f'))
+		return '%s(func, %s, %s)' % (eops[op](None, None)[0], to_val(emitter(value, storing=storing)), to_val(count))
+	elif op in ('lt', 'le', 'gt', 'ge') and (is_signed(sexp[1]) or is_signed(sexp[2])):
+		# Signed comparisons need both operands signed, or libjit picks an unsigned common type.
+		args = [x if is_signed(x) else ('signed', x) for x in sexp[1:]]
+		return emitter(eops[op](*args), storing=storing)
 	elif op in eops:
 		return emitter(eops[op](*sexp[1:]), storing=storing)
 	elif op.startswith('jit_'):
@@ -380,7 +406,7 @@ def genDecomp((name, type, dasm, dag)):
 		elif op == 'unsigned':
 			return subgen(dag[1])
 		elif op == 'signed':
-			return subgen(dag[1])
+			return ('signed', subgen(dag[1]))
 		elif op == 'check_overflow':
 			return [('emit', ('overflow', subgen(dag[1])))]
 		elif op == 'raise':
@@ -409,12 +435,159 @@ def genDecomp((name, type, dasm, dag)):
 
 	return code
 
+def strip_let(dag):
+	# Peels the immediate's extension off an instruction, returning (extension, body).
+	if dag[0] == 'let' and dag[1] in ('$eimm', '$offset') and len(dag) == 4:
+		return dag[2], dag[3]
+	return None, dag
+
+def extKind(ext):
+	# 'signext' or 'zeroext' for an extension from strip_let(), looking through the
+	# signed/unsigned a comparison may wrap it in (SLTIU's is sign extended).
+	while ext is not None and ext[0] in ('signed', 'unsigned'):
+		ext = ext[1]
+	return ext[0] if ext is not None else None
+
+def isSimpleALU((name, type, dasm, dag)):
+	# Register/immediate ALU ops that can't trap, write exactly one GPR and don't touch
+	# memory, HI/LO or the PC: what the interpreter's generated handlers cover.
+	if type not in ('RType', 'IType'):
+		return False
+	ext, body = strip_let(dag)
+	if body[0] == 'if':
+		return body[2][0] == 'set' and body[2][2] == 1 and body[3][0] == 'set' and body[3][2] == 0
+	return body[0] == 'set' and body[1][0] == 'gpr' and isinstance(body[1][1], basestring) and body[2][0] in gops
+
+def interpExpr(dag, top=True):
+	if isinstance(dag, basestring):
+		return {'$eimm' : 'immediate', '$imm' : 'immediate', '$shamt' : 'shamt'}[dag]
+	elif isinstance(dag, int) or isinstance(dag, long):
+		return '%i' % dag
+
+	op = dag[0]
+	if op == 'gpr':
+		return 'GPR[%s]' % dag[1].replace('$', '')
+	elif op == 'unsigned':
+		return interpExpr(dag[1], top)
+	elif op == 'signed':
+		return '(int32)%s' % interpExpr(dag[1], False)
+	elif op in ('shl', 'shrl', 'shra'):
+		value = interpExpr(dag[1], False)
+		count = interpExpr(dag[2], False)
+		if isinstance(dag[2], list) and dag[2][0] == 'gpr':
+			count = '(%s & 0x1F)' % count
+		if op == 'shra':
+			value = '((int32)%s)' % value
+		ret = '%s %s %s' % (value, '<<' if op == 'shl' else '>>', count)
+	elif op == 'nor':
+		return '~(%s | %s)' % (interpExpr(dag[1], False), interpExpr(dag[2], False))
+	elif op in ('lt', 'le', 'gt', 'ge') and any(isinstance(x, list) and x[0] == 'signed' for x in dag[1:]):
+		# Same rule as the JIT: a signed comparison has both sides signed.
+		args = [x if isinstance(x, list) and x[0] == 'signed' else ['signed', x] for x in dag[1:]]
+		ret = '%s %s %s' % (interpExpr(args[0], False), gops[op](None, None)[0], interpExpr(args[1], False))
+	elif op in gops:
+		ret = '%s %s %s' % (interpExpr(dag[1], False), gops[op](None, None)[0], interpExpr(dag[2], False))
+	else:
+		print 'Unknown op in interpreter expression:', dag
+		assert False
+
+	return ret if top else '(%s)' % ret
+
+def gprReads(dag, regs):
+	if isinstance(dag, list):
+		if dag[0] == 'gpr':
+			if dag[1] not in regs:
+				regs.append(dag[1])
+		else:
+			for x in dag[1:]:
+				gprReads(x, regs)
+	return regs
+
+def genInterp((name, type, dasm, dag)):
+	ext, body = strip_let(dag)
+	if body[0] == 'if':
+		dest, src = body[2][1][1], body[1]
+		result = '(bool)(%s)' % interpExpr(src)
+	else:
+		dest, src = body[1][1], body[2]
+		result = interpExpr(src)
+
+	if type == 'RType':
+		decode = 'RTYPE'
+	else:
+		# Decoded the way insts.td extends the immediate; a bare $imm(LUI) is the raw field.
+		decode = {'signext' : 'ITYPE', 'zeroext' : 'ITYPE_ZE', None : 'ITYPE_ZE'}[extKind(ext)]
+
+	srcs = gprReads(src, [])
+	deps = ''.join('\tGPR_DEP(%s);\n' % x.replace('$', '') for x in sorted(srcs))
+	pgxp = ''.join(', GPR[%s]' % x.replace('$', '') for x in srcs)
+	dest = dest.replace('$', '')
+
+	return '''    //
+    // %(name)s
+    //
+    BEGIN_OPF(%(name)s);
+	%(decode)s;
+
+	GPR_DEPRES_BEGIN
+%(deps)s	GPR_RES(%(dest)s);
+	GPR_DEPRES_END
+
+	uint32 result = %(result)s;
+
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
+		PGXP_CPU_%(name)s(instr, result%(pgxp)s);
+
+	DO_LDS();
+
+	GPR[%(dest)s] = result;
+
+    END_OPF;
+''' % locals()
+
+def disFormat((name, type, dasm, dag)):
+	mnemonic, _, operands = dasm.partition(' ')
+	ext, body = strip_let(dag)
+	operands = operands.replace('$offset(%$rs)', 'i(s)')
+	operands = operands.replace('%$rs', 's').replace('%$rt', 't').replace('%$rd', 'd')
+	operands = operands.replace('$shamt', 'a').replace('$code', '')
+	operands = operands.replace('$eimm', 'z' if extKind(ext) == 'zeroext' else 'i')
+	operands = operands.replace('$imm', 'z')
+	operands = operands.replace('$target', 'P' if type == 'JType' else 'p')
+	return mnemonic, operands.strip()
+
+def genDisTable():
+	regimm = []
+	entries = []
+	for name, type, op, funct, dasm, dag in sorted(ops, key=lambda x: (x[2], x[3])):
+		if type == 'CFType':
+			continue
+		mnemonic, format = disFormat((name, type, dasm, dag))
+		if type == 'RIType' and op == 1:
+			# Only bits 0 and 4 of rt are decoded; the linking versions go first so the
+			# looser non-linking masks don't swallow them.
+			link = funct & 0x10
+			regimm.append((not link, ' MK_OP_REGIMM("%s",\t0x%02X, 0x%02X),' % (mnemonic, 0x1F if link else 0x01, funct)))
+		else:
+			entries.append(' MK_OP("%s",\t"%s", %i, %i, 0),' % (mnemonic, format, op, funct if op == 0 else 0))
+	return [x[1] for x in sorted(regimm)] + entries
+
 def build():
 	print 'Rebuilding from tables'
 	with file('mednafen/psx/decomp.cpp', 'w') as fp:
 		print >>fp, '/* Autogenerated from insts.td. DO NOT EDIT */'
 		print >>fp, file('decompstub.cpp', 'r').read()
 		print >>fp, 'bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t inst, bool &branched) {%s\treturn false;\n}' % indent(output(generate(genDecomp)))
+	with file('mednafen/psx/cpu_alu.inc', 'w') as fp:
+		print >>fp, '/* Autogenerated from insts.td. DO NOT EDIT */'
+		print >>fp, '// Interpreter handlers for the non-trapping ALU instructions; included by PS_CPU::RunReal().'
+		for name, type, op, funct, dasm, dag in sorted(ops):
+			if isSimpleALU((name, type, dasm, dag)):
+				print >>fp
+				fp.write(genInterp((name, type, dasm, dag)))
+	with file('mednafen/psx/dis_ops.inc', 'w') as fp:
+		print >>fp, '/* Autogenerated from insts.td. DO NOT EDIT */'
+		print >>fp, '\n'.join(genDisTable())
 
 if __name__=='__main__':
 	build()
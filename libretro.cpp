@@ -21,6 +21,13 @@
 #include "../pgxp/pgxp_main.h"
 
 #include <vector>
+
+// Not in our copy of libretro.h yet; bit 0 of the result clear means the
+// frontend won't show the frame(runahead, headless runs).
+#ifndef RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE
+#define RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE (47 | RETRO_ENVIRONMENT_EXPERIMENTAL)
+#endif
+
 #define ISHEXDEC ((codeLine[cursor]>='0') && (codeLine[cursor]<='9')) || ((codeLine[cursor]>='a') && (codeLine[cursor]<='f')) || ((codeLine[cursor]>='A') && (codeLine[cursor]<='F'))
 
 struct retro_perf_callback perf_cb;
@@ -35,7 +42,13 @@ static unsigned players = 2;
 static unsigned frame_count = 0;
 static unsigned internal_frame_count = 0;
 static bool display_internal_framerate = false;
+#ifdef HAVE_GPU_PROFILER
+static bool display_gpu_profile = false;
+static unsigned gpu_profile_frame_count = 0;
+#endif
 static bool allow_frame_duping = false;
+static unsigned frame_skip = 0;
+static unsigned frame_skip_count = 0;
 static bool failed_init = false;
 static unsigned image_offset = 0;
 static unsigned image_crop = 0;
@@ -54,8 +67,12 @@ static bool enable_variable_serialization_size = false;
 
 
 static int psx_skipbios;
+static unsigned psx_gpu_raster_threads = 0;
 
 bool psx_cpu_overclock;
+bool psx_gte_lazy_flags;
+bool psx_cpu_idle_skip = true;
+bool psx_cpu_bios_hle;
 static bool is_pal;
 enum dither_mode psx_gpu_dither_mode;
 
@@ -143,11 +160,19 @@ static void extract_directory(char *buf, const char *path, size_t size)
 #include "mednafen/psx/sio.h"
 #include "mednafen/psx/cdc.h"
 #include "mednafen/psx/spu.h"
+#ifdef HAVE_CPU_PROFILER
+#include "mednafen/psx/profiler.h"
+#endif
+#ifdef HAVE_GPU_PROFILER
+#include "mednafen/psx/gpu_profiler.h"
+#endif
 #include "mednafen/mempatcher.h"
 
 #include <stdarg.h>
 #include <ctype.h>
 
+enum cpu_core_mode psx_cpu_core;
+
 bool setting_apply_analog_toggle  = false;
 bool use_mednafen_memcard0_method = false;
 
@@ -237,6 +262,59 @@ static MultiAccessSizeMem<65536, uint32, false> *PIOMem = NULL;
 
 MultiAccessSizeMem<2048 * 1024, uint32, false> MainRAM;
 
+uint32_t PSX_CodePageMap[PSX_CODE_PAGE_COUNT / 32];
+
+static struct
+{
+   psx_code_invalidate_t cb;
+   void *data;
+} CodeInvalidateCBs[4];
+
+void PSX_AddCodeInvalidateCB(psx_code_invalidate_t cb, void *data)
+{
+   unsigned i;
+
+   for(i = 0; i < sizeof(CodeInvalidateCBs) / sizeof(CodeInvalidateCBs[0]); i++)
+   {
+      if(!CodeInvalidateCBs[i].cb)
+      {
+         CodeInvalidateCBs[i].cb = cb;
+         CodeInvalidateCBs[i].data = data;
+         return;
+      }
+   }
+
+   assert(0);
+}
+
+void PSX_RemoveCodeInvalidateCB(psx_code_invalidate_t cb, void *data)
+{
+   unsigned i;
+
+   for(i = 0; i < sizeof(CodeInvalidateCBs) / sizeof(CodeInvalidateCBs[0]); i++)
+   {
+      if(CodeInvalidateCBs[i].cb == cb && CodeInvalidateCBs[i].data == data)
+      {
+         CodeInvalidateCBs[i].cb = NULL;
+         CodeInvalidateCBs[i].data = NULL;
+      }
+   }
+}
+
+void PSX_InvalidateCodePage(uint32_t A)
+{
+   const uint32_t page = (A & 0x1FFFFF) >> PSX_CODE_PAGE_SHIFT;
+   unsigned i;
+
+   PSX_CodePageMap[page >> 5] &= ~(1U << (page & 0x1F));
+
+   for(i = 0; i < sizeof(CodeInvalidateCBs) / sizeof(CodeInvalidateCBs[0]); i++)
+   {
+      if(CodeInvalidateCBs[i].cb)
+         CodeInvalidateCBs[i].cb(CodeInvalidateCBs[i].data, page << PSX_CODE_PAGE_SHIFT);
+   }
+}
+
 static uint32_t TextMem_Start;
 static std::vector<uint8> TextMem;
 
@@ -452,326 +530,318 @@ void PSX_RequestMLExit(void)
 //
 
 
-/* Remember to update MemPeek<>() and MemPoke<>() when we change address decoding in MemRW() */
-template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(int32_t &timestamp, uint32_t A, uint32_t &V)
+//
+// Memory access decoding: accesses MemRW() doesn't handle itself(anything but RAM) are dispatched through
+// MemRW_Handlers[], indexed by access kind and by the region the address falls in.  Regions are looked up
+// per 4KiB page of the physical address space, and per 32-bit word within the I/O page.
+//
+// Remember to update MemPeek<>() and MemPoke<>() when we change address decoding here.
+//
+enum
 {
-#if 0
-   if(IsWrite)
-      printf("Write%d: %08x(orig=%08x), %08x\n", (int)(sizeof(T) * 8), A & mask[A >> 29], A, V);
-   else
-      printf("Read%d: %08x(orig=%08x)\n", (int)(sizeof(T) * 8), A & mask[A >> 29], A);
-#endif
+   MEMRW_REGION_UNMAPPED = 0,
+   MEMRW_REGION_RAM,
+   MEMRW_REGION_BIOS,
+   MEMRW_REGION_IO,	// Page map only; resolved further with MemRW_IOMap[].
+   MEMRW_REGION_SPU,
+   MEMRW_REGION_CDC,
+   MEMRW_REGION_GPU,
+   MEMRW_REGION_MDEC,
+   MEMRW_REGION_SYSCONTROL,
+   MEMRW_REGION_FIO,
+   MEMRW_REGION_SIO,
+   MEMRW_REGION_IRQ,
+   MEMRW_REGION_DMA,
+   MEMRW_REGION_TIMER,
+   MEMRW_REGION_PIO,
+   MEMRW_REGION_BIU,
+   MEMRW_REGION_COUNT
+};
 
-   if(!IsWrite)
-      timestamp += DMACycleSteal;
+typedef void (*MemRWHandler)(int32_t &timestamp, uint32_t A, uint32_t &V);
 
-   //if(A == 0xa0 && IsWrite)
-   // DBG_Break();
+static uint8 MemRW_PageMap[0x20000000 >> 12];
+static uint8 MemRW_IOMap[0x1000 >> 2];	// 0x1F801000 - 0x1F801FFF
+static MemRWHandler MemRW_Handlers[8][MEMRW_REGION_COUNT];
 
-   if(A < 0x00800000)
-   {
-      if(IsWrite)
-      {
-         //timestamp++; // Best-case timing.
-      }
-      else
-      {
-         // Overclock: get rid of memory access latency
-         if (!psx_cpu_overclock)
-            timestamp += 3;
-      }
+template<typename T, bool IsWrite, bool Access24> static INLINE unsigned MemRW_Kind(void)
+{
+   return (IsWrite ? 4 : 0) + (Access24 ? 2 : (sizeof(T) == 1) ? 0 : (sizeof(T) == 2) ? 1 : 3);
+}
 
-      if(Access24)
-      {
-         if(IsWrite)
-            MainRAM.WriteU24(A & 0x1FFFFF, V);
-         else
-            V = MainRAM.ReadU24(A & 0x1FFFFF);
-      }
-      else
-      {
-         if(IsWrite)
-            MainRAM.Write<T>(A & 0x1FFFFF, V);
-         else
-            V = MainRAM.Read<T>(A & 0x1FFFFF);
-      }
+static INLINE unsigned MemRW_Region(uint32_t A)
+{
+   unsigned region;
 
-      return;
-   }
+   if(A >= 0x20000000)
+      return (A == 0xFFFE0130) ? MEMRW_REGION_BIU : MEMRW_REGION_UNMAPPED;
 
-   if(A >= 0x1FC00000 && A <= 0x1FC7FFFF)
-   {
-      if(!IsWrite)
-      {
-         if(Access24)
-            V = BIOSROM->ReadU24(A & 0x7FFFF);
-         else
-            V = BIOSROM->Read<T>(A & 0x7FFFF);
-      }
+   region = MemRW_PageMap[A >> 12];
 
-      return;
-   }
+   if(region == MEMRW_REGION_IO)
+      region = MemRW_IOMap[(A & 0xFFF) >> 2];
 
-   if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
-      PSX_EventHandler(timestamp);
+   return region;
+}
 
-   if(A >= 0x1F801000 && A <= 0x1F802FFF)
+template<typename T, bool IsWrite, bool Access24> static void MemRW_RAM(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(IsWrite)
    {
+      //timestamp++; // Best-case timing.
+   }
+   else
+   {
+      // Overclock: get rid of memory access latency
+      if (!psx_cpu_overclock)
+         timestamp += 3;
+   }
 
-      //if(IsWrite)
-      // printf("HW Write%d: %08x %08x\n", (unsigned int)(sizeof(T)*8), (unsigned int)A, (unsigned int)V);
-      //else
-      // printf("HW Read%d: %08x\n", (unsigned int)(sizeof(T)*8), (unsigned int)A);
-
-      if(A >= 0x1F801C00 && A <= 0x1F801FFF) // SPU
-      {
-         if(sizeof(T) == 4 && !Access24)
-         {
-            if(IsWrite)
-            {
-               //timestamp += 15;
-
-               //if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
-               // PSX_EventHandler(timestamp);
-
-               SPU->Write(timestamp, A | 0, V);
-               SPU->Write(timestamp, A | 2, V >> 16);
-            }
-            else
-            {
-               timestamp += 36;
-
-               if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
-                  PSX_EventHandler(timestamp);
-
-               V = SPU->Read(timestamp, A) | (SPU->Read(timestamp, A | 2) << 16);
-            }
-         }
-         else
-         {
-            if(IsWrite)
-            {
-               //timestamp += 8;
-
-               //if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
-               // PSX_EventHandler(timestamp);
+   if(Access24)
+   {
+      if(IsWrite)
+         MainRAM.WriteU24(A & 0x1FFFFF, V);
+      else
+         V = MainRAM.ReadU24(A & 0x1FFFFF);
+   }
+   else
+   {
+      if(IsWrite)
+         MainRAM.Write<T>(A & 0x1FFFFF, V);
+      else
+         V = MainRAM.Read<T>(A & 0x1FFFFF);
+   }
 
-               SPU->Write(timestamp, A & ~1, V);
-            }
-            else
-            {
-               timestamp += 16; // Just a guess, need to test.
+   if(IsWrite)
+      PSX_CodeWriteCheck(A);
+}
 
-               if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
-                  PSX_EventHandler(timestamp);
+template<typename T, bool IsWrite, bool Access24> static void MemRW_BIOS(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(!IsWrite)
+   {
+      if(Access24)
+         V = BIOSROM->ReadU24(A & 0x7FFFF);
+      else
+         V = BIOSROM->Read<T>(A & 0x7FFFF);
+   }
+}
 
-               V = SPU->Read(timestamp, A & ~1);
-            }
-         }
-         return;
-      }     // End SPU
+template<typename T, bool IsWrite, bool Access24> static void MemRW_SPU(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(sizeof(T) == 4 && !Access24)
+   {
+      if(IsWrite)
+      {
+         //timestamp += 15;
 
+         //if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+         // PSX_EventHandler(timestamp);
 
-      // CDC: TODO - 8-bit access.
-      if(A >= 0x1f801800 && A <= 0x1f80180F)
+         SPU->Write(timestamp, A | 0, V);
+         SPU->Write(timestamp, A | 2, V >> 16);
+      }
+      else
       {
-         if(!IsWrite)
-         {
-            timestamp += 6 * sizeof(T); //24;
-         }
+         timestamp += 36;
 
-         if(IsWrite)
-            CDC->Write(timestamp, A & 0x3, V);
-         else
-            V = CDC->Read(timestamp, A & 0x3);
+         if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+            PSX_EventHandler(timestamp);
 
-         return;
+         V = SPU->Read(timestamp, A) | (SPU->Read(timestamp, A | 2) << 16);
       }
-
-      if(A >= 0x1F801810 && A <= 0x1F801817)
+   }
+   else
+   {
+      if(IsWrite)
       {
-         if(!IsWrite)
-            timestamp++;
+         //timestamp += 8;
 
-         if(IsWrite)
-            GPU_Write(timestamp, A, V);
-         else
-            V = GPU_Read(timestamp, A);
+         //if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+         // PSX_EventHandler(timestamp);
 
-         return;
+         SPU->Write(timestamp, A & ~1, V);
       }
-
-      if(A >= 0x1F801820 && A <= 0x1F801827)
+      else
       {
-         if(!IsWrite)
-            timestamp++;
+         timestamp += 16; // Just a guess, need to test.
 
-         if(IsWrite)
-            MDEC_Write(timestamp, A, V);
-         else
-            V = MDEC_Read(timestamp, A);
+         if(timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+            PSX_EventHandler(timestamp);
 
-         return;
+         V = SPU->Read(timestamp, A & ~1);
       }
+   }
+}
 
-      if(A >= 0x1F801000 && A <= 0x1F801023)
-      {
-         unsigned index = (A & 0x1F) >> 2;
-
-         if(!IsWrite)
-            timestamp++;
+// CDC: TODO - 8-bit access.
+template<typename T, bool IsWrite, bool Access24> static void MemRW_CDC(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(!IsWrite)
+   {
+      timestamp += 6 * sizeof(T); //24;
+   }
 
-         //if(A == 0x1F801014 && IsWrite)
-         // fprintf(stderr, "%08x %08x\n",A,V);
+   if(IsWrite)
+      CDC->Write(timestamp, A & 0x3, V);
+   else
+      V = CDC->Read(timestamp, A & 0x3);
+}
 
-         if(IsWrite)
-         {
-            V <<= (A & 3) * 8;
-            SysControl.Regs[index] = V & SysControl_Mask[index];
-         }
-         else
-         {
-            V = SysControl.Regs[index] | SysControl_OR[index];
-            V >>= (A & 3) * 8;
-         }
-         return;
-      }
+template<typename T, bool IsWrite, bool Access24> static void MemRW_GPU(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(!IsWrite)
+      timestamp++;
 
-      if(A >= 0x1F801040 && A <= 0x1F80104F)
-      {
-         if(!IsWrite)
-            timestamp++;
+   if(IsWrite)
+      GPU_Write(timestamp, A, V);
+   else
+      V = GPU_Read(timestamp, A);
+}
 
-         if(IsWrite)
-            FIO->Write(timestamp, A, V);
-         else
-            V = FIO->Read(timestamp, A);
-         return;
-      }
+template<typename T, bool IsWrite, bool Access24> static void MemRW_MDEC(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(!IsWrite)
+      timestamp++;
 
-      if(A >= 0x1F801050 && A <= 0x1F80105F)
-      {
-         if(!IsWrite)
-            timestamp++;
+   if(IsWrite)
+      MDEC_Write(timestamp, A, V);
+   else
+      V = MDEC_Read(timestamp, A);
+}
 
-#if 0
-         if(IsWrite)
-         {
-            PSX_WARNING("[SIO] Write: 0x%08x 0x%08x %u", A, V, (unsigned)sizeof(T));
-         }
-         else
-         {
-            PSX_WARNING("[SIO] Read: 0x%08x", A);
-         }
-#endif
+template<typename T, bool IsWrite, bool Access24> static void MemRW_SysControl(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   unsigned index = (A & 0x1F) >> 2;
 
-         if(IsWrite)
-            SIO_Write(timestamp, A, V);
-         else
-            V = SIO_Read(timestamp, A);
-         return;
-      }
+   if(!IsWrite)
+      timestamp++;
 
-#if 0
-      if(A >= 0x1F801060 && A <= 0x1F801063)
-      {
-         if(IsWrite)
-         {
+   //if(A == 0x1F801014 && IsWrite)
+   // fprintf(stderr, "%08x %08x\n",A,V);
 
-         }
-         else
-         {
+   if(IsWrite)
+   {
+      V <<= (A & 3) * 8;
+      SysControl.Regs[index] = V & SysControl_Mask[index];
+   }
+   else
+   {
+      V = SysControl.Regs[index] | SysControl_OR[index];
+      V >>= (A & 3) * 8;
+   }
+}
 
-         }
+template<typename T, bool IsWrite, bool Access24> static void MemRW_FIO(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(!IsWrite)
+      timestamp++;
 
-         return;
-      }
-#endif
+   if(IsWrite)
+      FIO->Write(timestamp, A, V);
+   else
+      V = FIO->Read(timestamp, A);
+}
 
-      if(A >= 0x1F801070 && A <= 0x1F801077) // IRQ
-      {
-         if(!IsWrite)
-            timestamp++;
+template<typename T, bool IsWrite, bool Access24> static void MemRW_SIO(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(!IsWrite)
+      timestamp++;
 
-         if(IsWrite)
-            ::IRQ_Write(A, V);
-         else
-            V = ::IRQ_Read(A);
-         return;
-      }
+#if 0
+   if(IsWrite)
+   {
+      PSX_WARNING("[SIO] Write: 0x%08x 0x%08x %u", A, V, (unsigned)sizeof(T));
+   }
+   else
+   {
+      PSX_WARNING("[SIO] Read: 0x%08x", A);
+   }
+#endif
 
-      if(A >= 0x1F801080 && A <= 0x1F8010FF)    // DMA
-      {
-         if(!IsWrite)
-            timestamp++;
+   if(IsWrite)
+      SIO_Write(timestamp, A, V);
+   else
+      V = SIO_Read(timestamp, A);
+}
 
-         if(IsWrite)
-            DMA_Write(timestamp, A, V);
-         else
-            V = DMA_Read(timestamp, A);
+template<typename T, bool IsWrite, bool Access24> static void MemRW_IRQ(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(!IsWrite)
+      timestamp++;
 
-         return;
-      }
+   if(IsWrite)
+      ::IRQ_Write(A, V);
+   else
+      V = ::IRQ_Read(A);
+}
 
-      if(A >= 0x1F801100 && A <= 0x1F80113F) // Root counters
-      {
-         if(!IsWrite)
-            timestamp++;
+template<typename T, bool IsWrite, bool Access24> static void MemRW_DMA(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(!IsWrite)
+      timestamp++;
 
-         if(IsWrite)
-            TIMER_Write(timestamp, A, V);
-         else
-            V = TIMER_Read(timestamp, A);
+   if(IsWrite)
+      DMA_Write(timestamp, A, V);
+   else
+      V = DMA_Read(timestamp, A);
+}
 
-         return;
-      }
-   }
+template<typename T, bool IsWrite, bool Access24> static void MemRW_Timer(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(!IsWrite)
+      timestamp++;
 
+   if(IsWrite)
+      TIMER_Write(timestamp, A, V);
+   else
+      V = TIMER_Read(timestamp, A);
+}
 
-   if(A >= 0x1F000000 && A <= 0x1F7FFFFF)
+template<typename T, bool IsWrite, bool Access24> static void MemRW_PIO(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(!IsWrite)
    {
-      if(!IsWrite)
-      {
-         //if((A & 0x7FFFFF) <= 0x84)
-         //PSX_WARNING("[PIO] Read%d from 0x%08x at time %d", (int)(sizeof(T) * 8), A, timestamp);
+      //if((A & 0x7FFFFF) <= 0x84)
+      //PSX_WARNING("[PIO] Read%d from 0x%08x at time %d", (int)(sizeof(T) * 8), A, timestamp);
 
-         V = ~0U; // A game this affects:  Tetris with Cardcaptor Sakura
+      V = ~0U; // A game this affects:  Tetris with Cardcaptor Sakura
 
-         if(PIOMem)
+      if(PIOMem)
+      {
+         if((A & 0x7FFFFF) < 65536)
          {
-            if((A & 0x7FFFFF) < 65536)
-            {
-               if(Access24)
-                  V = PIOMem->ReadU24(A & 0x7FFFFF);
-               else
-                  V = PIOMem->Read<T>(A & 0x7FFFFF);
-            }
-            else if((A & 0x7FFFFF) < (65536 + TextMem.size()))
+            if(Access24)
+               V = PIOMem->ReadU24(A & 0x7FFFFF);
+            else
+               V = PIOMem->Read<T>(A & 0x7FFFFF);
+         }
+         else if((A & 0x7FFFFF) < (65536 + TextMem.size()))
+         {
+            if(Access24)
+               V = MDFN_de24lsb(&TextMem[(A & 0x7FFFFF) - 65536]);
+            else switch(sizeof(T))
             {
-               if(Access24)
-                  V = MDFN_de24lsb(&TextMem[(A & 0x7FFFFF) - 65536]);
-               else switch(sizeof(T))
-               {
-                  case 1: V = TextMem[(A & 0x7FFFFF) - 65536]; break;
-                  case 2: V = MDFN_de16lsb(&TextMem[(A & 0x7FFFFF) - 65536]); break;
-                  case 4: V = MDFN_de32lsb(&TextMem[(A & 0x7FFFFF) - 65536]); break;
-               }
+               case 1: V = TextMem[(A & 0x7FFFFF) - 65536]; break;
+               case 2: V = MDFN_de16lsb(&TextMem[(A & 0x7FFFFF) - 65536]); break;
+               case 4: V = MDFN_de32lsb(&TextMem[(A & 0x7FFFFF) - 65536]); break;
             }
          }
       }
-      return;
    }
+}
 
-   if(A == 0xFFFE0130) // Per tests on PS1, ignores the access(sort of, on reads the value is forced to 0 if not aligned) if not aligned to 4-bytes.
-   {
-      if(!IsWrite)
-         V = CPU->GetBIU();
-      else
-         CPU->SetBIU(V);
-
-      return;
-   }
+// Per tests on PS1, ignores the access(sort of, on reads the value is forced to 0 if not aligned) if not aligned to 4-bytes.
+template<typename T, bool IsWrite, bool Access24> static void MemRW_BIU(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   if(!IsWrite)
+      V = CPU->GetBIU();
+   else
+      CPU->SetBIU(V);
+}
 
+template<typename T, bool IsWrite, bool Access24> static void MemRW_Unmapped(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
    if(IsWrite)
    {
       PSX_WARNING("[MEM] Unknown write%d to %08x at time %d, =%08x(%d)", (int)(sizeof(T) * 8), A, timestamp, V, V);
@@ -783,6 +853,101 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(int32
    }
 }
 
+template<typename T, bool IsWrite, bool Access24> static void MemRW_SetHandlers(void)
+{
+   MemRWHandler *h = MemRW_Handlers[MemRW_Kind<T, IsWrite, Access24>()];
+
+   h[MEMRW_REGION_UNMAPPED]   = MemRW_Unmapped<T, IsWrite, Access24>;
+   h[MEMRW_REGION_RAM]        = MemRW_RAM<T, IsWrite, Access24>;
+   h[MEMRW_REGION_BIOS]       = MemRW_BIOS<T, IsWrite, Access24>;
+   h[MEMRW_REGION_IO]         = MemRW_Unmapped<T, IsWrite, Access24>;
+   h[MEMRW_REGION_SPU]        = MemRW_SPU<T, IsWrite, Access24>;
+   h[MEMRW_REGION_CDC]        = MemRW_CDC<T, IsWrite, Access24>;
+   h[MEMRW_REGION_GPU]        = MemRW_GPU<T, IsWrite, Access24>;
+   h[MEMRW_REGION_MDEC]       = MemRW_MDEC<T, IsWrite, Access24>;
+   h[MEMRW_REGION_SYSCONTROL] = MemRW_SysControl<T, IsWrite, Access24>;
+   h[MEMRW_REGION_FIO]        = MemRW_FIO<T, IsWrite, Access24>;
+   h[MEMRW_REGION_SIO]        = MemRW_SIO<T, IsWrite, Access24>;
+   h[MEMRW_REGION_IRQ]        = MemRW_IRQ<T, IsWrite, Access24>;
+   h[MEMRW_REGION_DMA]        = MemRW_DMA<T, IsWrite, Access24>;
+   h[MEMRW_REGION_TIMER]      = MemRW_Timer<T, IsWrite, Access24>;
+   h[MEMRW_REGION_PIO]        = MemRW_PIO<T, IsWrite, Access24>;
+   h[MEMRW_REGION_BIU]        = MemRW_BIU<T, IsWrite, Access24>;
+}
+
+static void MemRW_MapRange(uint8 *map, unsigned shift, uint32_t start, uint32_t end, unsigned region)
+{
+   for(uint32_t i = start >> shift; i <= (end >> shift); i++)
+      map[i] = region;
+}
+
+static void MemRW_Init(void)
+{
+   memset(MemRW_PageMap, MEMRW_REGION_UNMAPPED, sizeof(MemRW_PageMap));
+   memset(MemRW_IOMap, MEMRW_REGION_UNMAPPED, sizeof(MemRW_IOMap));
+
+   MemRW_MapRange(MemRW_PageMap, 12, 0x00000000, 0x007FFFFF, MEMRW_REGION_RAM);
+   MemRW_MapRange(MemRW_PageMap, 12, 0x1F000000, 0x1F7FFFFF, MEMRW_REGION_PIO);
+   MemRW_MapRange(MemRW_PageMap, 12, 0x1F801000, 0x1F801FFF, MEMRW_REGION_IO);
+   MemRW_MapRange(MemRW_PageMap, 12, 0x1FC00000, 0x1FC7FFFF, MEMRW_REGION_BIOS);
+
+   MemRW_MapRange(MemRW_IOMap, 2, 0x000, 0x023, MEMRW_REGION_SYSCONTROL);
+   MemRW_MapRange(MemRW_IOMap, 2, 0x040, 0x04F, MEMRW_REGION_FIO);
+   MemRW_MapRange(MemRW_IOMap, 2, 0x050, 0x05F, MEMRW_REGION_SIO);
+   MemRW_MapRange(MemRW_IOMap, 2, 0x070, 0x077, MEMRW_REGION_IRQ);
+   MemRW_MapRange(MemRW_IOMap, 2, 0x080, 0x0FF, MEMRW_REGION_DMA);
+   MemRW_MapRange(MemRW_IOMap, 2, 0x100, 0x13F, MEMRW_REGION_TIMER);
+   MemRW_MapRange(MemRW_IOMap, 2, 0x800, 0x80F, MEMRW_REGION_CDC);
+   MemRW_MapRange(MemRW_IOMap, 2, 0x810, 0x817, MEMRW_REGION_GPU);
+   MemRW_MapRange(MemRW_IOMap, 2, 0x820, 0x827, MEMRW_REGION_MDEC);
+   MemRW_MapRange(MemRW_IOMap, 2, 0xC00, 0xFFF, MEMRW_REGION_SPU);
+
+   MemRW_SetHandlers<uint8, false, false>();
+   MemRW_SetHandlers<uint16, false, false>();
+   MemRW_SetHandlers<uint32, false, true>();
+   MemRW_SetHandlers<uint32, false, false>();
+   MemRW_SetHandlers<uint8, true, false>();
+   MemRW_SetHandlers<uint16, true, false>();
+   MemRW_SetHandlers<uint32, true, true>();
+   MemRW_SetHandlers<uint32, true, false>();
+}
+
+template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(int32_t &timestamp, uint32_t A, uint32_t &V)
+{
+   unsigned region;
+
+#if 0
+   if(IsWrite)
+      printf("Write%d: %08x(orig=%08x), %08x\n", (int)(sizeof(T) * 8), A & mask[A >> 29], A, V);
+   else
+      printf("Read%d: %08x(orig=%08x)\n", (int)(sizeof(T) * 8), A & mask[A >> 29], A);
+#endif
+
+   if(!IsWrite)
+      timestamp += DMACycleSteal;
+
+   //if(A == 0xa0 && IsWrite)
+   // DBG_Break();
+
+   if(A < 0x00800000)
+   {
+      MemRW_RAM<T, IsWrite, Access24>(timestamp, A, V);
+      return;
+   }
+
+   region = MemRW_Region(A);
+
+   if(region != MEMRW_REGION_BIOS && timestamp >= events[PSX_EVENT__SYNFIRST].next->event_time)
+      PSX_EventHandler(timestamp);
+
+   //if(IsWrite)
+   // printf("HW Write%d: %08x %08x\n", (unsigned int)(sizeof(T)*8), (unsigned int)A, (unsigned int)V);
+   //else
+   // printf("HW Read%d: %08x\n", (unsigned int)(sizeof(T)*8), (unsigned int)A);
+
+   MemRW_Handlers[MemRW_Kind<T, IsWrite, Access24>()][region](timestamp, A, V);
+}
+
 void MDFN_FASTCALL PSX_MemWrite8(int32_t timestamp, uint32_t A, uint32_t V)
 {
    MemRW<uint8, true, false>(timestamp, A, V);
@@ -1016,6 +1181,7 @@ template<typename T, bool Access24> static INLINE void MemPoke(pscpu_timestamp_t
       else
          MainRAM.Write<T>(A & 0x1FFFFF, V);
 
+      PSX_CodeWriteCheck(A);
       return;
    }
 
@@ -1061,11 +1227,16 @@ void PSX_MemPoke32(uint32 A, uint32 V)
    MemPoke<uint32, false>(0, A, V);
 }
 
-void PSX_GPULineHook(const int32_t timestamp, const int32_t line_timestamp, bool vsync, uint32_t *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock_offset, const unsigned pix_clock, const unsigned pix_clock_divider)
+void PSX_GPULineHook(const int32_t timestamp, const int32_t line_timestamp, bool vsync, surface_pixel *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock_offset, const unsigned pix_clock, const unsigned pix_clock_divider)
 {
    FIO->GPULineHook(timestamp, line_timestamp, vsync, pixels, format, width, pix_clock_offset, pix_clock, pix_clock_divider);
 }
 
+bool PSX_GPULineHookNeedsPixels(void)
+{
+   return FIO->RequireNoFrameskip();
+}
+
 static bool TestMagic(const char *name, MDFNFILE *fp)
 {
    if(GET_FSIZE_PTR(fp) < 0x800)
@@ -1391,9 +1562,16 @@ static void InitCommon(std::vector<CDIF *> *CDInterfaces, const bool EmulateMemc
    }
 
    CPU = new PS_CPU();
+#ifdef HAVE_CPU_PROFILER
+   PROF_Init();
+   log_cb(RETRO_LOG_INFO, "CPU profiler built in: running the debug interpreter, CPU core, idle skip and BIOS HLE options are ignored.\n");
+#endif
    SPU = new PS_SPU();
 
    GPU_Init(region == REGION_EU, sls, sle, psx_gpu_upscale_shift);
+#ifdef HAVE_GPU_PROFILER
+   GPU_PROF_Reset();
+#endif
 
    CDC = new PS_CDC();
    FIO = new FrontIO(emulate_memcard, emulate_multitap);
@@ -1407,6 +1585,8 @@ static void InitCommon(std::vector<CDIF *> *CDInterfaces, const bool EmulateMemc
 
    DMA_Init();
 
+   MemRW_Init();
+
    GPU_FillVideoParams(&EmulatedPSX);
 
    switch (psx_gpu_dither_mode)
@@ -1421,7 +1601,10 @@ static void InitCommon(std::vector<CDIF *> *CDInterfaces, const bool EmulateMemc
          break;
    }
 
+   GPU_set_raster_threads(psx_gpu_raster_threads);
+
    PGXP_SetModes(psx_pgxp_mode | psx_pgxp_vertex_caching | psx_pgxp_texture_correction);
+   CPU->UpdateRunFunc();
 
    CD_TrayOpen        = true;
    CD_SelectedDisc    = -1;
@@ -1746,6 +1929,10 @@ static void Cleanup(void)
       delete CPU;
    CPU = NULL;
 
+#ifdef HAVE_CPU_PROFILER
+   PROF_Kill();
+#endif
+
    if(FIO)
       delete FIO;
    FIO = NULL;
@@ -1792,6 +1979,22 @@ static void CloseGame(void)
             log_cb(RETRO_LOG_ERROR, "%s\n", e.what());
          }
       }
+
+#ifdef HAVE_CPU_PROFILER
+      {
+         const std::string report = MDFN_MakeFName(MDFNMKF_SAV, 0, "prof.txt");
+         const std::string folded = MDFN_MakeFName(MDFNMKF_SAV, 0, "prof.folded");
+
+         PROF_Dump(report.c_str(), folded.c_str());
+      }
+#endif
+#ifdef HAVE_GPU_PROFILER
+      {
+         const std::string report = MDFN_MakeFName(MDFNMKF_SAV, 0, "gpuprof.txt");
+
+         GPU_PROF_Dump(report.c_str());
+      }
+#endif
    }
 
    Cleanup();
@@ -2264,7 +2467,7 @@ static MDFN_Surface *surf = NULL;
 
 static void alloc_surface(void)
 {
-   MDFN_PixelFormat pix_fmt(MDFN_COLORSPACE_RGB, 16, 8, 0, 24);
+   MDFN_PixelFormat pix_fmt(MDFN_COLORSPACE_RGB, RED_SHIFT, GREEN_SHIFT, BLUE_SHIFT, ALPHA_SHIFT);
    uint32_t width  = MEDNAFEN_CORE_GEOMETRY_MAX_W;
    uint32_t height = is_pal ? MEDNAFEN_CORE_GEOMETRY_MAX_H  : 480;
 
@@ -2566,6 +2769,55 @@ static void check_variables(bool startup)
    else
       psx_cpu_overclock = false;
 
+   var.key = option_gte_lazy_flags;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (strcmp(var.value, "enabled") == 0)
+         psx_gte_lazy_flags = true;
+      else if (strcmp(var.value, "disabled") == 0)
+         psx_gte_lazy_flags = false;
+   }
+   else
+      psx_gte_lazy_flags = true;
+
+   var.key = option_cpu_idle_skip;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (strcmp(var.value, "enabled") == 0)
+         psx_cpu_idle_skip = true;
+      else if (strcmp(var.value, "disabled") == 0)
+         psx_cpu_idle_skip = false;
+   }
+   else
+      psx_cpu_idle_skip = true;
+
+   var.key = option_cpu_bios_hle;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (strcmp(var.value, "enabled") == 0)
+         psx_cpu_bios_hle = true;
+      else if (strcmp(var.value, "disabled") == 0)
+         psx_cpu_bios_hle = false;
+   }
+   else
+      psx_cpu_bios_hle = false;
+
+   var.key = option_cpu_core;
+   psx_cpu_core = CPU_CORE_INTERPRETER;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (strcmp(var.value, "cached interpreter") == 0)
+         psx_cpu_core = CPU_CORE_CACHED_INTERPRETER;
+#ifdef HAVE_JIT
+      else if (strcmp(var.value, "dynarec") == 0)
+         psx_cpu_core = CPU_CORE_DYNAREC;
+#endif
+   }
+
    var.key = option_skip_bios;
 
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
@@ -2664,6 +2916,18 @@ static void check_variables(bool startup)
    else
       psx_gpu_dither_mode = DITHER_NATIVE;
 
+   var.key = option_renderer_threads;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (strcmp(var.value, "disabled") == 0)
+         psx_gpu_raster_threads = 0;
+      else
+         psx_gpu_raster_threads = atoi(var.value);
+   }
+   else
+      psx_gpu_raster_threads = 0;
+
    // iCB: PGXP settings
    var.key = option_pgxp_mode;
 
@@ -2834,6 +3098,20 @@ static void check_variables(bool startup)
    else
       allow_frame_duping = false;
 
+   var.key = option_frame_skip;
+
+   frame_skip = 0;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      bool can_dupe = false;
+
+      // Skipped frames are handed to the frontend as dupes
+      if (strcmp(var.value, "disabled") != 0 &&
+            environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE, &can_dupe) && can_dupe)
+         frame_skip = atoi(var.value);
+   }
+
    var.key = option_display_internal_fps;
 
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
@@ -2846,6 +3124,15 @@ static void check_variables(bool startup)
    else
      display_internal_framerate = false;
 
+#ifdef HAVE_GPU_PROFILER
+   var.key = option_gpu_profile;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      display_gpu_profile = !strcmp(var.value, "enabled");
+   else
+      display_gpu_profile = false;
+#endif
+
    var.key = option_crop_overscan;
 
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
@@ -3306,7 +3593,11 @@ bool retro_load_game(const struct retro_game_info *info)
 
    environ_cb(RETRO_ENVIRONMENT_SET_INPUT_DESCRIPTORS, desc);
 
+#if SURFACE_BPP == 16
+   enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_RGB565;
+#else
    enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_XRGB8888;
+#endif
    if (!environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
       return false;
 
@@ -3577,6 +3868,24 @@ static void update_input(void)
 static uint64_t video_frames, audio_frames;
 #define SOUND_CHANNELS 2
 
+// Whether the frame about to be emulated won't be shown
+static bool skip_frame(void)
+{
+   int av_enable = 3;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &av_enable) && !(av_enable & 1))
+      return true;
+
+   if (frame_skip_count < frame_skip)
+   {
+      frame_skip_count++;
+      return true;
+   }
+
+   frame_skip_count = 0;
+   return false;
+}
+
 void retro_run(void)
 {
    bool updated = false;
@@ -3620,7 +3929,10 @@ void retro_run(void)
             break;
       }
 
+      GPU_set_raster_threads(psx_gpu_raster_threads);
+
       PGXP_SetModes(psx_pgxp_mode | psx_pgxp_vertex_caching | psx_pgxp_texture_correction);
+      CPU->UpdateRunFunc();
    }
 
    if (display_internal_framerate)
@@ -3648,6 +3960,24 @@ void retro_run(void)
       internal_frame_count = 0;
    }
 
+#ifdef HAVE_GPU_PROFILER
+   if (display_gpu_profile)
+   {
+      gpu_profile_frame_count++;
+
+      if (gpu_profile_frame_count % INTERNAL_FPS_SAMPLE_PERIOD == 0)
+      {
+         char msg_buffer[128];
+
+         GPU_PROF_Summary(msg_buffer, sizeof(msg_buffer), INTERNAL_FPS_SAMPLE_PERIOD);
+
+         MDFN_DispMessage(msg_buffer);
+      }
+   }
+   else
+      gpu_profile_frame_count = 0;
+#endif
+
    if (setting_apply_analog_toggle)
    {
       FIO->SetAMCT(setting_psx_analog_toggle);
@@ -3677,7 +4007,11 @@ void retro_run(void)
    /* start of Emulate */
    int32_t timestamp = 0;
 
-   espec->skip = false;
+   // The software renderer only draws skipped frames as far as the game
+   // reads VRAM back(see GPU_StartFrame()).  The light guns look at every
+   // frame.
+   espec->skip = skip_frame() && rsx_intf_is_type() == RSX_SOFTWARE &&
+      !FIO->RequireNoFrameskip();
    MDFNGameInfo->mouse_sensitivity = MDFN_GetSettingF("psx.input.mouse_sensitivity");
 
    MDFNMP_ApplyPeriodicCheats();
@@ -3760,7 +4094,15 @@ void retro_run(void)
    unsigned height       = spec.DisplayRect.h;
    uint8_t upscale_shift = GPU_get_upscale_shift();
 
-   if (rsx_intf_is_type() == RSX_SOFTWARE)
+#ifdef NEED_DEINTERLACER
+   // The deinterlacer never saw the fields of skipped frames, so the next
+   // shown one mustn't be woven with the last field it did see.
+   if (spec.skip)
+      PrevInterlaced = false;
+#endif
+
+   // Skipped frames go out as dupes
+   if (rsx_intf_is_type() == RSX_SOFTWARE && !spec.skip)
    {
 #ifdef NEED_DEINTERLACER
       if (spec.InterlaceOn)
@@ -3785,7 +4127,7 @@ void retro_run(void)
       //fprintf(stderr, "(%u x %u)\n", width, height);
       // PSX core inserts padding on left and right (overscan). Optionally crop this.
 
-      const uint32_t *pix = surf->pixels;
+      const surface_pixel *pix = surf->pixels;
       unsigned pix_offset = 0;
 
       if (crop_overscan)
@@ -3854,7 +4196,7 @@ void retro_run(void)
    int16_t *interbuf = (int16_t*)&IntermediateBuffer;
 
    rsx_intf_finalize_frame(fb, width, height,
-         MEDNAFEN_CORE_GEOMETRY_MAX_W << (2 + upscale_shift));
+         (MEDNAFEN_CORE_GEOMETRY_MAX_W * sizeof(surface_pixel)) << upscale_shift);
 
    video_frames++;
    audio_frames += spec.SoundBufSize;
@@ -3978,6 +4320,7 @@ void retro_set_environment(retro_environment_t cb)
       { option_adaptive_smoothing, "Adaptive smoothing; enabled|disabled" },
 #endif
       { option_internal_resolution, "Internal GPU resolution; 1x(native)|2x|4x|8x|16x|32x" },
+      { option_renderer_threads, "Software renderer threads; disabled|1|2|3|4|6|8" },
 #if defined(HAVE_OPENGL) || defined(HAVE_OPENGLES)
       // Only used in GL renderer for now.
       { option_filter, "Texture filtering; nearest|SABR|xBR|bilinear|3-point|JINC2" },
@@ -3992,10 +4335,22 @@ void retro_set_environment(retro_environment_t cb)
 #endif
       { option_widescreen_hack, "Widescreen mode hack; disabled|enabled" },      
       { option_frame_duping, "Frame duping (speedup); disabled|enabled" },
+      { option_frame_skip, "Frame skipping (speedup); disabled|1|2|3|4" },
       { option_cpu_overclock, "CPU Overclock; disabled|enabled" },
+      { option_gte_lazy_flags, "GTE lazy FLAG computation; enabled|disabled" },
+      { option_cpu_idle_skip, "CPU idle loop skipping; enabled|disabled" },
+      { option_cpu_bios_hle, "High-level BIOS calls; disabled|enabled" },
+#ifdef HAVE_JIT
+      { option_cpu_core, "CPU core (dynarec load timing approximate); interpreter|cached interpreter|dynarec" },
+#else
+      { option_cpu_core, "CPU core; interpreter|cached interpreter" },
+#endif
       { option_skip_bios, "Skip BIOS; disabled|enabled" },
       { option_dither_mode, "Dithering pattern; 1x(native)|internal resolution|disabled" },
       { option_display_internal_fps, "Display internal FPS; disabled|enabled" },
+#ifdef HAVE_GPU_PROFILER
+      { option_gpu_profile, "Display GPU command profile; disabled|enabled" },
+#endif
       
       { option_initial_scanline, "Initial scanline; 0|1|2|3|4|5|6|7|8|9|10|10|11|12|13|14|15|16|17|18|19|20|21|22|23|24|25|26|27|28|29|30|31|32|33|34|35|36|37|38|39|40" },
       { option_last_scanline, "Last scanline; 239|238|237|236|235|234|232|231|230|229|228|227|226|225|224|223|222|221|220|219|218|217|216|215|214|213|212|211|210" },
@@ -18,6 +18,7 @@
 #define option_adaptive_smoothing    "beetle_psx_hw_adaptive_smoothing"
 #define option_widescreen_hack       "beetle_psx_hw_widescreen_hack"
 #define option_internal_resolution   "beetle_psx_hw_internal_resolution"
+#define option_renderer_threads      "beetle_psx_hw_renderer_threads"
 #define option_filter                "beetle_psx_hw_filter"
 #define option_depth                 "beetle_psx_hw_internal_color_depth"
 #define option_dither_mode           "beetle_psx_hw_dither_mode"
@@ -32,15 +33,21 @@
 #define option_initial_scanline_pal  "beetle_psx_hw_initial_scanline_pal"
 #define option_last_scanline_pal     "beetle_psx_hw_last_scanline_pal"
 #define option_frame_duping          "beetle_psx_hw_frame_duping_enable"
+#define option_frame_skip            "beetle_psx_hw_frame_skip"
 #define option_crop_overscan         "beetle_psx_hw_crop_overscan"
 #define option_image_crop            "beetle_psx_hw_image_crop"
 #define option_image_offset          "beetle_psx_hw_image_offset"
 #define option_display_internal_fps  "beetle_psx_hw_display_internal_framerate"
+#define option_gpu_profile           "beetle_psx_hw_display_gpu_profile"
 #define option_analog_calibration    "beetle_psx_hw_analog_calibration"
 #define option_analog_toggle         "beetle_psx_hw_analog_toggle"
 #define option_multitap1             "beetle_psx_hw_enable_multitap_port1"
 #define option_multitap2             "beetle_psx_hw_enable_multitap_port2"
 #define option_cpu_overclock         "beetle_psx_hw_cpu_overclock"
+#define option_gte_lazy_flags        "beetle_psx_hw_gte_lazy_flags"
+#define option_cpu_core              "beetle_psx_hw_cpu_core"
+#define option_cpu_idle_skip         "beetle_psx_hw_cpu_idle_skip"
+#define option_cpu_bios_hle          "beetle_psx_hw_cpu_bios_hle"
 #define option_cd_image_cache        "beetle_psx_hw_cdimagecache"
 #define option_skip_bios             "beetle_psx_hw_skipbios"
 #define option_memcard0_method       "beetle_psx_hw_use_mednafen_memcard0_method"
@@ -52,6 +59,7 @@
 #define option_adaptive_smoothing    "beetle_psx_adaptive_smoothing"
 #define option_widescreen_hack       "beetle_psx_widescreen_hack"
 #define option_internal_resolution   "beetle_psx_internal_resolution"
+#define option_renderer_threads      "beetle_psx_renderer_threads"
 #define option_filter                "beetle_psx_filter"
 #define option_depth                 "beetle_psx_internal_color_depth"
 #define option_dither_mode           "beetle_psx_dither_mode"
@@ -66,15 +74,21 @@
 #define option_initial_scanline_pal  "beetle_psx_initial_scanline_pal"
 #define option_last_scanline_pal     "beetle_psx_last_scanline_pal"
 #define option_frame_duping          "beetle_psx_frame_duping_enable"
+#define option_frame_skip            "beetle_psx_frame_skip"
 #define option_crop_overscan         "beetle_psx_crop_overscan"
 #define option_image_crop            "beetle_psx_image_crop"
 #define option_image_offset          "beetle_psx_image_offset"
 #define option_display_internal_fps  "beetle_psx_display_internal_framerate"
+#define option_gpu_profile           "beetle_psx_display_gpu_profile"
 #define option_analog_calibration    "beetle_psx_analog_calibration"
 #define option_analog_toggle         "beetle_psx_analog_toggle"
 #define option_multitap1             "beetle_psx_enable_multitap_port1"
 #define option_multitap2             "beetle_psx_enable_multitap_port2"
 #define option_cpu_overclock         "beetle_psx_cpu_overclock"
+#define option_gte_lazy_flags        "beetle_psx_gte_lazy_flags"
+#define option_cpu_core              "beetle_psx_cpu_core"
+#define option_cpu_idle_skip         "beetle_psx_cpu_idle_skip"
+#define option_cpu_bios_hle          "beetle_psx_cpu_bios_hle"
 #define option_cd_image_cache        "beetle_psx_cdimagecache"
 #define option_skip_bios             "beetle_psx_skipbios"
 #define option_memcard0_method       "beetle_psx_use_mednafen_memcard0_method"
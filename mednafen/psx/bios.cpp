@@ -0,0 +1,620 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "psx.h"
+#include "bios.h"
+
+#include <stdio.h>
+
+#define BIOS_A0_TABLE      0x0200
+#define BIOS_B0_TABLE      0x0874
+#define BIOS_EVCB_TABLE    0x0120   // Pointer to the event control blocks, followed by their total size.
+#define BIOS_EVCB_SIZE     0x1C
+#define BIOS_KERNEL_END    0x10000
+
+// What the kernel puts at the A0h/B0h vectors: lui t0, 0; addiu t0, t0, dispatcher; jr t0; nop
+static const uint32_t BIOS_A0_Stub[4] = { 0x3C080000, 0x250805C4, 0x01000008, 0x00000000 };
+static const uint32_t BIOS_B0_Stub[4] = { 0x3C080000, 0x250805E0, 0x01000008, 0x00000000 };
+
+#define BIOS_EVENT_DISABLED   0x1000
+#define BIOS_EVENT_ENABLED    0x2000
+#define BIOS_EVENT_READY      0x4000
+
+// Cost model; the kernel's versions run out of ROM or uncached RAM, byte at a time.
+#define BIOS_CALL_CYCLES   40    // Vector, table dispatch, prologue and return.
+#define BIOS_BYTE_CYCLES   8     // One iteration of a copy/compare/scan loop.
+
+#define BIOS_PRINTF_MAX    512
+
+static uint8_t *BIOS_Scratch;
+static int32_t BIOS_MaxCycles;
+
+static INLINE uint32_t BIOS_Load32(const uint8_t *p)
+{
+   return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static INLINE void BIOS_Store32(uint8_t *p, uint32_t v)
+{
+   p[0] = v;
+   p[1] = v >> 8;
+   p[2] = v >> 16;
+   p[3] = v >> 24;
+}
+
+// Whether a call going through bytes bytes would be over before the next event.  Longer ones
+// are left to the kernel's code, so that timers, DMA and IRQs come in the middle of them at
+// about the same point as they would anyway, instead of all at once after.
+static bool BIOS_Fits(uint32_t bytes)
+{
+   return BIOS_CALL_CYCLES + (int64)bytes * BIOS_BYTE_CYCLES <= BIOS_MaxCycles;
+}
+
+// Host pointer for guest address A if it's in RAM or the scratchpad, with *avail set to the
+// number of bytes until the end of that(mirror of the) memory.
+static uint8_t *BIOS_Span(uint32_t A, uint32_t *avail)
+{
+   const uint32_t seg = A >> 29;
+
+   if(seg != 0 && seg != 4 && seg != 5)
+      return NULL;
+
+   A &= 0x1FFFFFFF;
+
+   if(A < 0x800000)
+   {
+      *avail = 0x200000 - (A & 0x1FFFFF);
+      return &MainRAM.data8[A & 0x1FFFFF];
+   }
+
+   if(BIOS_Scratch && A >= 0x1F800000 && A <= 0x1F8003FF)
+   {
+      *avail = 0x400 - (A & 0x3FF);
+      return &BIOS_Scratch[A & 0x3FF];
+   }
+
+   return NULL;
+}
+
+static uint8_t *BIOS_Ptr(uint32_t A, uint32_t len)
+{
+   uint32_t avail;
+   uint8_t *p = BIOS_Span(A, &avail);
+
+   if(!p || avail < len)
+      return NULL;
+
+   return p;
+}
+
+// NUL-terminated string at A, or the first max bytes of it; NULL if it runs off the end of memory.
+static const uint8_t *BIOS_Str(uint32_t A, uint32_t max, uint32_t *len)
+{
+   uint32_t avail;
+   uint32_t i;
+   const uint8_t *p = BIOS_Span(A, &avail);
+
+   if(!p)
+      return NULL;
+
+   for(i = 0; i < avail && i < max; i++)
+   {
+      if(!p[i])
+      {
+         *len = i;
+         return p;
+      }
+   }
+
+   if(i == max)
+   {
+      *len = max;
+      return p;
+   }
+
+   return NULL;
+}
+
+// Writes that bypass PSX_MemPoke*() still have to reach the code caches.
+static void BIOS_Written(uint32_t A, uint32_t len)
+{
+   uint32_t page;
+
+   A &= 0x1FFFFFFF;
+
+   if(A >= 0x800000 || !len)
+      return;
+
+   for(page = A & ~0xFFFU; page < A + len; page += 0x1000)
+      PSX_CodeWriteCheck(page);
+}
+
+// printf() argument n, after the format string.
+static bool BIOS_Arg(const uint32_t *gpr, unsigned n, uint32_t *v)
+{
+   const uint8_t *p;
+
+   if(n < 3)
+   {
+      *v = gpr[5 + n];
+      return true;
+   }
+
+   if(!(p = BIOS_Ptr(gpr[29] + ((n + 1) << 2), 4)))
+      return false;
+
+   *v = BIOS_Load32(p);
+   return true;
+}
+
+static bool BIOS_Printf(const uint32_t *gpr, char *out, uint32_t *out_len)
+{
+   uint32_t fmt_len;
+   uint32_t i;
+   uint32_t pos = 0;
+   unsigned arg = 0;
+   const uint8_t *fmt = BIOS_Str(gpr[4], ~0U, &fmt_len);
+
+   if(!fmt)
+      return false;
+
+   for(i = 0; i < fmt_len; i++)
+   {
+      char spec[16];
+      unsigned spec_len = 0;
+      unsigned digits;
+      uint32_t v;
+      int r;
+
+      if(fmt[i] != '%')
+      {
+         if(pos + 1 >= BIOS_PRINTF_MAX)
+            return false;
+
+         out[pos++] = fmt[i];
+         continue;
+      }
+
+      spec[spec_len++] = '%';
+      i++;
+
+      while(i < fmt_len && strchr("-0 +#", fmt[i]) && spec_len < 6)
+         spec[spec_len++] = fmt[i++];
+
+      for(digits = 0; i < fmt_len && fmt[i] >= '0' && fmt[i] <= '9'; digits++)
+      {
+         if(digits == 2)
+            return false;
+
+         spec[spec_len++] = fmt[i++];
+      }
+
+      if(i < fmt_len && fmt[i] == '.')
+      {
+         spec[spec_len++] = fmt[i++];
+
+         for(digits = 0; i < fmt_len && fmt[i] >= '0' && fmt[i] <= '9'; digits++)
+         {
+            if(digits == 2)
+               return false;
+
+            spec[spec_len++] = fmt[i++];
+         }
+      }
+
+      while(i < fmt_len && (fmt[i] == 'l' || fmt[i] == 'h'))
+         i++;
+
+      if(i >= fmt_len)
+         return false;
+
+      if(fmt[i] == '%')
+      {
+         if(pos + 1 >= BIOS_PRINTF_MAX)
+            return false;
+
+         out[pos++] = '%';
+         continue;
+      }
+
+      if(!BIOS_Arg(gpr, arg++, &v))
+         return false;
+
+      spec[spec_len + 1] = 0;
+
+      switch(fmt[i])
+      {
+         case 'd':
+         case 'i':
+            spec[spec_len] = 'd';
+            r = snprintf(out + pos, BIOS_PRINTF_MAX - pos, spec, (int)(int32)v);
+            break;
+
+         case 'u':
+         case 'x':
+         case 'X':
+         case 'o':
+            spec[spec_len] = fmt[i];
+            r = snprintf(out + pos, BIOS_PRINTF_MAX - pos, spec, (unsigned)v);
+            break;
+
+         case 'p':
+            spec[spec_len] = 'x';
+            r = snprintf(out + pos, BIOS_PRINTF_MAX - pos, spec, (unsigned)v);
+            break;
+
+         case 'c':
+            spec[spec_len] = 'c';
+            r = snprintf(out + pos, BIOS_PRINTF_MAX - pos, spec, (int)(uint8)v);
+            break;
+
+         case 's':
+            {
+               uint32_t len;
+               const uint8_t *s = BIOS_Str(v, ~0U, &len);
+
+               if(!s)
+                  return false;
+
+               spec[spec_len] = 's';
+               r = snprintf(out + pos, BIOS_PRINTF_MAX - pos, spec, (const char *)s);
+            }
+            break;
+
+         default:
+            return false;
+      }
+
+      if(r < 0 || pos + r >= BIOS_PRINTF_MAX)
+         return false;
+
+      pos += r;
+   }
+
+   out[pos] = 0;
+   *out_len = pos;
+   return true;
+}
+
+// Event control block for event id, and its guest address.
+static uint8_t *BIOS_EvCB(uint32_t id, uint32_t *A)
+{
+   const uint8_t *table = BIOS_Ptr(BIOS_EVCB_TABLE, 8);
+   const uint32_t index = id & 0xFFFF;
+
+   if((index + 1) * BIOS_EVCB_SIZE > BIOS_Load32(table + 4))
+      return NULL;
+
+   *A = BIOS_Load32(table) + index * BIOS_EVCB_SIZE;
+   return BIOS_Ptr(*A, BIOS_EVCB_SIZE);
+}
+
+static bool BIOS_A0(uint32_t fn, uint32_t *gpr, int32_t *cycles)
+{
+   const uint32_t a0 = gpr[4];
+   const uint32_t a1 = gpr[5];
+   const uint32_t a2 = gpr[6];
+   uint32_t ret = 0;
+   uint32_t bytes = 0;
+
+   switch(fn)
+   {
+      case 0x17: // strcmp(a, b)
+      case 0x18: // strncmp(a, b, n)
+         {
+            const uint32_t max = (fn == 0x18) ? ((int32)a2 > 0 ? a2 : 0) : ~0U;
+            uint32_t len_a, len_b;
+            const uint8_t *pa, *pb;
+            uint32_t i;
+
+            if(!a0 || !a1)
+            {
+               ret = (a0 ? 1 : 0) - (a1 ? 1 : 0);
+               break;
+            }
+
+            if(!(pa = BIOS_Str(a0, max, &len_a)) || !(pb = BIOS_Str(a1, max, &len_b)))
+               return false;
+
+            for(i = 0; i < max; i++)
+            {
+               if(pa[i] != pb[i])
+               {
+                  ret = pa[i] - pb[i];
+                  break;
+               }
+
+               if(!pa[i])
+                  break;
+            }
+            bytes = i;
+         }
+         break;
+
+      case 0x19: // strcpy(dst, src)
+         {
+            uint32_t len;
+            const uint8_t *s;
+            uint8_t *d;
+            uint32_t i;
+
+            if(!a0 || !a1)
+               break;
+
+            if(!(s = BIOS_Str(a1, ~0U, &len)) || !(d = BIOS_Ptr(a0, len + 1)) || !BIOS_Fits(len + 1))
+               return false;
+
+            for(i = 0; i <= len; i++)
+               d[i] = s[i];
+
+            BIOS_Written(a0, len + 1);
+            ret = a0;
+            bytes = len + 1;
+         }
+         break;
+
+      case 0x1B: // strlen(s)
+         if(a0)
+         {
+            if(!BIOS_Str(a0, ~0U, &ret))
+               return false;
+
+            bytes = ret;
+         }
+         break;
+
+      case 0x28: // bzero(dst, len)
+      case 0x2B: // memset(dst, c, len)
+         {
+            const uint32_t len = (fn == 0x28) ? a1 : a2;
+            const uint8_t c = (fn == 0x28) ? 0 : a1;
+            uint8_t *d;
+
+            if(!a0 || (int32)len <= 0)
+               break;
+
+            if(!(d = BIOS_Ptr(a0, len)) || !BIOS_Fits(len))
+               return false;
+
+            memset(d, c, len);
+            BIOS_Written(a0, len);
+            ret = a0;
+            bytes = len;
+         }
+         break;
+
+      case 0x2A: // memcpy(dst, src, len)
+         {
+            const uint8_t *s;
+            uint8_t *d;
+            uint32_t i;
+
+            if(!a0 || !a1 || (int32)a2 <= 0)
+               break;
+
+            if(!(d = BIOS_Ptr(a0, a2)) || !(s = BIOS_Ptr(a1, a2)) || !BIOS_Fits(a2))
+               return false;
+
+            // Byte at a time, forwards, like the kernel; overlapping copies come out the same.
+            for(i = 0; i < a2; i++)
+               d[i] = s[i];
+
+            BIOS_Written(a0, a2);
+            ret = a0;
+            bytes = a2;
+         }
+         break;
+
+      case 0x2D: // memcmp(a, b, len)
+         {
+            const uint8_t *pa, *pb;
+            uint32_t i;
+
+            if(!a0 || !a1 || (int32)a2 <= 0)
+               break;
+
+            if(!(pa = BIOS_Ptr(a0, a2)) || !(pb = BIOS_Ptr(a1, a2)))
+               return false;
+
+            for(i = 0; i < a2; i++)
+            {
+               if(pa[i] != pb[i])
+               {
+                  ret = pa[i] - pb[i];
+                  break;
+               }
+            }
+            bytes = i;
+         }
+         break;
+
+      case 0x3C: // putchar(c)
+         if(!BIOS_Fits(1))
+            return false;
+
+         PSX_DBG(PSX_DBG_BIOS_PRINT, "%c", (char)a0);
+         ret = a0 & 0xFF;
+         bytes = 1;
+         break;
+
+      case 0x3E: // puts(s)
+         {
+            uint32_t len;
+            const uint8_t *s;
+
+            if(!a0)
+               break;
+
+            if(!(s = BIOS_Str(a0, ~0U, &len)) || !BIOS_Fits(len))
+               return false;
+
+            PSX_DBG(PSX_DBG_BIOS_PRINT, "%s", (const char *)s);
+            bytes = len;
+         }
+         break;
+
+      case 0x3F: // printf(fmt, ...)
+         {
+            char out[BIOS_PRINTF_MAX];
+
+            if(!BIOS_Printf(gpr, out, &ret) || !BIOS_Fits(ret))
+               return false;
+
+            PSX_DBG(PSX_DBG_BIOS_PRINT, "%s", out);
+            bytes = ret;
+         }
+         break;
+
+      default:
+         return false;
+   }
+
+   if(!BIOS_Fits(bytes))
+      return false;
+
+   gpr[2] = ret;
+   *cycles = BIOS_CALL_CYCLES + bytes * BIOS_BYTE_CYCLES;
+   return true;
+}
+
+static bool BIOS_B0(uint32_t fn, uint32_t *gpr, int32_t *cycles)
+{
+   const uint32_t a0 = gpr[4];
+   uint32_t ret = 0;
+   uint32_t bytes = 0;
+
+   switch(fn)
+   {
+      case 0x0B: // TestEvent(id)
+      case 0x0C: // EnableEvent(id)
+      case 0x0D: // DisableEvent(id)
+         {
+            uint32_t A;
+            uint32_t status;
+            uint8_t *ev = BIOS_EvCB(a0, &A);
+
+            if(!ev)
+               return false;
+
+            status = BIOS_Load32(ev + 4);
+
+            if(fn == 0x0B)
+            {
+               if(status == BIOS_EVENT_READY)
+               {
+                  BIOS_Store32(ev + 4, BIOS_EVENT_ENABLED);
+                  ret = 1;
+               }
+            }
+            else
+            {
+               if(status)
+                  BIOS_Store32(ev + 4, (fn == 0x0C) ? BIOS_EVENT_ENABLED : BIOS_EVENT_DISABLED);
+               ret = 1;
+            }
+
+            BIOS_Written(A + 4, 4);
+         }
+         break;
+
+      case 0x3D: // putchar(c)
+         if(!BIOS_Fits(1))
+            return false;
+
+         PSX_DBG(PSX_DBG_BIOS_PRINT, "%c", (char)a0);
+         ret = a0 & 0xFF;
+         bytes = 1;
+         break;
+
+      case 0x3F: // puts(s)
+         {
+            uint32_t len;
+            const uint8_t *s;
+
+            if(!a0)
+               break;
+
+            if(!(s = BIOS_Str(a0, ~0U, &len)) || !BIOS_Fits(len))
+               return false;
+
+            PSX_DBG(PSX_DBG_BIOS_PRINT, "%s", (const char *)s);
+            bytes = len;
+         }
+         break;
+
+      default:
+         return false;
+   }
+
+   if(!BIOS_Fits(bytes))
+      return false;
+
+   gpr[2] = ret;
+   *cycles = BIOS_CALL_CYCLES + bytes * BIOS_BYTE_CYCLES;
+   return true;
+}
+
+bool BIOS_HLE_Call(uint32_t vector, uint32_t *gpr, uint8_t *scratch, int32_t max_cycles, int32_t *cycles)
+{
+   const uint32_t fn = gpr[9];
+   const uint32_t *stub;
+   uint32_t table;
+   uint32_t entry;
+
+   if(vector == 0xA0)
+   {
+      table = BIOS_A0_TABLE;
+      stub = BIOS_A0_Stub;
+   }
+   else if(vector == 0xB0)
+   {
+      table = BIOS_B0_TABLE;
+      stub = BIOS_B0_Stub;
+   }
+   else
+      return false;
+
+   if(fn >= 0x100)
+      return false;
+
+   // Only through the kernel's own dispatch stub; a game or BIOS that put something else at
+   // the vector gets what it put there.
+   for(unsigned i = 0; i < 4; i++)
+   {
+      if(BIOS_Load32(&MainRAM.data8[vector + (i << 2)]) != stub[i])
+         return false;
+   }
+
+   // Only calls still going to the kernel's own code; a game that pointed a table entry at a
+   // hook of its own gets its hook.
+   entry = BIOS_Load32(&MainRAM.data8[table + (fn << 2)]) & 0x1FFFFFFF;
+
+   if(!entry || (entry >= BIOS_KERNEL_END && (entry < 0x1FC00000 || entry > 0x1FC7FFFF)))
+      return false;
+
+   BIOS_Scratch = scratch;
+   BIOS_MaxCycles = max_cycles;
+
+   // The event functions update their control block as they go, before the final check.
+   if(!BIOS_Fits(0))
+      return false;
+
+   if(vector == 0xA0)
+      return BIOS_A0(fn, gpr, cycles);
+
+   return BIOS_B0(fn, gpr, cycles);
+}
@@ -0,0 +1,18 @@
+#ifndef __MDFN_PSX_BIOS_H
+#define __MDFN_PSX_BIOS_H
+
+#include <stdint.h>
+
+// High-level emulation of the common kernel functions reached through the A0h/B0h vectors.
+//
+// vector is the physical address jumped to, gpr the CPU's register file(function number in t1,
+// arguments in a0-a3 and on the stack), scratch the scratchpad or NULL if it's disabled.
+//
+// Returns false, without touching anything, if the call isn't one that's handled here, the vector
+// doesn't hold the kernel's dispatch stub, its arguments point somewhere the native version can't
+// follow, or its estimated cost is more than max_cycles(the time left until the next event); the
+// BIOS code then runs as usual.
+// Otherwise v0 holds the result and *cycles the estimated cost of the call.
+bool BIOS_HLE_Call(uint32_t vector, uint32_t *gpr, uint8_t *scratch, int32_t max_cycles, int32_t *cycles);
+
+#endif
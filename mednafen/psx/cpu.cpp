@@ -17,6 +17,10 @@
 
 #include "psx.h"
 #include "cpu.h"
+#include "bios.h"
+#ifdef HAVE_CPU_PROFILER
+#include "profiler.h"
+#endif
 
 // iCB: PGXP STUFF
 #include "../pgxp/pgxp_cpu.h"
@@ -25,6 +29,9 @@
 // int pgxpMode = PGXP_GetModes();
 
 extern bool psx_cpu_overclock;
+extern enum cpu_core_mode psx_cpu_core;
+extern bool psx_cpu_idle_skip;
+extern bool psx_cpu_bios_hle;
 
 #define BIU_ENABLE_ICACHE_S1	0x00000800	// Enable I-cache, set 1
 #define BIU_ICACHE_FSIZE_MASK	0x00000300  // I-cache fill size mask; 0x000 = 2 words, 0x100 = 4 words, 0x200 = 8 words, 0x300 = 16 words
@@ -34,6 +41,12 @@ extern bool psx_cpu_overclock;
 #define BIU_INVALIDATE_MODE	0x00000002	// Enable Invalidate mode(IsC must be set to 1 as well presumably?)
 #define BIU_LOCK_MODE		   0x00000001	// Enable Lock mode(IsC must be set to 1 as well presumably?)
 
+#ifdef HAVE_JIT
+#define JIT_MAX_BLOCK_LENGTH	64
+#define JIT_BLOCK_TABLE_SIZE	((0x200000 + 0x80000) >> 2)	// RAM(mirrors folded) then BIOS, one entry per word
+#define JIT_MAX_STALE_BLOCKS	8192	// Replaced blocks keep their code in the libjit context until the next flush.
+#endif
+
 PS_CPU::PS_CPU()
 {
    uint64_t a;
@@ -48,9 +61,22 @@ PS_CPU::PS_CPU()
 
    CPUHook = NULL;
    ADDBT = NULL;
+   UpdateRunFunc();
 
    GTE_Init();
 
+   memset(CIPages, 0, sizeof(CIPages));
+   CICur = NULL;
+   CIBase = ~0U;
+   PSX_AddCodeInvalidateCB(CodeInvalidated, this);
+   IdleReset();
+
+#ifdef HAVE_JIT
+   JITBlocks = (JITBlock **)calloc(JIT_BLOCK_TABLE_SIZE, sizeof(JITBlock *));
+   JITStaleCount = 0;
+   decomp_init();
+#endif
+
    for(i = 0; i < 24; i++)
    {
       uint8 v = 7;
@@ -67,8 +93,15 @@ PS_CPU::PS_CPU()
 
 PS_CPU::~PS_CPU()
 {
-
-
+   PSX_RemoveCodeInvalidateCB(CodeInvalidated, this);
+   CI_Flush();
+
+#ifdef HAVE_JIT
+   JIT_Flush();
+   free(JITBlocks);
+   JITBlocks = NULL;
+   decomp_kill();
+#endif
 }
 
 void PS_CPU::SetFastMap(void *region_mem, uint32_t region_address, uint32_t region_size)
@@ -145,6 +178,12 @@ void PS_CPU::Power(void)
    }
 
    GTE_Power();
+
+   CI_Flush();
+   IdleReset();
+#ifdef HAVE_JIT
+   JIT_Flush();
+#endif
 }
 
 int PS_CPU::StateAction(StateMem *sm, int load, int data_only)
@@ -189,7 +228,11 @@ int PS_CPU::StateAction(StateMem *sm, int load, int data_only)
 
    if(load)
    {
-
+      CI_Flush();
+      IdleReset();
+#ifdef HAVE_JIT
+      JIT_Flush();
+#endif
    }
 
    return(ret);
@@ -382,6 +425,7 @@ INLINE void PS_CPU::WriteMemory(int32_t &timestamp, uint32_t address, uint32_t v
    }
 }
 
+template<bool Overclock>
 INLINE uint32 PS_CPU::ReadInstruction(pscpu_timestamp_t &timestamp, uint32 address)
 {
 	uint32 instr = ICache[(address & 0xFFC) >> 2].Data;
@@ -396,7 +440,7 @@ INLINE uint32 PS_CPU::ReadInstruction(pscpu_timestamp_t &timestamp, uint32 addre
 		{
 			instr = LoadU32_LE((uint32_t *)&FastMap[address >> FAST_MAP_SHIFT][address]);
 
-			if (!psx_cpu_overclock)
+			if (!Overclock)
 			{
 				// Approximate best-case cache-disabled time, per PS1 tests
 				// (executing out of 0xA0000000+); it can be 5 in 
@@ -417,28 +461,28 @@ INLINE uint32 PS_CPU::ReadInstruction(pscpu_timestamp_t &timestamp, uint32 addre
 			ICI[0x03].TV = (address &~ 0xF) | 0x0C | 0x2;
 
 			// When overclock is enabled, remove code cache fetch latency
-			if (!psx_cpu_overclock)
+			if (!Overclock)
 				timestamp += 3;
 
 			switch(address & 0xC)
 			{
 			case 0x0:
-				if (!psx_cpu_overclock)
+				if (!Overclock)
 					timestamp++;
 				ICI[0x00].TV &= ~0x2;
 				ICI[0x00].Data = LoadU32_LE(&FMP[0]);
 			case 0x4:
-				if (!psx_cpu_overclock)
+				if (!Overclock)
 					timestamp++;
 				ICI[0x01].TV &= ~0x2;
 				ICI[0x01].Data = LoadU32_LE(&FMP[1]);
 			case 0x8:
-				if (!psx_cpu_overclock)
+				if (!Overclock)
 					timestamp++;
 				ICI[0x02].TV &= ~0x2;
 				ICI[0x02].Data = LoadU32_LE(&FMP[2]);
 			case 0xC:
-				if (!psx_cpu_overclock)
+				if (!Overclock)
 					timestamp++;
 				ICI[0x03].TV &= ~0x2;
 				ICI[0x03].Data = LoadU32_LE(&FMP[3]);
@@ -459,6 +503,8 @@ uint32_t PS_CPU::Exception(uint32_t code, uint32_t PC, const uint32 NP, const ui
 
    assert(code < 16);
 
+   IdleVisits = 0;
+
    if(CP0.SR & (1 << 22))	// BEV
       handler = 0xBFC00180;
 
@@ -474,6 +520,10 @@ uint32_t PS_CPU::Exception(uint32_t code, uint32_t PC, const uint32 NP, const ui
       ADDBT(PC, handler, true);
 #endif
 
+#ifdef HAVE_CPU_PROFILER
+   PROF_Exception(CP0.EPC, handler);
+#endif
+
    // "Push" IEc and KUc(so that the new IEc and KUc are 0)
    CP0.SR = (CP0.SR & ~0x3F) | ((CP0.SR << 2) & 0x3F);
 
@@ -491,555 +541,1464 @@ uint32_t PS_CPU::Exception(uint32_t code, uint32_t PC, const uint32 NP, const ui
    return(handler);
 }
 
-#define BACKING_TO_ACTIVE			\
-	PC = BACKED_PC;				\
-	new_PC = BACKED_new_PC;			\
-	new_PC_mask = BACKED_new_PC_mask;	\
-	LDWhich = BACKED_LDWhich;		\
-	LDValue = BACKED_LDValue;
+void PS_CPU::CodeInvalidated(void *data, uint32_t page_address)
+{
+   PS_CPU *cpu = (PS_CPU *)data;
+   CIPage *page = cpu->CIPages[page_address >> 12];
 
-#define ACTIVE_TO_BACKING			\
-	BACKED_PC = PC;				\
-	BACKED_new_PC = new_PC;			\
-	BACKED_new_PC_mask = new_PC_mask;	\
-	BACKED_LDWhich = LDWhich;		\
-	BACKED_LDValue = LDValue;
+   if(page && page->valid)
+   {
+      page->valid = false;
+      cpu->CIBase = ~0U;
+   }
 
-#define GPR_DEPRES_BEGIN { uint8_t back = ReadAbsorb[0];
-#define GPR_DEP(n) { unsigned tn = (n); ReadAbsorb[tn] = 0; }
-#define GPR_RES(n) { unsigned tn = (n); ReadAbsorb[tn] = 0; }
-#define GPR_DEPRES_END ReadAbsorb[0] = back; }
+   cpu->IdleReset();
 
-template<bool DebugMode>
-int32_t PS_CPU::RunReal(int32_t timestamp_in)
+#ifdef HAVE_JIT
+   cpu->JIT_InvalidatePage(page_address);
+#endif
+}
+
+void PS_CPU::CI_Flush(void)
 {
-   uint32_t PC;
-   uint32_t new_PC;
-   uint32_t new_PC_mask;
-   uint32_t LDWhich;
-   uint32_t LDValue;
-   int32_t timestamp = timestamp_in;
+   unsigned i;
 
-   //printf("%d %d\n", gte_ts_done, muldiv_ts_done);
+   for(i = 0; i < sizeof(CIPages) / sizeof(CIPages[0]); i++)
+   {
+      free(CIPages[i]);
+      CIPages[i] = NULL;
+   }
 
-   gte_ts_done += timestamp;
-   muldiv_ts_done += timestamp;
+   CICur = NULL;
+   CIBase = ~0U;
+}
 
-   BACKING_TO_ACTIVE;
+void PS_CPU::CI_Decode(CIOp *op, uint32_t instr)
+{
+   const uint32_t opcode = instr >> 26;
+
+   op->instr = instr;
+   op->opf = opcode ? (0x40 | opcode) : (instr & 0x3F);
+   op->rs = (instr >> 21) & 0x1F;
+   op->rt = (instr >> 16) & 0x1F;
+   op->rd = (instr >> 11) & 0x1F;
+
+   if(opcode == 0x00)
+      op->imm = (instr >> 6) & 0x1F;
+   else if(opcode == 0x02 || opcode == 0x03)
+      op->imm = instr & ((1 << 26) - 1);
+   else if(opcode >= 0x0C && opcode <= 0x0F)
+      op->imm = instr & 0xFFFF;
+   else
+      op->imm = (int32)(int16)(instr & 0xFFFF);
+}
 
-   do
+// Makes the decoded page containing 'pc' current, decoding it if needed.  Returns false
+// if 'pc' isn't in RAM or BIOS.
+bool PS_CPU::CI_Lookup(uint32_t pc)
+{
+   const uint32_t phys = pc & addr_mask[pc >> 29];
+   unsigned index;
+   CIPage *page;
+
+   if(phys < 0x00800000)
+      index = (phys & 0x1FFFFF) >> 12;
+   else if(phys >= 0x1FC00000 && phys < 0x1FC80000)
+      index = (0x200000 + (phys & 0x7FFFF)) >> 12;
+   else
+      return false;
+
+   page = CIPages[index];
+
+   if(!page)
    {
-      //printf("Running: %d %d\n", timestamp, next_event_ts);
-      while(MDFN_LIKELY(timestamp < next_event_ts))
-      {
-         uint32_t instr;
-         uint32_t opf;
+      page = CIPages[index] = (CIPage *)malloc(sizeof(CIPage));
+      page->valid = false;
+   }
 
-         // Zero must be zero...until the Master Plan is enacted.
-         GPR[0] = 0;
+   if(!page->valid)
+   {
+      const uint32_t base = pc & ~0xFFFU;
+      const uint32_t *code = (uint32_t *)&FastMap[base >> FAST_MAP_SHIFT][base];
+      unsigned i;
 
-#ifdef HAVE_DEBUG
-         if(DebugMode && CPUHook)
-         {
-            ACTIVE_TO_BACKING;
+      for(i = 0; i < 1024; i++)
+         CI_Decode(&page->ops[i], LoadU32_LE(&code[i]));
 
-            // For save states in step mode.
-            gte_ts_done -= timestamp;
-            muldiv_ts_done -= timestamp;
+      page->valid = true;
 
-            CPUHook(timestamp, PC);
+      if(phys < 0x00800000)
+         PSX_MarkCodePage(phys);
+   }
 
-            // For save states in step mode.
-            gte_ts_done += timestamp;
-            muldiv_ts_done += timestamp;
+   CICur = page->ops;
+   CIBase = pc & ~0xFFFU;
 
-            BACKING_TO_ACTIVE;
-         }
-#endif
+   return true;
+}
 
-		 //
-		 // Instruction fetch
-		 //
-         if(MDFN_UNLIKELY(PC & 0x3))
+//
+// Idle loop skipping
+//
+// Taken branches go through IdleTransfer().  A backward branch over at most
+// IDLE_MAX_LENGTH bytes makes its target the watched loop if the loop is
+// straight-line code made of ALU ops and loads, where any other branch leaves
+// the loop.  Any other control transfer(and exceptions) restarts the count of
+// iterations.
+//
+// At each iteration start, IdleCheck() compares the CPU state with the previous
+// one.  Once two consecutive iterations(not counting the first, which may fill
+// the I-cache) start from the same state with no event in between, and all
+// loads hit memory or registers that can only change at an event, every further
+// iteration up to the next event would be identical, so they're skipped by
+// advancing the timestamp by whole iterations.
+//
+#define IDLE_MAX_LENGTH	(16 * 4)
+
+static INLINE bool IdleIsBranch(uint32_t instr)
+{
+   const uint32_t op = instr >> 26;
+
+   if(op == 0x00)
+      return (instr & 0x3E) == 0x08;
+
+   return op >= 0x01 && op <= 0x07;
+}
+
+// Computes and loads; no stores, traps, coprocessor or HI/LO access.
+static bool IdleIsSafe(uint32_t instr)
+{
+   switch(instr >> 26)
+   {
+      case 0x00:
+         switch(instr & 0x3F)
          {
-            // This will block interrupt processing, but since we're going more for keeping broken homebrew/hacks from working
-            // than super-duper-accurate pipeline emulation, it shouldn't be a problem.
-            new_PC = Exception(EXCEPTION_ADEL, PC, new_PC, new_PC_mask, 0);
-            new_PC_mask = 0;
-            goto OpDone;
+            case 0x00: case 0x02: case 0x03: case 0x04: case 0x06: case 0x07:
+            case 0x21: case 0x23: case 0x24: case 0x25: case 0x26: case 0x27:
+            case 0x2A: case 0x2B:
+               return true;
          }
+         return false;
 
-		 instr = ReadInstruction(timestamp, PC);
+      case 0x09: case 0x0A: case 0x0B: case 0x0C: case 0x0D: case 0x0E: case 0x0F:
+      case 0x20: case 0x21: case 0x23: case 0x24: case 0x25:
+         return true;
+   }
 
+   return false;
+}
 
-         //printf("PC=%08x, SP=%08x - op=0x%02x - funct=0x%02x - instr=0x%08x\n", PC, GPR[29], instr >> 26, instr & 0x3F, instr);
-         //for(int i = 0; i < 32; i++)
-         // printf("%02x : %08x\n", i, GPR[i]);
-         //printf("\n");
+// Reads with no side effects, whose result can't change before the next event.
+static bool IdleAddressOK(uint32_t address, unsigned size)
+{
+   const uint32_t phys = address & addr_mask[address >> 29];
 
-		 //
-		 // Instruction decode
-		 //
-         opf = instr & 0x3F;
+   if(address & (size - 1))
+      return false;
 
-         if(instr & (0x3F << 26))
-            opf = 0x40 | (instr >> 26);
+   if(phys < 0x00800000)	// RAM
+      return true;
 
-         opf |= IPCache;
+   if(phys >= 0x1F800000 && phys <= 0x1F8003FF)	// Scratchpad
+      return true;
 
-         if(ReadAbsorb[ReadAbsorbWhich])
-            ReadAbsorb[ReadAbsorbWhich]--;
+   if(phys >= 0x1FC00000 && phys <= 0x1FC7FFFF)	// BIOS
+      return true;
 
-         else
-            timestamp++;
+   if(phys >= 0x1F801070 && phys <= 0x1F801077)	// IRQ status and mask
+      return true;
 
-   #define DO_LDS() { GPR[LDWhich] = LDValue; ReadAbsorb[LDWhich] = LDAbsorb; ReadFudge = LDWhich; ReadAbsorbWhich |= LDWhich & 0x1F; LDWhich = 0x20; }
-   #define BEGIN_OPF(name) { op_##name:
-   #define END_OPF goto OpDone; }
+   if(phys >= 0x1F801814 && phys <= 0x1F801817)	// GPU status
+      return true;
 
-   #define DO_BRANCH(offset, mask)			\
-	{						\
-	  PC = (PC & new_PC_mask) + new_PC;		\
-	 new_PC = (offset);				\
-	 new_PC_mask = (mask) & ~3;			\
-	 /* Lower bits of new_PC_mask being clear signifies being in a branch delay slot. (overloaded behavior for performance) */	\
-	 goto SkipNPCStuff;				\
-	}
+   if(phys == 0x1F801800 || phys == 0x1F801803)	// CDC status, and IRQ flags
+      return true;
 
+   return false;
+}
 
-   #define ITYPE uint32 rs MDFN_NOWARN_UNUSED = (instr >> 21) & 0x1F; uint32 rt MDFN_NOWARN_UNUSED = (instr >> 16) & 0x1F; uint32 immediate = (int32)(int16)(instr & 0xFFFF); /*printf(" rs=%02x(%08x), rt=%02x(%08x), immediate=(%08x) ", rs, GPR[rs], rt, GPR[rt], immediate);*/
-   #define ITYPE_ZE uint32 rs MDFN_NOWARN_UNUSED = (instr >> 21) & 0x1F; uint32 rt MDFN_NOWARN_UNUSED = (instr >> 16) & 0x1F; uint32 immediate = instr & 0xFFFF; /*printf(" rs=%02x(%08x), rt=%02x(%08x), immediate=(%08x) ", rs, GPR[rs], rt, GPR[rt], immediate);*/
-   #define JTYPE uint32 target = instr & ((1 << 26) - 1); /*printf(" target=(%08x) ", target);*/
-   #define RTYPE uint32 rs MDFN_NOWARN_UNUSED = (instr >> 21) & 0x1F; uint32 rt MDFN_NOWARN_UNUSED = (instr >> 16) & 0x1F; uint32 rd MDFN_NOWARN_UNUSED = (instr >> 11) & 0x1F; uint32 shamt MDFN_NOWARN_UNUSED = (instr >> 6) & 0x1F; /*printf(" rs=%02x(%08x), rt=%02x(%08x), rd=%02x(%08x) ", rs, GPR[rs], rt, GPR[rt], rd, GPR[rd]);*/
+void PS_CPU::IdleReset(void)
+{
+   IdleHead = ~0U;
+   IdleLen = 0;
+   IdleReject = ~0U;
+   IdleVisits = 0;
+}
 
-#if !defined(__GNUC__) || defined(NO_COMPUTED_GOTO)
-   /* (uint8) cast for cheaper alternative to generated branch+compare bounds check instructions, but still more
-      expensive than computed goto which needs no masking nor bounds checking.
-   */
-   #define CGBEGIN { enum { CGESB = 1 + __COUNTER__ }; switch((uint8)opf) {
-   #define CGE(l) case __COUNTER__ - CGESB: goto l;
-   #define CGEND } }
-#else
-   #define CGBEGIN static const void *const op_goto_table[256] = {
-   #define CGE(l) &&l,
-   #define CGEND }; goto *op_goto_table[opf];
-#endif
+void PS_CPU::IdleWatch(uint32_t head, uint32_t ds_pc)
+{
+   const uint32_t phys = head & addr_mask[head >> 29];
+   const unsigned count = ((ds_pc - head) >> 2) + 1;
+   const uint32_t *code = (uint32_t *)&FastMap[head >> FAST_MAP_SHIFT][head];
+   unsigned i;
 
-   CGBEGIN
-    CGE(op_SLL)  CGE(op_ILL)   CGE(op_SRL)  CGE(op_SRA)   CGE(op_SLLV)    CGE(op_ILL)   CGE(op_SRLV) CGE(op_SRAV)
-    CGE(op_JR)   CGE(op_JALR)  CGE(op_ILL)  CGE(op_ILL)   CGE(op_SYSCALL) CGE(op_BREAK) CGE(op_ILL)  CGE(op_ILL)
-    CGE(op_MFHI) CGE(op_MTHI)  CGE(op_MFLO) CGE(op_MTLO)  CGE(op_ILL)     CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)
-    CGE(op_MULT) CGE(op_MULTU) CGE(op_DIV)  CGE(op_DIVU)  CGE(op_ILL)     CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)
-    CGE(op_ADD)  CGE(op_ADDU)  CGE(op_SUB)  CGE(op_SUBU)  CGE(op_AND)     CGE(op_OR)    CGE(op_XOR)  CGE(op_NOR)
-    CGE(op_ILL)  CGE(op_ILL)   CGE(op_SLT)  CGE(op_SLTU)  CGE(op_ILL)     CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)
-    CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)     CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)
-    CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)     CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)
+   IdleHead = ~0U;
+   IdleReject = head;
+   IdleVisits = 0;
 
-    CGE(op_ILL)  CGE(op_BCOND) CGE(op_J)    CGE(op_JAL)   CGE(op_BEQ)  CGE(op_BNE) CGE(op_BLEZ) CGE(op_BGTZ)
-    CGE(op_ADDI) CGE(op_ADDIU) CGE(op_SLTI) CGE(op_SLTIU) CGE(op_ANDI) CGE(op_ORI) CGE(op_XORI) CGE(op_LUI)
-    CGE(op_COP0) CGE(op_COP1)  CGE(op_COP2) CGE(op_COP3)  CGE(op_ILL)  CGE(op_ILL) CGE(op_ILL)  CGE(op_ILL)
-    CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL) CGE(op_ILL)  CGE(op_ILL)
-    CGE(op_LB)   CGE(op_LH)    CGE(op_LWL)  CGE(op_LW)    CGE(op_LBU)  CGE(op_LHU) CGE(op_LWR)  CGE(op_ILL)
-    CGE(op_SB)   CGE(op_SH)    CGE(op_SWL)  CGE(op_SW)    CGE(op_ILL)  CGE(op_ILL) CGE(op_SWR)  CGE(op_ILL)
-    CGE(op_LWC0) CGE(op_LWC1)  CGE(op_LWC2) CGE(op_LWC3)  CGE(op_ILL)  CGE(op_ILL) CGE(op_ILL)  CGE(op_ILL)
-    CGE(op_SWC0) CGE(op_SWC1)  CGE(op_SWC2) CGE(op_SWC3)  CGE(op_ILL)  CGE(op_ILL) CGE(op_ILL)  CGE(op_ILL)
+   if((head & 3) || ((head ^ ds_pc) & ~0xFFFU))
+      return;
 
-    // Interrupt portion of this table is constructed so that an interrupt won't be taken when the PC is pointing to a GTE instruction,
-    // to avoid problems caused by pipeline vs coprocessor nuances that aren't emulated.
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+   if(!(phys < 0x00800000 || (phys >= 0x1FC00000 && phys < 0x1FC80000)))
+      return;
 
-    CGE(op_ILL)       CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_COP2)      CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
-   CGEND
+   for(i = 0; i < count; i++)
+      IdleCode[i] = LoadU32_LE(&code[i]);
 
+   for(i = 0; i < count; i++)
    {
-    BEGIN_OPF(ILL);
-	     PSX_WARNING("[CPU] Unknown instruction @%08x = %08x, op=%02x, funct=%02x", PC, instr, instr >> 26, (instr & 0x3F));
-	     DO_LDS();
-	     new_PC = Exception(EXCEPTION_RI, PC, new_PC, new_PC_mask, instr);
-	     new_PC_mask = 0;
-    END_OPF;
+      const uint32_t instr = IdleCode[i];
+      const uint32_t op = instr >> 26;
 
-    //
-    // ADD - Add Word
-    //
-    BEGIN_OPF(ADD);
-	RTYPE;
+      if(!IdleIsBranch(instr))
+      {
+         if(!IdleIsSafe(instr))
+            return;
+         continue;
+      }
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
- 	GPR_RES(rd);
-	GPR_DEPRES_END
+      // No branches in delay slots, and no linking.
+      if(i + 1 >= count || IdleIsBranch(IdleCode[i + 1]))
+         return;
 
-	uint32 result = GPR[rs] + GPR[rt];
-	bool ep = ((~(GPR[rs] ^ GPR[rt])) & (GPR[rs] ^ result)) & 0x80000000;
+      if(op == 0x00 || op == 0x03 || (op == 0x01 && (instr & (0x1E << 16)) == (0x10 << 16)))
+         return;
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_ADD(instr, result, GPR[rs], GPR[rt]);
+      if(op >= 0x06 && ((instr >> 16) & 0x1F))
+         return;
 
-	DO_LDS();
+      if(i == count - 2)	// The back branch.
+         continue;
 
-	if(MDFN_UNLIKELY(ep))
-	{
-	 new_PC = Exception(EXCEPTION_OV, PC, new_PC, new_PC_mask, instr);
-         new_PC_mask = 0;
-	}
-	else
-	 GPR[rd] = result;
+      if(op == 0x02)
+         return;
 
-    END_OPF;
+      // Other branches must leave the loop.
+      {
+         const uint32_t target = head + (i << 2) + 4 + ((int32)(int16)(instr & 0xFFFF) << 2);
 
-    //
-    // ADDI - Add Immediate Word
-    //
-    BEGIN_OPF(ADDI);
-	ITYPE;
+         if((target - head) < (count << 2))
+            return;
+      }
+   }
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_RES(rt);
-	GPR_DEPRES_END
+   IdleHead = head;
+   IdleLen = count << 2;
+   IdleReject = ~0U;
 
-        uint32 result = GPR[rs] + immediate;
+   // Forget the loop if its code is overwritten.
+   if(phys < 0x00800000)
+      PSX_MarkCodePage(phys);
+}
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_ADDI(instr, result, GPR[rs]);
+INLINE void PS_CPU::IdleTransfer(uint32_t ds_pc, uint32_t target)
+{
+   if(target == IdleHead && (ds_pc - target) < IdleLen)
+      return;
 
-	bool ep = ((~(GPR[rs] ^ immediate)) & (GPR[rs] ^ result)) & 0x80000000;
+   IdleVisits = 0;
 
-	
+   if((ds_pc - target) < IDLE_MAX_LENGTH && target != IdleHead && target != IdleReject)
+      IdleWatch(target, ds_pc);
+}
 
-	DO_LDS();
+// Checks every load in the loop goes to IdleAddressOK() memory, propagating
+// register values from the start of the iteration.
+bool PS_CPU::IdleLoadsOK(const IdleSnapshot *snap)
+{
+   const unsigned count = IdleLen >> 2;
+   uint32_t val[32];
+   uint32_t known = ~0U;
+   unsigned i;
 
-        if(MDFN_UNLIKELY(ep))
-	{
-	 new_PC = Exception(EXCEPTION_OV, PC, new_PC, new_PC_mask, instr);
-         new_PC_mask = 0;
-	}
-        else
-         GPR[rt] = result;
+   memcpy(val, snap->GPR, sizeof(val));
 
-    END_OPF;
+   // Written by the first instruction, after it has read its operands.
+   if(snap->LDWhich < 0x20)
+      known &= ~(1U << snap->LDWhich);
 
-    //
-    // ADDIU - Add Immediate Unsigned Word
-    //
-    BEGIN_OPF(ADDIU);
-	ITYPE;
+   for(i = 0; i < count; i++)
+   {
+      const uint32_t instr = IdleCode[i];
+      const uint32_t op = instr >> 26;
+      const uint32_t rs = (instr >> 21) & 0x1F;
+      const uint32_t rt = (instr >> 16) & 0x1F;
+      const uint32_t rd = (instr >> 11) & 0x1F;
+      const uint32_t simm = (int32)(int16)(instr & 0xFFFF);
+      const bool rs_known = (known >> rs) & 1;
+
+      switch(op)
+      {
+         case 0x00:
+            if(!IdleIsBranch(instr))
+            {
+               if((instr & 0x3F) == 0x21 || (instr & 0x3F) == 0x25)
+               {
+                  if(rs_known && ((known >> rt) & 1))
+                  {
+                     val[rd] = ((instr & 0x3F) == 0x21) ? (val[rs] + val[rt]) : (val[rs] | val[rt]);
+                     known |= 1U << rd;
+                  }
+                  else
+                     known &= ~(1U << rd);
+               }
+               else
+                  known &= ~(1U << rd);
+            }
+            break;
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_RES(rt);
-	GPR_DEPRES_END
+         case 0x09:	// ADDIU
+         case 0x0D:	// ORI
+            if(rs_known)
+            {
+               val[rt] = (op == 0x09) ? (val[rs] + simm) : (val[rs] | (instr & 0xFFFF));
+               known |= 1U << rt;
+            }
+            else
+               known &= ~(1U << rt);
+            break;
 
-	uint32 result = GPR[rs] + immediate;
+         case 0x0F:	// LUI
+            val[rt] = instr << 16;
+            known |= 1U << rt;
+            break;
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_ADDIU(instr, result, GPR[rs]);
+         case 0x20: case 0x21: case 0x23: case 0x24: case 0x25:
+            {
+               static const uint8_t sizes[6] = { 1, 2, 0, 4, 1, 2 };
 
-	DO_LDS();
+               if(!rs_known || !IdleAddressOK(val[rs] + simm, sizes[op - 0x20]))
+                  return false;
 
-	GPR[rt] = result;
+               known &= ~(1U << rt);
+            }
+            break;
 
-    END_OPF;
+         case 0x0A: case 0x0B: case 0x0C: case 0x0E:
+            known &= ~(1U << rt);
+            break;
+      }
 
-    //
-    // ADDU - Add Unsigned Word
-    //
-    BEGIN_OPF(ADDU);
-	RTYPE;
+      val[0] = 0;
+      known |= 1;
+   }
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
- 	GPR_RES(rd);
-	GPR_DEPRES_END
+   return true;
+}
 
-	uint32 result = GPR[rs] + GPR[rt];
+// Returns true if the timestamp was advanced.
+bool PS_CPU::IdleCheck(int32_t &timestamp, uint32_t LDWhich, uint32_t LDValue)
+{
+   IdleSnapshot cur;
+   bool skipped = false;
+
+   memset(&cur, 0, sizeof(cur));
+   memcpy(cur.GPR, GPR, sizeof(cur.GPR));
+   cur.LDWhich = LDWhich;
+   cur.LDValue = LDValue;
+   cur.LDAbsorb = LDAbsorb;
+   memcpy(cur.ReadAbsorb, ReadAbsorb, sizeof(cur.ReadAbsorb));
+   cur.ReadAbsorbWhich = ReadAbsorbWhich;
+   cur.ReadFudge = ReadFudge;
+
+   if(IdleVisits >= 2 && !IPCache && IdleEventTS == next_event_ts && !memcmp(&cur, &IdleSnap, sizeof(cur)))
+   {
+      const int32_t cycles = timestamp - IdleTS;
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_ADDU(instr, result, GPR[rs], GPR[rt]);
+      if(!IdleLoadsOK(&cur))
+      {
+         IdleReject = IdleHead;
+         IdleHead = ~0U;
+         return false;
+      }
 
-	DO_LDS();
+      // The iteration that reaches next_event_ts is left to run normally, so the event
+      // is handled at the same instruction as it would be without skipping.
+      if(cycles > 0 && (next_event_ts - timestamp) >= cycles)
+      {
+         timestamp += ((next_event_ts - timestamp) / cycles) * cycles;
+         skipped = true;
+      }
+   }
 
-	GPR[rd] = result;
+   IdleSnap = cur;
+   IdleTS = timestamp;
+   IdleEventTS = next_event_ts;
+   IdleVisits++;
 
-    END_OPF;
+   return skipped;
+}
 
-    //
-    // AND - And
-    //
-    BEGIN_OPF(AND);
-	RTYPE;
+// Called at the A0h/B0h/C0h vectors; on success the call has returned to ra.
+bool PS_CPU::BIOS_HLE(int32_t &timestamp, uint32_t &PC)
+{
+   int32_t cycles = 0;
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
- 	GPR_RES(rd);
-	GPR_DEPRES_END
+   // Stores with the cache isolated don't reach memory, and PGXP shadows memory the native
+   // versions write directly.
+   if((CP0.SR & 0x10000) || (PGXP_GetModes() & PGXP_MODE_MEMORY))
+      return false;
 
-	uint32 result = GPR[rs] & GPR[rt];
+   if(!BIOS_HLE_Call(PC & 0x1FFFFFFF, GPR, (BIU & BIU_DCACHE_SCRATCHPAD) ? ScratchRAM.data8 : NULL,
+            next_event_ts - timestamp, &cycles))
+      return false;
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_AND(instr, result, GPR[rs], GPR[rt]);
+   timestamp += cycles;
+   PC = GPR[31];
 
-	DO_LDS();
+   return true;
+}
 
-	GPR[rd] = result;
+#ifdef HAVE_JIT
+//
+// Dynamic recompiler
+//
+// Basic blocks are translated with libjit(decomp.cpp) the first time they're
+// executed, and cached by physical PC.  A block ends after a branch and its
+// delay slot, before any instruction the translator doesn't handle exactly
+// (mult/div, COP0, LWL/LWR/SWL/SWR, LWC2/SWC2, traps), at a 4KiB page boundary,
+// or after JIT_MAX_BLOCK_LENGTH instructions; everything else runs in the
+// interpreter.  Blocks are only entered outside of branch delay and load delay
+// slots with no interrupt pending, and only when they can't run past
+// next_event_ts.
+//
+// Translated loads write their register immediately, so a block never
+// includes a load whose delay slot instruction reads the loaded register.
+//
+// Timing follows the interpreter's fetch costs: 5 cycles an instruction for
+// uncached code, and for cached code 1 plus whatever I-cache line fills
+// ReadInstruction() would have charged, which are done(updating the I-cache
+// the same way) after the block returns.  What isn't modeled is the
+// interpreter's load delay absorption(ReadAbsorb): the instructions after a
+// translated load don't hide any of its latency, so loads cost a little more.
+//
+// Blocks in RAM mark their page with PSX_MarkCodePage(), and are dropped when
+// the page is written.  Nothing a block was built from lies outside its page.
+//
+
+static INLINE int JIT_BlockIndex(uint32_t pc)
+{
+   const uint32_t phys = pc & addr_mask[pc >> 29];
 
-    END_OPF;
+   if(phys < 0x00800000)
+      return (phys & 0x1FFFFF) >> 2;
 
-    //
-    // ANDI - And Immediate
-    //
-    BEGIN_OPF(ANDI);
-	ITYPE_ZE;
+   if(phys >= 0x1FC00000 && phys < 0x1FC80000)
+      return (0x200000 + (phys & 0x7FFFF)) >> 2;
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_RES(rt);
-	GPR_DEPRES_END
+   return -1;
+}
 
-	uint32 result = GPR[rs] & immediate;
+static bool JIT_CanTranslate(uint32_t instr)
+{
+   const uint32_t op = instr >> 26;
+   const uint32_t rs = (instr >> 21) & 0x1F;
+   const uint32_t rt = (instr >> 16) & 0x1F;
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_ANDI(instr, result, GPR[rs]);
+   switch(op)
+   {
+      case 0x00:
+         switch(instr & 0x3F)
+         {
+            case 0x00: case 0x02: case 0x03: case 0x04: case 0x06: case 0x07:	// Shifts
+            case 0x08:								// JR
+            case 0x20: case 0x21: case 0x22: case 0x23:				// ADD/ADDU/SUB/SUBU
+            case 0x24: case 0x25: case 0x26: case 0x27:				// AND/OR/XOR/NOR
+            case 0x2A: case 0x2B:						// SLT/SLTU
+               return true;
+
+            case 0x09:								// JALR; links before reading rs.
+               return ((instr >> 11) & 0x1F) != rs;
+         }
+         return false;
 
-	DO_LDS();
+      case 0x01:	// BLTZ/BGEZ, and BLTZAL/BGEZAL which link before reading rs.
+         return rt == 0x00 || rt == 0x01 || ((rt == 0x10 || rt == 0x11) && rs != 31);
 
-	GPR[rt] = result;
+      case 0x02: case 0x03: case 0x04: case 0x05:	// J/JAL/BEQ/BNE
+         return true;
 
-    END_OPF;
+      case 0x06: case 0x07:	// BLEZ/BGTZ
+         return rt == 0;
 
-    //
-    // BEQ - Branch on Equal
-    //
-    BEGIN_OPF(BEQ);
-	ITYPE;
+      case 0x08: case 0x09: case 0x0A: case 0x0B:
+      case 0x0C: case 0x0D: case 0x0E: case 0x0F:
+         return true;
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
+      case 0x12:	// GTE: commands, MTC2/CTC2, and MFC2/CFC2 that write a register.
+         return rs >= 0x10 || rs == 0x04 || rs == 0x06 || ((rs == 0x00 || rs == 0x02) && rt != 0);
 
-	bool result = (GPR[rs] == GPR[rt]);
+      case 0x20: case 0x21: case 0x23: case 0x24: case 0x25:	// LB/LH/LW/LBU/LHU; loads to r0 would be skipped.
+         return rt != 0;
 
-	DO_LDS();
+      case 0x28: case 0x29: case 0x2B:	// SB/SH/SW
+         return true;
+   }
 
-	if(result)
-	{
-	 DO_BRANCH((immediate << 2), ~0U);
-	}
-    END_OPF;
+   return false;
+}
 
-    // Bah, why does MIPS encoding have to be funky like this. :(
-    // Handles BGEZ, BGEZAL, BLTZ, BLTZAL
-    BEGIN_OPF(BCOND);
-	const uint32 tv = GPR[(instr >> 21) & 0x1F];
-	uint32 riv = (instr >> 16) & 0x1F;
-	uint32 immediate = (int32)(int16)(instr & 0xFFFF);
-	bool result = (int32)(tv ^ (riv << 31)) < 0;
-	const uint32 link = ((riv & 0x1E) == 0x10) ? 31 : 0;
+static INLINE bool JIT_IsBranch(uint32_t instr)
+{
+   const uint32_t op = instr >> 26;
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP((instr >> 21) & 0x1F);
- 	GPR_RES(link);
-	GPR_DEPRES_END
+   if(op == 0x00)
+      return (instr & 0x3E) == 0x08;
 
-	DO_LDS();
+   return op >= 0x01 && op <= 0x07;
+}
 
-	if(link)	// Unconditional link reg setting.
-	 GPR[link] = PC + 8;
+// Returns false for register jumps.
+static bool JIT_BranchTarget(uint32_t instr, uint32_t pc, uint32_t *target)
+{
+   const uint32_t op = instr >> 26;
 
-        if(result)
-	{
-	 DO_BRANCH((immediate << 2), ~0U);
-	}
+   if(op == 0x00)
+      return false;
 
-    END_OPF;
+   if(op == 0x02 || op == 0x03)
+      *target = ((pc + 4) & 0xF0000000) | ((instr & 0x3FFFFFF) << 2);
+   else
+      *target = pc + 4 + ((int32)(int16)(instr & 0xFFFF) << 2);
 
+   return true;
+}
 
-    //
-    // BGTZ - Branch on Greater than Zero
-    //
-    BEGIN_OPF(BGTZ);
-	ITYPE;
+// Register written with a load delay, or 0.
+static INLINE uint32_t JIT_LoadTarget(uint32_t instr)
+{
+   const uint32_t op = instr >> 26;
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEPRES_END
+   if((op >= 0x20 && op <= 0x26) || (op == 0x12 && !(instr & (0x1D << 21))))
+      return (instr >> 16) & 0x1F;
 
-	bool result = (int32)GPR[rs] > 0;
+   return 0;
+}
 
-	DO_LDS();
+// Whether the instruction reads GPR 'reg'; conservative for anything unusual.
+static bool JIT_ReadsGPR(uint32_t instr, uint32_t reg)
+{
+   const uint32_t op = instr >> 26;
+   const uint32_t rs = (instr >> 21) & 0x1F;
+   const uint32_t rt = (instr >> 16) & 0x1F;
 
-	if(result)
-	{
-	 DO_BRANCH((immediate << 2), ~0U);
-	}
-    END_OPF;
+   switch(op)
+   {
+      case 0x00:
+         switch(instr & 0x3F)
+         {
+            case 0x00: case 0x02: case 0x03:
+               return rt == reg;
 
-    //
-    // BLEZ - Branch on Less Than or Equal to Zero
-    //
-    BEGIN_OPF(BLEZ);
-	ITYPE;
+            case 0x08: case 0x09: case 0x11: case 0x13:
+               return rs == reg;
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEPRES_END
+            case 0x0C: case 0x0D: case 0x10: case 0x12:
+               return false;
+         }
+         return rs == reg || rt == reg;
 
-	bool result = (int32)GPR[rs] <= 0;
+      case 0x02: case 0x03: case 0x0F:
+         return false;
 
-	DO_LDS();
+      case 0x04: case 0x05:
+         return rs == reg || rt == reg;
 
-	if(result)
-	{
-	 DO_BRANCH((immediate << 2), ~0U);
-	}
+      case 0x01: case 0x06: case 0x07:
+      case 0x08: case 0x09: case 0x0A: case 0x0B:
+      case 0x0C: case 0x0D: case 0x0E:
+         return rs == reg;
 
-    END_OPF;
+      case 0x10: case 0x11: case 0x12: case 0x13:
+         if(rs == 0x04 || rs == 0x06)
+            return rt == reg;
+         return false;
 
-    //
-    // BNE - Branch on Not Equal
-    //
-    BEGIN_OPF(BNE);
-	ITYPE;
+      // LWL/LWR merge with the pending load value, so only rs matters for loads.
+      case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26:
+      case 0x30: case 0x31: case 0x32: case 0x33:
+      case 0x38: case 0x39: case 0x3A: case 0x3B:
+         return rs == reg;
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
+      case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2E:
+         return rs == reg || rt == reg;
+   }
 
-	bool result = GPR[rs] != GPR[rt];
+   return true;
+}
 
-	DO_LDS();
+INLINE unsigned PS_CPU::JIT_InstCycles(uint32_t pc)
+{
+   // Same fetch cost as ReadInstruction() for uncached code; cached code is
+   // charged as if it always hit.
+   if(!psx_cpu_overclock && (pc >= 0xA0000000 || !(BIU & 0x800)))
+      return 5;
 
-	if(result)
-	{
-	 DO_BRANCH((immediate << 2), ~0U);
-	}
+   return 1;
+}
 
-    END_OPF;
+// I-cache line fill cycles ReadInstruction() would charge fetching [pc, end_pc) of
+// cached code with the I-cache as it is now, without changing it.
+INLINE unsigned PS_CPU::JIT_ICacheCycles(uint32_t pc, uint32_t end_pc)
+{
+   unsigned cycles = 0;
 
-    //
-    // BREAK - Breakpoint
-    //
-    BEGIN_OPF(BREAK);
-	PSX_WARNING("[CPU] BREAK BREAK BREAK BREAK DAAANCE -- PC=0x%08x", PC);
+   if(psx_cpu_overclock)
+      return 0;
 
-	DO_LDS();
-	new_PC = Exception(EXCEPTION_BP, PC, new_PC, new_PC_mask, instr);
-        new_PC_mask = 0;
-    END_OPF;
+   while(pc < end_pc)
+   {
+      if(ICache[(pc & 0xFFC) >> 2].TV == pc)
+      {
+         pc += 4;
+         continue;
+      }
 
-    // Cop "instructions":	CFCz(no CP0), COPz, CTCz(no CP0), LWCz(no CP0), MFCz, MTCz, SWCz(no CP0)
-    //
-    // COP0 instructions
-    BEGIN_OPF(COP0);
-	uint32 sub_op = (instr >> 21) & 0x1F;
+      // A miss fills the rest of the line.
+      cycles += 3 + ((0x10 - (pc & 0xC)) >> 2);
+      pc = (pc | 0xF) + 1;
+   }
 
-	if(sub_op & 0x10)
-	 sub_op = 0x10 + (instr & 0x3F);
+   return cycles;
+}
 
-	//printf("COP0 thing: %02x\n", sub_op);
-	switch(sub_op)
+// Fetches [pc, end_pc) of cached code through the I-cache like the interpreter would.
+INLINE void PS_CPU::JIT_ICacheFetch(int32_t &timestamp, uint32_t pc, uint32_t end_pc)
+{
+   for(; pc < end_pc; pc += 4)
    {
-      default:
-         DO_LDS();
-         break;
+      if(psx_cpu_overclock)
+         ReadInstruction<true>(timestamp, pc);
+      else
+         ReadInstruction<false>(timestamp, pc);
+   }
+}
 
-      case 0x00:		// MFC0	- Move from Coprocessor
-         {
-            uint32 rt = (instr >> 16) & 0x1F;
-            uint32 rd = (instr >> 11) & 0x1F;
+void PS_CPU::JIT_Flush(void)
+{
+   unsigned i;
 
-            //printf("MFC0: rt=%d <- rd=%d(%08x)\n", rt, rd, CP0.Regs[rd]);
-            DO_LDS();
+   if(!JITBlocks)
+      return;
 
-            LDAbsorb = 0;
-            LDWhich = rt;
-            LDValue = CP0.Regs[rd];
-         }
-         break;
+   for(i = 0; i < JIT_BLOCK_TABLE_SIZE; i++)
+   {
+      free(JITBlocks[i]);
+      JITBlocks[i] = NULL;
+   }
 
-      case 0x04:		// MTC0	- Move to Coprocessor
-         {
-            uint32 rt = (instr >> 16) & 0x1F;
-            uint32 rd = (instr >> 11) & 0x1F;
-            uint32 val = GPR[rt];
+   JITStaleCount = 0;
+   decomp_reset();
+}
 
-            if(rd != CP0REG_PRID && rd != CP0REG_CAUSE && rd != CP0REG_SR && val)
-            {
-               PSX_WARNING("[CPU] Unimplemented MTC0: rt=%d(%08x) -> rd=%d", rt, GPR[rt], rd);
-            }
+PS_CPU::JITBlock *PS_CPU::JIT_Compile(uint32_t pc, unsigned index, unsigned inst_cycles)
+{
+   const uint32_t *code = (uint32_t *)&FastMap[pc >> FAST_MAP_SHIFT][pc];
+   const unsigned avail = (0x1000 - (pc & 0xFFF)) >> 2;
+   uint32_t insts[JIT_MAX_BLOCK_LENGTH + 1];
+   bool has_branch = false;
+   unsigned count = 0;
+   JITBlock *block;
+
+   if(JITBlocks[index])
+   {
+      free(JITBlocks[index]);
+      JITBlocks[index] = NULL;
 
-            switch(rd)
-            {
-               case CP0REG_BPC:
-                  CP0.BPC = val;
-                  break;
+      if(++JITStaleCount >= JIT_MAX_STALE_BLOCKS)
+         JIT_Flush();
+   }
 
-               case CP0REG_BDA:
-                  CP0.BDA = val;
-                  break;
+   while(count < avail && count < JIT_MAX_BLOCK_LENGTH)
+   {
+      const uint32_t instr = LoadU32_LE(&code[count]);
+      uint32_t ldr;
 
-               case CP0REG_TAR:
-                  CP0.TAR = val;
-                  break;
+      if(!JIT_CanTranslate(instr))
+         break;
 
-               case CP0REG_DCIC:
-                  CP0.DCIC = val & 0xFF80003F;
-                  break;
+      if(JIT_IsBranch(instr))
+      {
+         const uint32_t bpc = pc + (count << 2);
+         uint32_t delay;
 
-               case CP0REG_BDAM:
-                  CP0.BDAM = val;
-                  break;
+         if(count + 1 >= avail)
+            break;
 
-               case CP0REG_BPCM:
-                  CP0.BPCM = val;
-                  break;
+         delay = LoadU32_LE(&code[count + 1]);
 
-               case CP0REG_CAUSE:
-                  CP0.CAUSE &= ~(0x3 << 8);
-                  CP0.CAUSE |= val & (0x3 << 8);
-                  RecalcIPCache();
-                  break;
+         if(!JIT_CanTranslate(delay) || JIT_IsBranch(delay))
+            break;
 
-               case CP0REG_SR:
-                  if((CP0.SR ^ val) & 0x10000)
-                     PSX_DBG(PSX_DBG_SPARSE, "[CPU] IsC %u->%u\n", (bool)(CP0.SR & (1U << 16)), (bool)(val & (1U << 16)));
+         // A load in the delay slot must not feed the first instruction at either successor.
+         if((ldr = JIT_LoadTarget(delay)))
+         {
+            uint32_t target;
 
-                  CP0.SR = val & ~( (0x3 << 26) | (0x3 << 23) | (0x3 << 6));
-                  RecalcIPCache();
-                  break;
-            }
+            if(!JIT_BranchTarget(instr, bpc, &target) || (target & 3) || ((target ^ pc) & ~0xFFFU) || count + 2 >= avail)
+               break;
+
+            if(JIT_ReadsGPR(LoadU32_LE((uint32_t *)&FastMap[target >> FAST_MAP_SHIFT][target]), ldr) ||
+                  JIT_ReadsGPR(LoadU32_LE((uint32_t *)&FastMap[(bpc + 8) >> FAST_MAP_SHIFT][bpc + 8]), ldr))
+               break;
          }
-         DO_LDS();
-         break;
 
-      case (0x10 + 0x10):	// RFE
-         // "Pop"
-         DO_LDS();
-         CP0.SR = (CP0.SR & ~0x0F) | ((CP0.SR >> 2) & 0x0F);
-         RecalcIPCache();
+         insts[count] = instr;
+         insts[count + 1] = delay;
+         count += 2;
+         has_branch = true;
          break;
-   }
-    END_OPF;
+      }
+
+      if((ldr = JIT_LoadTarget(instr)))
+      {
+         const uint32_t npc = pc + ((count + 1) << 2);
+
+         if(count + 1 >= avail || JIT_ReadsGPR(LoadU32_LE((uint32_t *)&FastMap[npc >> FAST_MAP_SHIFT][npc]), ldr))
+            break;
+      }
+
+      insts[count++] = instr;
+   }
+
+   block = (JITBlock *)malloc(sizeof(JITBlock));
+   block->pc = pc;
+   block->end_pc = pc + (count << 2);
+   block->count = count ? count : 1;
+   block->inst_cycles = inst_cycles;
+   block->cycles = count * inst_cycles;
+   block->has_branch = has_branch;
+
+   block->fn = NULL;
+   if(count)
+      block->fn = decomp_translate(pc, insts, count, inst_cycles);
+
+   JITBlocks[index] = block;
+
+   if(index < (0x200000 >> 2))
+      PSX_MarkCodePage(index << 2);
+
+   return block;
+}
+
+void PS_CPU::JIT_InvalidatePage(uint32_t page_address)
+{
+   const unsigned first = page_address >> 2;
+   unsigned i;
+
+   for(i = first; i < first + 1024; i++)
+   {
+      if(JITBlocks[i])
+      {
+         free(JITBlocks[i]);
+         JITBlocks[i] = NULL;
+         JITStaleCount++;
+      }
+   }
+
+   // A block stored to its own page; leave it after the current instruction.
+   if(decomp_rt.exit == DECOMP_EXIT_NONE)
+      decomp_rt.exit = DECOMP_EXIT_SYNC;
+}
+
+INLINE void PS_CPU::JIT_CheckSync(void)
+{
+   if(decomp_rt.exit == DECOMP_EXIT_NONE && (IPCache || decomp_rt.timestamp >= next_event_ts))
+      decomp_rt.exit = DECOMP_EXIT_SYNC;
+}
+
+uint32_t PS_CPU::JIT_Load(uint32_t size, uint32_t address)
+{
+   uint32_t ret;
+
+   if(MDFN_UNLIKELY(address & ((size >> 3) - 1)))
+   {
+      decomp_rt.exit = DECOMP_EXIT_FAULT;
+      return 0;
+   }
+
+   // The full access latency is charged here, translated code doesn't absorb it.
+   if(size == 8)
+      ret = ReadMemory<uint8>(decomp_rt.timestamp, address);
+   else if(size == 16)
+      ret = ReadMemory<uint16>(decomp_rt.timestamp, address);
+   else
+      ret = ReadMemory<uint32>(decomp_rt.timestamp, address);
+
+   JIT_CheckSync();
+
+   return ret;
+}
+
+void PS_CPU::JIT_Store(uint32_t size, uint32_t address, uint32_t value)
+{
+   if(MDFN_UNLIKELY(address & ((size >> 3) - 1)))
+   {
+      decomp_rt.exit = DECOMP_EXIT_FAULT;
+      return;
+   }
+
+   if(size == 8)
+      WriteMemory<uint8>(decomp_rt.timestamp, address, value);
+   else if(size == 16)
+      WriteMemory<uint16>(decomp_rt.timestamp, address, value);
+   else
+      WriteMemory<uint32>(decomp_rt.timestamp, address, value);
+
+   JIT_CheckSync();
+}
+
+uint32_t PS_CPU::JIT_ReadGTE(bool control, unsigned reg)
+{
+   uint32_t ret;
+
+   if(decomp_rt.timestamp < gte_ts_done)
+      decomp_rt.timestamp = gte_ts_done;
+
+   ret = control ? GTE_ReadCR(reg) : GTE_ReadDR(reg);
+
+   JIT_CheckSync();
+
+   return ret;
+}
+
+void PS_CPU::JIT_WriteGTE(bool control, unsigned reg, uint32_t value)
+{
+   if(decomp_rt.timestamp < gte_ts_done)
+      decomp_rt.timestamp = gte_ts_done;
+
+   if(control)
+      GTE_WriteCR(reg, value);
+   else
+      GTE_WriteDR(reg, value);
+
+   JIT_CheckSync();
+}
+
+void PS_CPU::JIT_GTEInstruction(uint32_t instr)
+{
+   if(decomp_rt.timestamp < gte_ts_done)
+      decomp_rt.timestamp = gte_ts_done;
+
+   gte_ts_done = decomp_rt.timestamp + GTE_Instruction(instr);
+
+   JIT_CheckSync();
+}
+
+// Runs the block at PC if there's a usable one, and updates the interpreter's
+// PC state to where it left off.
+INLINE bool PS_CPU::JIT_Execute(int32_t &timestamp, uint32_t &PC, uint32_t &new_PC, uint32_t &new_PC_mask)
+{
+   const int index = JIT_BlockIndex(PC);
+   const uint32_t start_pc = PC;
+   unsigned inst_cycles;
+   unsigned icache_cycles = 0;
+   JITBlock *block;
+   uint32_t last_pc;
+   uint32_t end_pc;
+   bool has_branch;
+   bool cached;
+   bool stopped;
+
+   if(index < 0 || (PC & 3))
+      return false;
+
+   inst_cycles = JIT_InstCycles(PC);
+   block = JITBlocks[index];
+
+   if(!block || block->pc != PC || block->inst_cycles != inst_cycles)
+      block = JIT_Compile(PC, index, inst_cycles);
+
+   if(!block->fn)
+      return false;
+
+   // The block may be freed while it runs, if it writes to its own page.
+   end_pc = block->end_pc;
+   has_branch = block->has_branch;
+   cached = PC < 0xA0000000 && (BIU & 0x800);
+
+   if(cached)
+      icache_cycles = JIT_ICacheCycles(PC, end_pc);
+
+   if((timestamp + (int32_t)(block->cycles + icache_cycles)) > next_event_ts)
+      return false;
+
+   decomp_rt.timestamp = timestamp;
+   decomp_rt.exit = DECOMP_EXIT_NONE;
+   decomp_rt.branch_taken = 0;
+
+   block->fn(GPR);
+
+   timestamp = decomp_rt.timestamp;
+   last_pc = GPR[32];
+
+   if(decomp_rt.exit == DECOMP_EXIT_FAULT)
+   {
+      // Let the interpreter execute(and most likely raise an exception on) the instruction.
+      PC = last_pc;
+
+      if(cached)
+         JIT_ICacheFetch(timestamp, start_pc, last_pc);
+
+      if(has_branch && last_pc == (end_pc - 4) && decomp_rt.branch_taken)
+      {
+         new_PC = decomp_rt.branch_target;
+         new_PC_mask = 0;
+      }
+
+      IdleVisits = 0;
+
+      return true;
+   }
+
+   stopped = decomp_rt.exit == DECOMP_EXIT_SYNC && last_pc != (end_pc - 4);
+
+   if(cached)
+      JIT_ICacheFetch(timestamp, start_pc, stopped ? (last_pc + 4) : end_pc);
+
+   if(stopped)
+      PC = last_pc + 4;
+   else if(has_branch && decomp_rt.branch_taken)
+   {
+      PC = decomp_rt.branch_target;
+
+      if(psx_cpu_idle_skip)
+         IdleTransfer(end_pc - 4, PC);
+   }
+   else
+      PC = end_pc;
+
+   return true;
+}
+#endif
+
+#define BACKING_TO_ACTIVE			\
+	PC = BACKED_PC;				\
+	new_PC = BACKED_new_PC;			\
+	new_PC_mask = BACKED_new_PC_mask;	\
+	LDWhich = BACKED_LDWhich;		\
+	LDValue = BACKED_LDValue;
+
+#define ACTIVE_TO_BACKING			\
+	BACKED_PC = PC;				\
+	BACKED_new_PC = new_PC;			\
+	BACKED_new_PC_mask = new_PC_mask;	\
+	BACKED_LDWhich = LDWhich;		\
+	BACKED_LDValue = LDValue;
+
+#define GPR_DEPRES_BEGIN { uint8_t back = ReadAbsorb[0];
+#define GPR_DEP(n) { unsigned tn = (n); ReadAbsorb[tn] = 0; }
+#define GPR_RES(n) { unsigned tn = (n); ReadAbsorb[tn] = 0; }
+#define GPR_DEPRES_END ReadAbsorb[0] = back; }
+
+template<bool DebugMode, bool CachedInterp, bool Overclock, bool PGXP>
+int32_t PS_CPU::RunReal(int32_t timestamp_in)
+{
+   uint32_t PC;
+   uint32_t new_PC;
+   uint32_t new_PC_mask;
+   uint32_t LDWhich;
+   uint32_t LDValue;
+   int32_t timestamp = timestamp_in;
+   const CIOp *ci_op = NULL;
+   CIOp ci_tmp;
+
+   //printf("%d %d\n", gte_ts_done, muldiv_ts_done);
+
+   if(CachedInterp)
+      CIBase = ~0U;
+
+   gte_ts_done += timestamp;
+   muldiv_ts_done += timestamp;
+
+   BACKING_TO_ACTIVE;
+
+#ifdef HAVE_CPU_PROFILER
+   if(DebugMode)
+      PROF_Begin(timestamp);
+#endif
+
+   do
+   {
+      //printf("Running: %d %d\n", timestamp, next_event_ts);
+      while(MDFN_LIKELY(timestamp < next_event_ts))
+      {
+         uint32_t instr;
+         uint32_t opf;
+
+         // Zero must be zero...until the Master Plan is enacted.
+         GPR[0] = 0;
+
+#ifdef HAVE_DEBUG
+         if(DebugMode && CPUHook)
+         {
+            ACTIVE_TO_BACKING;
+
+            // For save states in step mode.
+            gte_ts_done -= timestamp;
+            muldiv_ts_done -= timestamp;
+
+            CPUHook(timestamp, PC);
+
+            // For save states in step mode.
+            gte_ts_done += timestamp;
+            muldiv_ts_done += timestamp;
+
+            BACKING_TO_ACTIVE;
+         }
+#endif
+
+         if(MDFN_UNLIKELY(PC == IdleHead) && !DebugMode && new_PC_mask == ~0U)
+         {
+            if(!psx_cpu_idle_skip)
+               IdleReset();
+            else if(IdleCheck(timestamp, LDWhich, LDValue))
+               continue;	// Back to the event check.
+         }
+
+         if(MDFN_UNLIKELY(psx_cpu_bios_hle) && !(PC & 0x1FFFFF0F) && !DebugMode && new_PC_mask == ~0U && LDWhich == 0x20 && !IPCache)
+         {
+            if(BIOS_HLE(timestamp, PC))
+               continue;
+         }
+
+#ifdef HAVE_JIT
+         if(!DebugMode && psx_cpu_core == CPU_CORE_DYNAREC && new_PC_mask == ~0U && LDWhich == 0x20 && !IPCache &&
+               !PGXP)
+         {
+            if(JIT_Execute(timestamp, PC, new_PC, new_PC_mask))
+               continue;
+         }
+#endif
+
+		 //
+		 // Instruction fetch
+		 //
+         if(MDFN_UNLIKELY(PC & 0x3))
+         {
+            // This will block interrupt processing, but since we're going more for keeping broken homebrew/hacks from working
+            // than super-duper-accurate pipeline emulation, it shouldn't be a problem.
+            new_PC = Exception(EXCEPTION_ADEL, PC, new_PC, new_PC_mask, 0);
+            new_PC_mask = 0;
+            goto OpDone;
+         }
+
+         if(CachedInterp)
+         {
+            // Fetched as usual, for the I-cache fills and their cost; the decoded form is only
+            // used while it's of the instruction fetched, which an I-cache line can hold on to
+            // after the code's been written.
+            instr = ReadInstruction<Overclock>(timestamp, PC);
+
+            if(MDFN_UNLIKELY((PC & ~0xFFFU) != CIBase) && !CI_Lookup(PC))
+               ci_op = NULL;	// Not in RAM or BIOS.
+            else
+               ci_op = &CICur[(PC & 0xFFF) >> 2];
+
+            if(MDFN_UNLIKELY(!ci_op || ci_op->instr != instr))
+            {
+               CI_Decode(&ci_tmp, instr);
+               ci_op = &ci_tmp;
+            }
+
+            opf = ci_op->opf | IPCache;
+         }
+         else
+         {
+            instr = ReadInstruction<Overclock>(timestamp, PC);
+
+            //printf("PC=%08x, SP=%08x - op=0x%02x - funct=0x%02x - instr=0x%08x\n", PC, GPR[29], instr >> 26, instr & 0x3F, instr);
+            //for(int i = 0; i < 32; i++)
+            // printf("%02x : %08x\n", i, GPR[i]);
+            //printf("\n");
+
+            //
+            // Instruction decode
+            //
+            opf = instr & 0x3F;
+
+            if(instr & (0x3F << 26))
+               opf = 0x40 | (instr >> 26);
+
+            opf |= IPCache;
+         }
+
+#ifdef HAVE_CPU_PROFILER
+         if(DebugMode)
+            PROF_Instruction(PC, instr, timestamp);
+#endif
+
+         if(ReadAbsorb[ReadAbsorbWhich])
+            ReadAbsorb[ReadAbsorbWhich]--;
+
+         else
+            timestamp++;
+
+   #define DO_LDS() { GPR[LDWhich] = LDValue; ReadAbsorb[LDWhich] = LDAbsorb; ReadFudge = LDWhich; ReadAbsorbWhich |= LDWhich & 0x1F; LDWhich = 0x20; }
+   #define BEGIN_OPF(name) { op_##name:
+   #define END_OPF goto OpDone; }
+
+   #define DO_BRANCH(offset, mask)			\
+	{						\
+	  PC = (PC & new_PC_mask) + new_PC;		\
+	 new_PC = (offset);				\
+	 new_PC_mask = (mask) & ~3;			\
+	 /* Lower bits of new_PC_mask being clear signifies being in a branch delay slot. (overloaded behavior for performance) */	\
+	 if(!DebugMode && psx_cpu_idle_skip)		\
+	  IdleTransfer(PC, (PC & new_PC_mask) + new_PC);	\
+	 goto SkipNPCStuff;				\
+	}
+
+
+   #define ITYPE uint32 rs MDFN_NOWARN_UNUSED = CachedInterp ? ci_op->rs : (instr >> 21) & 0x1F; uint32 rt MDFN_NOWARN_UNUSED = CachedInterp ? ci_op->rt : (instr >> 16) & 0x1F; uint32 immediate = CachedInterp ? ci_op->imm : (int32)(int16)(instr & 0xFFFF); /*printf(" rs=%02x(%08x), rt=%02x(%08x), immediate=(%08x) ", rs, GPR[rs], rt, GPR[rt], immediate);*/
+   #define ITYPE_ZE uint32 rs MDFN_NOWARN_UNUSED = CachedInterp ? ci_op->rs : (instr >> 21) & 0x1F; uint32 rt MDFN_NOWARN_UNUSED = CachedInterp ? ci_op->rt : (instr >> 16) & 0x1F; uint32 immediate = CachedInterp ? ci_op->imm : instr & 0xFFFF; /*printf(" rs=%02x(%08x), rt=%02x(%08x), immediate=(%08x) ", rs, GPR[rs], rt, GPR[rt], immediate);*/
+   #define JTYPE uint32 target = CachedInterp ? ci_op->imm : instr & ((1 << 26) - 1); /*printf(" target=(%08x) ", target);*/
+   #define RTYPE uint32 rs MDFN_NOWARN_UNUSED = CachedInterp ? ci_op->rs : (instr >> 21) & 0x1F; uint32 rt MDFN_NOWARN_UNUSED = CachedInterp ? ci_op->rt : (instr >> 16) & 0x1F; uint32 rd MDFN_NOWARN_UNUSED = CachedInterp ? ci_op->rd : (instr >> 11) & 0x1F; uint32 shamt MDFN_NOWARN_UNUSED = CachedInterp ? ci_op->imm : (instr >> 6) & 0x1F; /*printf(" rs=%02x(%08x), rt=%02x(%08x), rd=%02x(%08x) ", rs, GPR[rs], rt, GPR[rt], rd, GPR[rd]);*/
+
+#if !defined(__GNUC__) || defined(NO_COMPUTED_GOTO)
+   /* (uint8) cast for cheaper alternative to generated branch+compare bounds check instructions, but still more
+      expensive than computed goto which needs no masking nor bounds checking.
+   */
+   #define CGBEGIN { enum { CGESB = 1 + __COUNTER__ }; switch((uint8)opf) {
+   #define CGE(l) case __COUNTER__ - CGESB: goto l;
+   #define CGEND } }
+#else
+   #define CGBEGIN static const void *const op_goto_table[256] = {
+   #define CGE(l) &&l,
+   #define CGEND }; goto *op_goto_table[opf];
+#endif
+
+   CGBEGIN
+    CGE(op_SLL)  CGE(op_ILL)   CGE(op_SRL)  CGE(op_SRA)   CGE(op_SLLV)    CGE(op_ILL)   CGE(op_SRLV) CGE(op_SRAV)
+    CGE(op_JR)   CGE(op_JALR)  CGE(op_ILL)  CGE(op_ILL)   CGE(op_SYSCALL) CGE(op_BREAK) CGE(op_ILL)  CGE(op_ILL)
+    CGE(op_MFHI) CGE(op_MTHI)  CGE(op_MFLO) CGE(op_MTLO)  CGE(op_ILL)     CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)
+    CGE(op_MULT) CGE(op_MULTU) CGE(op_DIV)  CGE(op_DIVU)  CGE(op_ILL)     CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)
+    CGE(op_ADD)  CGE(op_ADDU)  CGE(op_SUB)  CGE(op_SUBU)  CGE(op_AND)     CGE(op_OR)    CGE(op_XOR)  CGE(op_NOR)
+    CGE(op_ILL)  CGE(op_ILL)   CGE(op_SLT)  CGE(op_SLTU)  CGE(op_ILL)     CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)
+    CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)     CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)
+    CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)     CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)
+
+    CGE(op_ILL)  CGE(op_BCOND) CGE(op_J)    CGE(op_JAL)   CGE(op_BEQ)  CGE(op_BNE) CGE(op_BLEZ) CGE(op_BGTZ)
+    CGE(op_ADDI) CGE(op_ADDIU) CGE(op_SLTI) CGE(op_SLTIU) CGE(op_ANDI) CGE(op_ORI) CGE(op_XORI) CGE(op_LUI)
+    CGE(op_COP0) CGE(op_COP1)  CGE(op_COP2) CGE(op_COP3)  CGE(op_ILL)  CGE(op_ILL) CGE(op_ILL)  CGE(op_ILL)
+    CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL)   CGE(op_ILL)  CGE(op_ILL) CGE(op_ILL)  CGE(op_ILL)
+    CGE(op_LB)   CGE(op_LH)    CGE(op_LWL)  CGE(op_LW)    CGE(op_LBU)  CGE(op_LHU) CGE(op_LWR)  CGE(op_ILL)
+    CGE(op_SB)   CGE(op_SH)    CGE(op_SWL)  CGE(op_SW)    CGE(op_ILL)  CGE(op_ILL) CGE(op_SWR)  CGE(op_ILL)
+    CGE(op_LWC0) CGE(op_LWC1)  CGE(op_LWC2) CGE(op_LWC3)  CGE(op_ILL)  CGE(op_ILL) CGE(op_ILL)  CGE(op_ILL)
+    CGE(op_SWC0) CGE(op_SWC1)  CGE(op_SWC2) CGE(op_SWC3)  CGE(op_ILL)  CGE(op_ILL) CGE(op_ILL)  CGE(op_ILL)
+
+    // Interrupt portion of this table is constructed so that an interrupt won't be taken when the PC is pointing to a GTE instruction,
+    // to avoid problems caused by pipeline vs coprocessor nuances that aren't emulated.
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+
+    CGE(op_ILL)       CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_COP2)      CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+    CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT) CGE(op_INTERRUPT)
+   CGEND
+
+   {
+    BEGIN_OPF(ILL);
+	     PSX_WARNING("[CPU] Unknown instruction @%08x = %08x, op=%02x, funct=%02x", PC, instr, instr >> 26, (instr & 0x3F));
+	     DO_LDS();
+	     new_PC = Exception(EXCEPTION_RI, PC, new_PC, new_PC_mask, instr);
+	     new_PC_mask = 0;
+    END_OPF;
+
+    //
+    // ADD - Add Word
+    //
+    BEGIN_OPF(ADD);
+	RTYPE;
+
+	GPR_DEPRES_BEGIN
+	GPR_DEP(rs);
+	GPR_DEP(rt);
+ 	GPR_RES(rd);
+	GPR_DEPRES_END
+
+	uint32 result = GPR[rs] + GPR[rt];
+	bool ep = ((~(GPR[rs] ^ GPR[rt])) & (GPR[rs] ^ result)) & 0x80000000;
+
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
+		PGXP_CPU_ADD(instr, result, GPR[rs], GPR[rt]);
+
+	DO_LDS();
+
+	if(MDFN_UNLIKELY(ep))
+	{
+	 new_PC = Exception(EXCEPTION_OV, PC, new_PC, new_PC_mask, instr);
+         new_PC_mask = 0;
+	}
+	else
+	 GPR[rd] = result;
+
+    END_OPF;
+
+    //
+    // ADDI - Add Immediate Word
+    //
+    BEGIN_OPF(ADDI);
+	ITYPE;
+
+	GPR_DEPRES_BEGIN
+	GPR_DEP(rs);
+	GPR_RES(rt);
+	GPR_DEPRES_END
+
+        uint32 result = GPR[rs] + immediate;
+
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
+		PGXP_CPU_ADDI(instr, result, GPR[rs]);
+
+	bool ep = ((~(GPR[rs] ^ immediate)) & (GPR[rs] ^ result)) & 0x80000000;
+
+	
+
+	DO_LDS();
+
+        if(MDFN_UNLIKELY(ep))
+	{
+	 new_PC = Exception(EXCEPTION_OV, PC, new_PC, new_PC_mask, instr);
+         new_PC_mask = 0;
+	}
+        else
+         GPR[rt] = result;
+
+    END_OPF;
+
+    //
+    // ADDIU, ADDU, AND, ANDI, LUI, NOR, OR, ORI, SLL, SLLV, SLT, SLTI, SLTIU, SLTU, SRA, SRAV, SRL, SRLV,
+    // SUBU, XOR, XORI; generated from insts.td by generator.py.
+    //
+    #include "cpu_alu.inc"
+
+    //
+    // BEQ - Branch on Equal
+    //
+    BEGIN_OPF(BEQ);
+	ITYPE;
+
+	GPR_DEPRES_BEGIN
+	GPR_DEP(rs);
+	GPR_DEP(rt);
+	GPR_DEPRES_END
+
+	bool result = (GPR[rs] == GPR[rt]);
+
+	DO_LDS();
+
+	if(result)
+	{
+	 DO_BRANCH((immediate << 2), ~0U);
+	}
+    END_OPF;
+
+    // Bah, why does MIPS encoding have to be funky like this. :(
+    // Handles BGEZ, BGEZAL, BLTZ, BLTZAL
+    BEGIN_OPF(BCOND);
+	const uint32 tv = GPR[(instr >> 21) & 0x1F];
+	uint32 riv = (instr >> 16) & 0x1F;
+	uint32 immediate = (int32)(int16)(instr & 0xFFFF);
+	bool result = (int32)(tv ^ (riv << 31)) < 0;
+	const uint32 link = ((riv & 0x1E) == 0x10) ? 31 : 0;
+
+	GPR_DEPRES_BEGIN
+	GPR_DEP((instr >> 21) & 0x1F);
+ 	GPR_RES(link);
+	GPR_DEPRES_END
+
+	DO_LDS();
+
+	if(link)	// Unconditional link reg setting.
+	 GPR[link] = PC + 8;
+
+        if(result)
+	{
+	 DO_BRANCH((immediate << 2), ~0U);
+	}
+
+    END_OPF;
+
+
+    //
+    // BGTZ - Branch on Greater than Zero
+    //
+    BEGIN_OPF(BGTZ);
+	ITYPE;
+
+	GPR_DEPRES_BEGIN
+	GPR_DEP(rs);
+	GPR_DEPRES_END
+
+	bool result = (int32)GPR[rs] > 0;
+
+	DO_LDS();
+
+	if(result)
+	{
+	 DO_BRANCH((immediate << 2), ~0U);
+	}
+    END_OPF;
+
+    //
+    // BLEZ - Branch on Less Than or Equal to Zero
+    //
+    BEGIN_OPF(BLEZ);
+	ITYPE;
+
+	GPR_DEPRES_BEGIN
+	GPR_DEP(rs);
+	GPR_DEPRES_END
+
+	bool result = (int32)GPR[rs] <= 0;
+
+	DO_LDS();
+
+	if(result)
+	{
+	 DO_BRANCH((immediate << 2), ~0U);
+	}
+
+    END_OPF;
+
+    //
+    // BNE - Branch on Not Equal
+    //
+    BEGIN_OPF(BNE);
+	ITYPE;
+
+	GPR_DEPRES_BEGIN
+	GPR_DEP(rs);
+	GPR_DEP(rt);
+	GPR_DEPRES_END
+
+	bool result = GPR[rs] != GPR[rt];
+
+	DO_LDS();
+
+	if(result)
+	{
+	 DO_BRANCH((immediate << 2), ~0U);
+	}
+
+    END_OPF;
+
+    //
+    // BREAK - Breakpoint
+    //
+    BEGIN_OPF(BREAK);
+	PSX_WARNING("[CPU] BREAK BREAK BREAK BREAK DAAANCE -- PC=0x%08x", PC);
+
+	DO_LDS();
+	new_PC = Exception(EXCEPTION_BP, PC, new_PC, new_PC_mask, instr);
+        new_PC_mask = 0;
+    END_OPF;
+
+    // Cop "instructions":	CFCz(no CP0), COPz, CTCz(no CP0), LWCz(no CP0), MFCz, MTCz, SWCz(no CP0)
+    //
+    // COP0 instructions
+    BEGIN_OPF(COP0);
+	uint32 sub_op = (instr >> 21) & 0x1F;
+
+	if(sub_op & 0x10)
+	 sub_op = 0x10 + (instr & 0x3F);
+
+	//printf("COP0 thing: %02x\n", sub_op);
+	switch(sub_op)
+   {
+      default:
+         DO_LDS();
+         break;
+
+      case 0x00:		// MFC0	- Move from Coprocessor
+         {
+            uint32 rt = (instr >> 16) & 0x1F;
+            uint32 rd = (instr >> 11) & 0x1F;
+
+            //printf("MFC0: rt=%d <- rd=%d(%08x)\n", rt, rd, CP0.Regs[rd]);
+            DO_LDS();
+
+            LDAbsorb = 0;
+            LDWhich = rt;
+            LDValue = CP0.Regs[rd];
+         }
+         break;
+
+      case 0x04:		// MTC0	- Move to Coprocessor
+         {
+            uint32 rt = (instr >> 16) & 0x1F;
+            uint32 rd = (instr >> 11) & 0x1F;
+            uint32 val = GPR[rt];
+
+            if(rd != CP0REG_PRID && rd != CP0REG_CAUSE && rd != CP0REG_SR && val)
+            {
+               PSX_WARNING("[CPU] Unimplemented MTC0: rt=%d(%08x) -> rd=%d", rt, GPR[rt], rd);
+            }
+
+            switch(rd)
+            {
+               case CP0REG_BPC:
+                  CP0.BPC = val;
+                  break;
+
+               case CP0REG_BDA:
+                  CP0.BDA = val;
+                  break;
+
+               case CP0REG_TAR:
+                  CP0.TAR = val;
+                  break;
+
+               case CP0REG_DCIC:
+                  CP0.DCIC = val & 0xFF80003F;
+                  break;
+
+               case CP0REG_BDAM:
+                  CP0.BDAM = val;
+                  break;
+
+               case CP0REG_BPCM:
+                  CP0.BPCM = val;
+                  break;
+
+               case CP0REG_CAUSE:
+                  CP0.CAUSE &= ~(0x3 << 8);
+                  CP0.CAUSE |= val & (0x3 << 8);
+                  RecalcIPCache();
+                  break;
+
+               case CP0REG_SR:
+                  if((CP0.SR ^ val) & 0x10000)
+                     PSX_DBG(PSX_DBG_SPARSE, "[CPU] IsC %u->%u\n", (bool)(CP0.SR & (1U << 16)), (bool)(val & (1U << 16)));
+
+                  CP0.SR = val & ~( (0x3 << 26) | (0x3 << 23) | (0x3 << 6));
+                  RecalcIPCache();
+                  break;
+            }
+         }
+         DO_LDS();
+         break;
+
+      case (0x10 + 0x10):	// RFE
+         // "Pop"
+         DO_LDS();
+         CP0.SR = (CP0.SR & ~0x0F) | ((CP0.SR >> 2) & 0x0F);
+         RecalcIPCache();
+         break;
+   }
+    END_OPF;
 
     //
     // COP1
@@ -1088,7 +2047,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
             LDWhich = rt;
             LDValue = GTE_ReadDR(rd);
 
-			if (PGXP_GetModes() & PGXP_MODE_GTE)
+			if (PGXP && (PGXP_GetModes() & PGXP_MODE_GTE))
 				PGXP_GTE_MFC2(instr, LDValue, LDValue);
          }
          break;
@@ -1105,791 +2064,469 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
             //printf("GTE WriteDR: %d %d\n", rd, val);
             GTE_WriteDR(rd, val);
 
-			if (PGXP_GetModes() & PGXP_MODE_GTE)
-				PGXP_GTE_MTC2(instr, val, val);
-
-            DO_LDS();
-         }
-         break;
-
-      case 0x02:		// CFC2
-         {
-            uint32 rt = (instr >> 16) & 0x1F;
-            uint32 rd = (instr >> 11) & 0x1F;
-
-            DO_LDS();
-
-            if(timestamp < gte_ts_done)
-            {
-               LDAbsorb = gte_ts_done - timestamp;
-               timestamp = gte_ts_done;
-            }
-            else
-               LDAbsorb = 0;
-
-            LDWhich = rt;
-            LDValue = GTE_ReadCR(rd);
-
-			if (PGXP_GetModes() & PGXP_MODE_GTE)
-				PGXP_GTE_CFC2(instr, LDValue, LDValue);
-            //printf("GTE ReadCR: %d %d\n", rd, GPR[rt]);
-         }		
-         break;
-
-      case 0x06:		// CTC2
-         {
-            uint32 rt = (instr >> 16) & 0x1F;
-            uint32 rd = (instr >> 11) & 0x1F;
-            uint32 val = GPR[rt];
-
-            //printf("GTE WriteCR: %d %d\n", rd, val);
-
-            if(timestamp < gte_ts_done)
-               timestamp = gte_ts_done;
-
-            GTE_WriteCR(rd, val);		
-
-			if (PGXP_GetModes() & PGXP_MODE_GTE)
-				PGXP_GTE_CTC2(instr, val, val);
-
-            DO_LDS();
-         }
-         break;
-   }
-    END_OPF;
-
-    //
-    // COP3
-    //
-    BEGIN_OPF(COP3);
-	DO_LDS();
-        new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
-        new_PC_mask = 0;
-    END_OPF;
-
-    //
-    // LWC0
-    //
-    BEGIN_OPF(LWC0);
-	DO_LDS();
-        new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
-        new_PC_mask = 0;
-    END_OPF;
-
-    //
-    // LWC1
-    //
-    BEGIN_OPF(LWC1);
-	DO_LDS();
-        new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
-        new_PC_mask = 0;
-    END_OPF;
-
-    //
-    // LWC2
-    //
-    BEGIN_OPF(LWC2);
-        ITYPE;
-        uint32 address = GPR[rs] + immediate;
-
-	DO_LDS();
-
-        if(MDFN_UNLIKELY(address & 3))
-	{
-         new_PC = Exception(EXCEPTION_ADEL, PC, new_PC, new_PC_mask, instr);
-         new_PC_mask = 0;
-	}
-        else
-	{
-         if(timestamp < gte_ts_done)
-          timestamp = gte_ts_done;
-
-		 uint32_t value = ReadMemory<uint32>(timestamp, address, false, true);
-         GTE_WriteDR(rt, value);
-
-		 if (PGXP_GetModes() & PGXP_MODE_GTE)
-			 PGXP_GTE_LWC2(instr, value, address);
-	}
-
-	// GTE stuff here
-    END_OPF;
-
-    //
-    // LWC3
-    //
-    BEGIN_OPF(LWC3);
-	DO_LDS();
-        new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
-        new_PC_mask = 0;
-    END_OPF;
-
-
-    //
-    // SWC0
-    //
-    BEGIN_OPF(SWC0);
-	DO_LDS();
-	new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
-        new_PC_mask = 0;
-    END_OPF;
-
-    //
-    // SWC1
-    //
-    BEGIN_OPF(SWC1);
-	DO_LDS();
-        new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
-        new_PC_mask = 0;
-    END_OPF;
-
-    //
-    // SWC2
-    //
-    BEGIN_OPF(SWC2);
-        ITYPE;
-        uint32 address = GPR[rs] + immediate;
-
-	if(MDFN_UNLIKELY(address & 0x3))
-	{
-	 new_PC = Exception(EXCEPTION_ADES, PC, new_PC, new_PC_mask, instr);
-         new_PC_mask = 0;
-	}
-	else
-	{
-         if(timestamp < gte_ts_done)
-          timestamp = gte_ts_done;
-
-	 WriteMemory<uint32>(timestamp, address, GTE_ReadDR(rt));
-
-	 if (PGXP_GetModes() & PGXP_MODE_GTE)
-		 PGXP_GTE_SWC2(instr, GTE_ReadDR(rt), address);
-	}
-
-	DO_LDS();
-    END_OPF;
-
-    //
-    // SWC3
-    ///
-    BEGIN_OPF(SWC3);
-	DO_LDS();
-        new_PC = Exception(EXCEPTION_RI, PC, new_PC, new_PC_mask, instr);
-        new_PC_mask = 0;
-    END_OPF;
-
-
-    //
-    // DIV - Divide Word
-    //
-    BEGIN_OPF(DIV);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-        if(!GPR[rt])
-        {
-           if(GPR[rs] & 0x80000000)
-              LO = 1;
-           else
-              LO = 0xFFFFFFFF;
-
-           HI = GPR[rs];
-        }
-        else if(GPR[rs] == 0x80000000 && GPR[rt] == 0xFFFFFFFF)
-        {
-           LO = 0x80000000;
-           HI = 0;
-        }
-        else
-        {
-           LO = (int32)GPR[rs] / (int32)GPR[rt];
-           HI = (int32)GPR[rs] % (int32)GPR[rt];
-        }
-	muldiv_ts_done = timestamp + 37;
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_DIV(instr, HI, LO, GPR[rs], GPR[rt]);
-
-	DO_LDS();
-
-    END_OPF;
-
-    // DIVU - Divide Unsigned Word
-    BEGIN_OPF(DIVU);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-	if(!GPR[rt])
-	{
-	 LO = 0xFFFFFFFF;
-	 HI = GPR[rs];
-	}
-	else
-	{
-	 LO = GPR[rs] / GPR[rt];
-	 HI = GPR[rs] % GPR[rt];
-	}
- 	muldiv_ts_done = timestamp + 37;
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_DIVU(instr, HI, LO, GPR[rs], GPR[rt]);
-
-	DO_LDS();
-    END_OPF;
-
-    //
-    // J - Jump
-    //
-    BEGIN_OPF(J);
-	JTYPE;
-
-	DO_LDS();
-
-	DO_BRANCH(target << 2, 0xF0000000);
-    END_OPF;
-
-    //
-    // JAL - Jump and Link
-    //
-    BEGIN_OPF(JAL);
-	JTYPE;
+			if (PGXP && (PGXP_GetModes() & PGXP_MODE_GTE))
+				PGXP_GTE_MTC2(instr, val, val);
 
-	//GPR_DEPRES_BEGIN
-	GPR_RES(31);
-	//GPR_DEPRES_END
+            DO_LDS();
+         }
+         break;
 
-	DO_LDS();
+      case 0x02:		// CFC2
+         {
+            uint32 rt = (instr >> 16) & 0x1F;
+            uint32 rd = (instr >> 11) & 0x1F;
 
-	GPR[31] = PC + 8;
+            DO_LDS();
 
-	DO_BRANCH(target << 2, 0xF0000000);
-    END_OPF;
+            if(timestamp < gte_ts_done)
+            {
+               LDAbsorb = gte_ts_done - timestamp;
+               timestamp = gte_ts_done;
+            }
+            else
+               LDAbsorb = 0;
 
-    //
-    // JALR - Jump and Link Register
-    //
-    BEGIN_OPF(JALR);
-	RTYPE;
+            LDWhich = rt;
+            LDValue = GTE_ReadCR(rd);
 
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
- 	GPR_RES(rd);
-	GPR_DEPRES_END
+			if (PGXP && (PGXP_GetModes() & PGXP_MODE_GTE))
+				PGXP_GTE_CFC2(instr, LDValue, LDValue);
+            //printf("GTE ReadCR: %d %d\n", rd, GPR[rt]);
+         }		
+         break;
 
-	uint32 tmp = GPR[rs];
+      case 0x06:		// CTC2
+         {
+            uint32 rt = (instr >> 16) & 0x1F;
+            uint32 rd = (instr >> 11) & 0x1F;
+            uint32 val = GPR[rt];
 
-	DO_LDS();
+            //printf("GTE WriteCR: %d %d\n", rd, val);
 
-	GPR[rd] = PC + 8;
+            if(timestamp < gte_ts_done)
+               timestamp = gte_ts_done;
 
-	DO_BRANCH(tmp, 0);
+            GTE_WriteCR(rd, val);		
 
+			if (PGXP && (PGXP_GetModes() & PGXP_MODE_GTE))
+				PGXP_GTE_CTC2(instr, val, val);
+
+            DO_LDS();
+         }
+         break;
+   }
     END_OPF;
 
     //
-    // JR - Jump Register
+    // COP3
     //
-    BEGIN_OPF(JR);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
- 	GPR_RES(rd);
-	GPR_DEPRES_END
-
-	uint32 bt = GPR[rs];
-
+    BEGIN_OPF(COP3);
 	DO_LDS();
-
-	DO_BRANCH(bt, 0);
-
+        new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
+        new_PC_mask = 0;
     END_OPF;
 
     //
-    // LUI - Load Upper Immediate
+    // LWC0
     //
-    BEGIN_OPF(LUI);
-	ITYPE_ZE;		// Actually, probably would be sign-extending...if we were emulating a 64-bit MIPS chip :b
-
-	GPR_DEPRES_BEGIN
-	GPR_RES(rt);
-	GPR_DEPRES_END
-
+    BEGIN_OPF(LWC0);
 	DO_LDS();
-
-	GPR[rt] = immediate << 16;
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_LUI(instr, GPR[rt]);
-
+        new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
+        new_PC_mask = 0;
     END_OPF;
 
     //
-    // MFHI - Move from HI
+    // LWC1
     //
-    BEGIN_OPF(MFHI);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
- 	GPR_RES(rd);
-	GPR_DEPRES_END
-
+    BEGIN_OPF(LWC1);
 	DO_LDS();
-
-	if(timestamp < muldiv_ts_done)
-	{
-	 if(timestamp == muldiv_ts_done - 1)
-	  muldiv_ts_done--;
-	 else
-	 {
-	  do
-	  {
-	   if(ReadAbsorb[ReadAbsorbWhich])
-	    ReadAbsorb[ReadAbsorbWhich]--;
-	   timestamp++;
-	  } while(timestamp < muldiv_ts_done);
-	 }
-	}
-
-	GPR[rd] = HI;
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_MFHI(instr, GPR[rd], HI);
-
+        new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
+        new_PC_mask = 0;
     END_OPF;
 
-
     //
-    // MFLO - Move from LO
+    // LWC2
     //
-    BEGIN_OPF(MFLO);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
- 	GPR_RES(rd);
-	GPR_DEPRES_END
+    BEGIN_OPF(LWC2);
+        ITYPE;
+        uint32 address = GPR[rs] + immediate;
 
 	DO_LDS();
 
-	if(timestamp < muldiv_ts_done)
+        if(MDFN_UNLIKELY(address & 3))
 	{
-	 if(timestamp == muldiv_ts_done - 1)
-	  muldiv_ts_done--;
-	 else
-	 {
-	  do
-	  {
-	   if(ReadAbsorb[ReadAbsorbWhich])
-	    ReadAbsorb[ReadAbsorbWhich]--;
-	   timestamp++;
-	  } while(timestamp < muldiv_ts_done);
-	 }
+         new_PC = Exception(EXCEPTION_ADEL, PC, new_PC, new_PC_mask, instr);
+         new_PC_mask = 0;
 	}
+        else
+	{
+         if(timestamp < gte_ts_done)
+          timestamp = gte_ts_done;
 
-	GPR[rd] = LO;
+		 uint32_t value = ReadMemory<uint32>(timestamp, address, false, true);
+         GTE_WriteDR(rt, value);
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_MFLO(instr, GPR[rd], LO);
+		 if (PGXP && (PGXP_GetModes() & PGXP_MODE_GTE))
+			 PGXP_GTE_LWC2(instr, value, address);
+	}
 
+	// GTE stuff here
     END_OPF;
 
-
     //
-    // MTHI - Move to HI
+    // LWC3
     //
-    BEGIN_OPF(MTHI);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEPRES_END
-
-	HI = GPR[rs];
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_MTHI(instr, HI, GPR[rs]);
-
+    BEGIN_OPF(LWC3);
 	DO_LDS();
-
+        new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
+        new_PC_mask = 0;
     END_OPF;
 
+
     //
-    // MTLO - Move to LO
+    // SWC0
     //
-    BEGIN_OPF(MTLO);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEPRES_END
-
-	LO = GPR[rs];
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_MTLO(instr, LO, GPR[rs]);
-
+    BEGIN_OPF(SWC0);
 	DO_LDS();
-
+	new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
+        new_PC_mask = 0;
     END_OPF;
 
-
     //
-    // MULT - Multiply Word
+    // SWC1
     //
-    BEGIN_OPF(MULT);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
-
-	uint64 result;
-
-	result = (int64)(int32)GPR[rs] * (int32)GPR[rt];
-	muldiv_ts_done = timestamp + MULT_Tab24[MDFN_lzcount32((GPR[rs] ^ ((int32)GPR[rs] >> 31)) | 0x400)];
+    BEGIN_OPF(SWC1);
 	DO_LDS();
-
-	LO = result;
-	HI = result >> 32;
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_MULT(instr, HI, LO, GPR[rs], GPR[rt]);
-
+        new_PC = Exception(EXCEPTION_COPU, PC, new_PC, new_PC_mask, instr);
+        new_PC_mask = 0;
     END_OPF;
 
     //
-    // MULTU - Multiply Unsigned Word
+    // SWC2
     //
-    BEGIN_OPF(MULTU);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
-	GPR_DEPRES_END
+    BEGIN_OPF(SWC2);
+        ITYPE;
+        uint32 address = GPR[rs] + immediate;
 
-	uint64 result;
+	if(MDFN_UNLIKELY(address & 0x3))
+	{
+	 new_PC = Exception(EXCEPTION_ADES, PC, new_PC, new_PC_mask, instr);
+         new_PC_mask = 0;
+	}
+	else
+	{
+         if(timestamp < gte_ts_done)
+          timestamp = gte_ts_done;
 
-	result = (uint64)GPR[rs] * GPR[rt];
-	muldiv_ts_done = timestamp + MULT_Tab24[MDFN_lzcount32(GPR[rs] | 0x400)];
-	DO_LDS();
+	 WriteMemory<uint32>(timestamp, address, GTE_ReadDR(rt));
 
-	LO = result;
-	HI = result >> 32;
+	 if (PGXP && (PGXP_GetModes() & PGXP_MODE_GTE))
+		 PGXP_GTE_SWC2(instr, GTE_ReadDR(rt), address);
+	}
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_MULTU(instr, HI, LO, GPR[rs], GPR[rt]);
+	DO_LDS();
+    END_OPF;
 
+    //
+    // SWC3
+    ///
+    BEGIN_OPF(SWC3);
+	DO_LDS();
+        new_PC = Exception(EXCEPTION_RI, PC, new_PC, new_PC_mask, instr);
+        new_PC_mask = 0;
     END_OPF;
 
 
     //
-    // NOR - NOR
+    // DIV - Divide Word
     //
-    BEGIN_OPF(NOR);
+    BEGIN_OPF(DIV);
 	RTYPE;
 
 	GPR_DEPRES_BEGIN
 	GPR_DEP(rs);
 	GPR_DEP(rt);
- 	GPR_RES(rd);
 	GPR_DEPRES_END
 
-	uint32 result = ~(GPR[rs] | GPR[rt]);
+        if(!GPR[rt])
+        {
+           if(GPR[rs] & 0x80000000)
+              LO = 1;
+           else
+              LO = 0xFFFFFFFF;
+
+           HI = GPR[rs];
+        }
+        else if(GPR[rs] == 0x80000000 && GPR[rt] == 0xFFFFFFFF)
+        {
+           LO = 0x80000000;
+           HI = 0;
+        }
+        else
+        {
+           LO = (int32)GPR[rs] / (int32)GPR[rt];
+           HI = (int32)GPR[rs] % (int32)GPR[rt];
+        }
+	muldiv_ts_done = timestamp + 37;
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_NOR(instr, result, GPR[rs], GPR[rt]);
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
+		PGXP_CPU_DIV(instr, HI, LO, GPR[rs], GPR[rt]);
 
 	DO_LDS();
 
-	GPR[rd] = result;
-
     END_OPF;
 
-    //
-    // OR - OR
-    //
-    BEGIN_OPF(OR);
+    // DIVU - Divide Unsigned Word
+    BEGIN_OPF(DIVU);
 	RTYPE;
 
 	GPR_DEPRES_BEGIN
 	GPR_DEP(rs);
 	GPR_DEP(rt);
- 	GPR_RES(rd);
 	GPR_DEPRES_END
 
-	uint32 result = GPR[rs] | GPR[rt];
+	if(!GPR[rt])
+	{
+	 LO = 0xFFFFFFFF;
+	 HI = GPR[rs];
+	}
+	else
+	{
+	 LO = GPR[rs] / GPR[rt];
+	 HI = GPR[rs] % GPR[rt];
+	}
+ 	muldiv_ts_done = timestamp + 37;
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_OR(instr, result, GPR[rs], GPR[rt]);
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
+		PGXP_CPU_DIVU(instr, HI, LO, GPR[rs], GPR[rt]);
 
 	DO_LDS();
-
-	GPR[rd] = result;
-
     END_OPF;
 
-
     //
-    // ORI - OR Immediate
+    // J - Jump
     //
-    BEGIN_OPF(ORI);
-	ITYPE_ZE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_RES(rt);
-	GPR_DEPRES_END
-
-	uint32 result = GPR[rs] | immediate;
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_ORI(instr, result, GPR[rs]);
+    BEGIN_OPF(J);
+	JTYPE;
 
 	DO_LDS();
 
-	GPR[rt] = result;
-
+	DO_BRANCH(target << 2, 0xF0000000);
     END_OPF;
 
-
     //
-    // SLL - Shift Word Left Logical
+    // JAL - Jump and Link
     //
-    BEGIN_OPF(SLL);	// SLL
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rt);
- 	GPR_RES(rd);
-	GPR_DEPRES_END
-
-	uint32 result = GPR[rt] << shamt;
+    BEGIN_OPF(JAL);
+	JTYPE;
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_SLL(instr, result, GPR[rt]);
+	//GPR_DEPRES_BEGIN
+	GPR_RES(31);
+	//GPR_DEPRES_END
 
 	DO_LDS();
 
-	GPR[rd] = result;
+	GPR[31] = PC + 8;
 
+	DO_BRANCH(target << 2, 0xF0000000);
     END_OPF;
 
-
     //
-    // SLLV - Shift Word Left Logical Variable
+    // JALR - Jump and Link Register
     //
-    BEGIN_OPF(SLLV);
+    BEGIN_OPF(JALR);
 	RTYPE;
 
 	GPR_DEPRES_BEGIN
 	GPR_DEP(rs);
-	GPR_DEP(rt);
  	GPR_RES(rd);
 	GPR_DEPRES_END
 
-	uint32 result = GPR[rt] << (GPR[rs] & 0x1F);
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_SLLV(instr, result, GPR[rt], GPR[rs]);
+	uint32 tmp = GPR[rs];
 
 	DO_LDS();
 
-	GPR[rd] = result;
+	GPR[rd] = PC + 8;
+
+	DO_BRANCH(tmp, 0);
 
     END_OPF;
 
     //
-    // SLT - Set on Less Than
+    // JR - Jump Register
     //
-    BEGIN_OPF(SLT);
+    BEGIN_OPF(JR);
 	RTYPE;
 
 	GPR_DEPRES_BEGIN
 	GPR_DEP(rs);
-	GPR_DEP(rt);
  	GPR_RES(rd);
 	GPR_DEPRES_END
 
-	uint32 result = (bool)((int32)GPR[rs] < (int32)GPR[rt]);
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_SLT(instr, result, GPR[rs], GPR[rt]);
+	uint32 bt = GPR[rs];
 
 	DO_LDS();
 
-	GPR[rd] = result;
+	DO_BRANCH(bt, 0);
 
     END_OPF;
 
-
     //
-    // SLTI - Set on Less Than Immediate
+    // MFHI - Move from HI
     //
-    BEGIN_OPF(SLTI);
-	ITYPE;
+    BEGIN_OPF(MFHI);
+	RTYPE;
 
 	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_RES(rt);
+ 	GPR_RES(rd);
 	GPR_DEPRES_END
 
-	uint32 result = (bool)((int32)GPR[rs] < (int32)immediate);
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_SLTI(instr, result, GPR[rs]);
-
 	DO_LDS();
 
-	GPR[rt] = result;
-
-    END_OPF;
-
-
-    //
-    // SLTIU - Set on Less Than Immediate, Unsigned
-    //
-    BEGIN_OPF(SLTIU);
-	ITYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_RES(rt);
-	GPR_DEPRES_END
-
-	uint32 result = (bool)(GPR[rs] < (uint32)immediate);
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_SLTIU(instr, result, GPR[rs]);
+	if(timestamp < muldiv_ts_done)
+	{
+	 if(timestamp == muldiv_ts_done - 1)
+	  muldiv_ts_done--;
+	 else
+	 {
+	  do
+	  {
+	   if(ReadAbsorb[ReadAbsorbWhich])
+	    ReadAbsorb[ReadAbsorbWhich]--;
+	   timestamp++;
+	  } while(timestamp < muldiv_ts_done);
+	 }
+	}
 
-	DO_LDS();
+	GPR[rd] = HI;
 
-	GPR[rt] = result;
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
+		PGXP_CPU_MFHI(instr, GPR[rd], HI);
 
     END_OPF;
 
 
     //
-    // SLTU - Set on Less Than, Unsigned
+    // MFLO - Move from LO
     //
-    BEGIN_OPF(SLTU);
+    BEGIN_OPF(MFLO);
 	RTYPE;
 
 	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
  	GPR_RES(rd);
 	GPR_DEPRES_END
 
-	uint32 result = (bool)(GPR[rs] < GPR[rt]);
+	DO_LDS();
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_SLTU(instr, result, GPR[rs], GPR[rt]);
+	if(timestamp < muldiv_ts_done)
+	{
+	 if(timestamp == muldiv_ts_done - 1)
+	  muldiv_ts_done--;
+	 else
+	 {
+	  do
+	  {
+	   if(ReadAbsorb[ReadAbsorbWhich])
+	    ReadAbsorb[ReadAbsorbWhich]--;
+	   timestamp++;
+	  } while(timestamp < muldiv_ts_done);
+	 }
+	}
 
-	DO_LDS();
+	GPR[rd] = LO;
 
-	GPR[rd] = result;
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
+		PGXP_CPU_MFLO(instr, GPR[rd], LO);
 
     END_OPF;
 
 
     //
-    // SRA - Shift Word Right Arithmetic
+    // MTHI - Move to HI
     //
-    BEGIN_OPF(SRA);
+    BEGIN_OPF(MTHI);
 	RTYPE;
 
 	GPR_DEPRES_BEGIN
-	GPR_DEP(rt);
- 	GPR_RES(rd);
+	GPR_DEP(rs);
 	GPR_DEPRES_END
 
-	uint32 result = ((int32)GPR[rt]) >> shamt;
+	HI = GPR[rs];
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_SRA(instr, result, GPR[rt]);
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
+		PGXP_CPU_MTHI(instr, HI, GPR[rs]);
 
 	DO_LDS();
 
-	GPR[rd] = result;
-
     END_OPF;
 
-
     //
-    // SRAV - Shift Word Right Arithmetic Variable
+    // MTLO - Move to LO
     //
-    BEGIN_OPF(SRAV);
+    BEGIN_OPF(MTLO);
 	RTYPE;
 
 	GPR_DEPRES_BEGIN
 	GPR_DEP(rs);
-	GPR_DEP(rt);
- 	GPR_RES(rd);
 	GPR_DEPRES_END
 
-	uint32 result = ((int32)GPR[rt]) >> (GPR[rs] & 0x1F);
+	LO = GPR[rs];
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_SRAV(instr, result, GPR[rt], GPR[rs]);
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
+		PGXP_CPU_MTLO(instr, LO, GPR[rs]);
 
 	DO_LDS();
 
-	GPR[rd] = result;
-
     END_OPF;
 
 
     //
-    // SRL - Shift Word Right Logical
+    // MULT - Multiply Word
     //
-    BEGIN_OPF(SRL);
+    BEGIN_OPF(MULT);
 	RTYPE;
 
 	GPR_DEPRES_BEGIN
+	GPR_DEP(rs);
 	GPR_DEP(rt);
- 	GPR_RES(rd);
 	GPR_DEPRES_END
 
-	uint32 result = GPR[rt] >> shamt;
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_SRL(instr, result, GPR[rt]);
+	uint64 result;
 
+	result = (int64)(int32)GPR[rs] * (int32)GPR[rt];
+	muldiv_ts_done = timestamp + MULT_Tab24[MDFN_lzcount32((GPR[rs] ^ ((int32)GPR[rs] >> 31)) | 0x400)];
 	DO_LDS();
 
-	GPR[rd] = result;
+	LO = result;
+	HI = result >> 32;
+
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
+		PGXP_CPU_MULT(instr, HI, LO, GPR[rs], GPR[rt]);
 
     END_OPF;
 
     //
-    // SRLV - Shift Word Right Logical Variable
+    // MULTU - Multiply Unsigned Word
     //
-    BEGIN_OPF(SRLV);
+    BEGIN_OPF(MULTU);
 	RTYPE;
 
 	GPR_DEPRES_BEGIN
 	GPR_DEP(rs);
 	GPR_DEP(rt);
- 	GPR_RES(rd);
 	GPR_DEPRES_END
 
-	uint32 result = GPR[rt] >> (GPR[rs] & 0x1F);
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_SRLV(instr, result, GPR[rt], GPR[rs]);
+	uint64 result;
 
+	result = (uint64)GPR[rs] * GPR[rt];
+	muldiv_ts_done = timestamp + MULT_Tab24[MDFN_lzcount32(GPR[rs] | 0x400)];
 	DO_LDS();
 
-	GPR[rd] = result;
+	LO = result;
+	HI = result >> 32;
+
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
+		PGXP_CPU_MULTU(instr, HI, LO, GPR[rs], GPR[rt]);
 
     END_OPF;
 
@@ -1909,7 +2546,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
 	uint32 result = GPR[rs] - GPR[rt];
 	bool ep = (((GPR[rs] ^ GPR[rt])) & (GPR[rs] ^ result)) & 0x80000000;
 
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_CPU))
 		PGXP_CPU_SUB(instr, result, GPR[rs], GPR[rt]);
 
 	DO_LDS();
@@ -1925,30 +2562,6 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
     END_OPF;
 
 
-    //
-    // SUBU - Subtract Unsigned Word
-    //
-    BEGIN_OPF(SUBU); // SUBU
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
- 	GPR_RES(rd);
-	GPR_DEPRES_END
-
-	uint32 result = GPR[rs] - GPR[rt];
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_SUBU(instr, result, GPR[rs], GPR[rt]);
-
-	DO_LDS();
-
-	GPR[rd] = result;
-
-    END_OPF;
-
-
     //
     // SYSCALL
     //
@@ -1960,50 +2573,6 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
     END_OPF;
 
 
-    //
-    // XOR
-    //
-    BEGIN_OPF(XOR);
-	RTYPE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_DEP(rt);
- 	GPR_RES(rd);
-	GPR_DEPRES_END
-
-	uint32 result = GPR[rs] ^ GPR[rt];
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_XOR(instr, result, GPR[rs], GPR[rt]);
-
-	DO_LDS();
-
-	GPR[rd] = result;
-
-    END_OPF;
-
-    //
-    // XORI - Exclusive OR Immediate
-    //
-    BEGIN_OPF(XORI);
-	ITYPE_ZE;
-
-	GPR_DEPRES_BEGIN
-	GPR_DEP(rs);
-	GPR_RES(rt);
-	GPR_DEPRES_END
-
-	uint32 result = GPR[rs] ^ immediate;
-
-	if (PGXP_GetModes() & PGXP_MODE_CPU)
-		PGXP_CPU_XORI(instr, result, GPR[rs]);
-
-	DO_LDS();
-
-	GPR[rt] = result;
-    END_OPF;
-
     //
     // Memory access instructions(besides the coprocessor ones) follow:
     //
@@ -2028,7 +2597,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
 	LDWhich = rt;
 	LDValue = (int32)ReadMemory<int8>(timestamp, address);
 
-	if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 		PGXP_CPU_LB(instr, LDValue, address);
     END_OPF;
 
@@ -2052,7 +2621,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
         LDWhich = rt;
 	LDValue = ReadMemory<uint8>(timestamp, address);
 
-	if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 		PGXP_CPU_LBU(instr, LDValue, address);
     END_OPF;
 
@@ -2085,7 +2654,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
 	 LDWhich = rt;
          LDValue = (int32)ReadMemory<int16>(timestamp, address);
 	}
-	if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 		PGXP_CPU_LH(instr, LDValue, address);
     END_OPF;
 
@@ -2119,7 +2688,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
          LDValue = ReadMemory<uint16>(timestamp, address);
 	}
 
-	if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 		PGXP_CPU_LHU(instr, LDValue, address);
     END_OPF;
 
@@ -2154,7 +2723,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
          LDValue = ReadMemory<uint32>(timestamp, address);
 	}
 
-	if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 		PGXP_CPU_LW(instr, LDValue, address);
     END_OPF;
 
@@ -2173,7 +2742,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
 
 	WriteMemory<uint8>(timestamp, address, GPR[rt]);
 
-	if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 		PGXP_CPU_SB(instr, GPR[rt], address);
 
 	DO_LDS();
@@ -2200,7 +2769,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
 	else
 	 WriteMemory<uint16>(timestamp, address, GPR[rt]);
 
-	if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 		PGXP_CPU_SH(instr, GPR[rt], address);
 
 	DO_LDS();
@@ -2227,7 +2796,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
 	else
 	 WriteMemory<uint32>(timestamp, address, GPR[rt]);
 
-	if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 		PGXP_CPU_SW(instr, GPR[rt], address);
 
 	DO_LDS();
@@ -2275,7 +2844,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
          LDValue = (v & ~(0xFFFFFFFF << 0)) | (ReadMemory<uint32>(timestamp, address & ~3) << 0);
          break;
    }
-   if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+   if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 	   PGXP_CPU_LWL(instr, LDValue, address);
 
     END_OPF;
@@ -2308,7 +2877,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
          WriteMemory<uint32>(timestamp, address & ~3, GPR[rt] >> 0);
          break;
    }
-   if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+   if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 	   PGXP_CPU_SWL(instr, GPR[rt], address);
 
    DO_LDS();
@@ -2356,7 +2925,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
          break;
    }
 
-   if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+   if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 	   PGXP_CPU_LWR(instr, LDValue, address);
 
     END_OPF;
@@ -2390,7 +2959,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
          break;
    }
 
-	if (PGXP_GetModes() & PGXP_MODE_MEMORY)
+	if (PGXP && (PGXP_GetModes() & PGXP_MODE_MEMORY))
 		PGXP_CPU_SWR(instr, GPR[rt], address);
 
 	DO_LDS();
@@ -2433,6 +3002,11 @@ SkipNPCStuff:	;
    if(muldiv_ts_done > 0)
       muldiv_ts_done -= timestamp;
 
+#ifdef HAVE_CPU_PROFILER
+   if(DebugMode)
+      PROF_End(timestamp);
+#endif
+
    ACTIVE_TO_BACKING;
 
    return(timestamp);
@@ -2440,17 +3014,48 @@ SkipNPCStuff:	;
 
 int32_t PS_CPU::Run(int32_t timestamp_in)
 {
+   return((this->*RunFunc)(timestamp_in));
+}
+
+// Picks the RunReal() instance matching the current settings, so overclocking and PGXP cost
+// nothing per instruction when they're off.  Call again whenever the core, overclock or PGXP
+// options change.
+void PS_CPU::UpdateRunFunc(void)
+{
+   #define RUNREAL_MODES(d, c) { { &PS_CPU::RunReal<d, c, false, false>, &PS_CPU::RunReal<d, c, false, true> }, \
+                                 { &PS_CPU::RunReal<d, c, true, false>, &PS_CPU::RunReal<d, c, true, true> } }
+   static int32_t (PS_CPU::*const Interp[2][2])(int32_t) = RUNREAL_MODES(false, false);
+   static int32_t (PS_CPU::*const CachedInterp[2][2])(int32_t) = RUNREAL_MODES(false, true);
+#if defined(HAVE_DEBUG) || defined(HAVE_CPU_PROFILER)
+   static int32_t (PS_CPU::*const Debug[2][2])(int32_t) = RUNREAL_MODES(true, false);
+#endif
+   #undef RUNREAL_MODES
+   const bool pgxp = (PGXP_GetModes() & (PGXP_MODE_MEMORY | PGXP_MODE_CPU | PGXP_MODE_GTE)) != 0;
+
+#ifdef HAVE_CPU_PROFILER
+   // Instruction-by-instruction, so the profile sees everything; this overrides the core,
+   // idle skip and BIOS HLE options, see profiler.h.
+   RunFunc = Debug[psx_cpu_overclock][pgxp];
+   return;
+#endif
 #ifdef HAVE_DEBUG
    if(CPUHook || ADDBT)
-      return(RunReal<true>(timestamp_in));
+   {
+      RunFunc = Debug[psx_cpu_overclock][pgxp];
+      return;
+   }
 #endif
-   return(RunReal<false>(timestamp_in));
+   if(psx_cpu_core == CPU_CORE_CACHED_INTERPRETER)
+      RunFunc = CachedInterp[psx_cpu_overclock][pgxp];
+   else
+      RunFunc = Interp[psx_cpu_overclock][pgxp];
 }
 
 void PS_CPU::SetCPUHook(void (*cpuh)(const int32_t timestamp, uint32_t pc), void (*addbt)(uint32_t from, uint32_t to, bool exception))
 {
    ADDBT = addbt;
    CPUHook = cpuh;
+   UpdateRunFunc();
 }
 
 uint32_t PS_CPU::GetRegister(unsigned int which, char *special, const uint32_t special_len)
@@ -2568,6 +3173,8 @@ void PS_CPU::PokeMem32(uint32 A, uint32 V)
 // FIXME: should we breakpoint on an illegal address?  And with LWC2/SWC2 if CP2 isn't enabled?
 void PS_CPU::CheckBreakpoints(void (*callback)(bool write, uint32_t address, unsigned int len), uint32_t instr)
 {
+   const bool CachedInterp = false;	// For ITYPE
+   const CIOp *ci_op = NULL;
    uint32 opf;
 
    opf = instr & 0x3F;
@@ -3,6 +3,10 @@
 
 #include "gte.h"
 
+#ifdef HAVE_JIT
+#include "decomp.h"
+#endif
+
 #define FAST_MAP_SHIFT        16
 #define FAST_MAP_PSIZE        (1 << FAST_MAP_SHIFT)
 
@@ -43,6 +47,13 @@
 #define GSREG_CAUSE          38
 #define GSREG_EPC            39
 
+enum cpu_core_mode
+{
+   CPU_CORE_INTERPRETER = 0,
+   CPU_CORE_CACHED_INTERPRETER,
+   CPU_CORE_DYNAREC
+};
+
 class PS_CPU
 {
    public:
@@ -58,6 +69,7 @@ class PS_CPU
       }
 
       int32_t Run(int32_t timestamp_in);
+      void UpdateRunFunc(void);
 
       void Power(void);
 
@@ -72,11 +84,13 @@ class PS_CPU
 
       int StateAction(StateMem *sm, int load, int data_only);
 
+      void CI_Flush(void);
+
    private:
 
       uint32_t GPR[32 + 1];	// GPR[32] Used as dummy in load delay simulation(indexing past the end of real GPR)
+      uint32_t HI;		// HI and LO must directly follow GPR, translated blocks address them as GPR[33] and GPR[34].
       uint32_t LO;
-      uint32_t HI;
 
 
       uint32_t BACKED_PC;
@@ -152,14 +166,115 @@ class PS_CPU
 
       uint32_t Exception(uint32_t code, uint32_t PC, const uint32_t NP, const uint32_t NPM, const uint32_t instr) MDFN_WARN_UNUSED_RESULT;
 
-      template<bool DebugMode> int32_t RunReal(int32_t timestamp_in);
+      template<bool DebugMode, bool CachedInterp, bool Overclock, bool PGXP> int32_t RunReal(int32_t timestamp_in);
+      int32_t (PS_CPU::*RunFunc)(int32_t timestamp_in);
 
       template<typename T> T PeekMemory(uint32_t address) MDFN_COLD;
       template<typename T> void PokeMemory(uint32 address, T value) MDFN_COLD;
       template<typename T> T ReadMemory(int32_t &timestamp, uint32_t address, bool DS24 = false, bool LWC_timing = false);
       template<typename T> void WriteMemory(int32_t &timestamp, uint32_t address, uint32_t value, bool DS24 = false);
 
-      uint32 ReadInstruction(pscpu_timestamp_t &timestamp, uint32 address);
+      template<bool Overclock> uint32 ReadInstruction(pscpu_timestamp_t &timestamp, uint32 address);
+
+      //
+      // Cached interpreter: instructions are decoded once per 4KiB page of RAM/BIOS, and executed
+      // by RunReal<false, true, ...> from the decoded form.  Fetches still go through
+      // ReadInstruction(), so timing and the I-cache are the same as with the interpreter.
+      //
+      struct CIOp
+      {
+         uint32_t instr;
+         uint32_t imm;	// Immediate(extended the way the opcode wants it), jump target, or shift amount.
+         uint8_t opf;	// Index into RunReal()'s handler table, without IPCache.
+         uint8_t rs;
+         uint8_t rt;
+         uint8_t rd;
+      };
+
+      struct CIPage
+      {
+         bool valid;
+         CIOp ops[1024];
+      };
+
+      CIPage *CIPages[(0x200000 + 0x80000) >> 12];	// RAM(mirrors folded) then BIOS.
+      const CIOp *CICur;	// Decoded page CIBase maps to.
+      uint32_t CIBase;	// Virtual address of the current page, ~0U if none.
+
+      void CI_Decode(CIOp *op, uint32_t instr);
+      bool CI_Lookup(uint32_t pc);
+
+      // PSX_InvalidateCodePage() callback.
+      static void CodeInvalidated(void *data, uint32_t page_address);
+
+      //
+      // Idle loop skipping: a short loop that only computes and loads(from memory, or registers
+      // that can't change between events) is fast-forwarded to the next event, once two
+      // consecutive iterations have started from the same state.
+      //
+      struct IdleSnapshot
+      {
+         uint32_t GPR[32];
+         uint32_t LDWhich;
+         uint32_t LDValue;
+         uint32_t LDAbsorb;
+         uint8_t ReadAbsorb[0x20 + 1];
+         uint8_t ReadAbsorbWhich;
+         uint8_t ReadFudge;
+      };
+
+      uint32_t IdleHead;	// First instruction of the loop being watched, ~0U if none.
+      uint32_t IdleLen;		// Loop length in bytes, up to and including the back branch's delay slot.
+      uint32_t IdleReject;	// Last loop found unsuitable.
+      uint32_t IdleCode[16];
+      unsigned IdleVisits;	// Consecutive iterations since the loop was entered.
+      int32_t IdleTS;
+      int32_t IdleEventTS;
+      IdleSnapshot IdleSnap;
+
+      void IdleReset(void);
+      void IdleTransfer(uint32_t ds_pc, uint32_t target);
+      void IdleWatch(uint32_t head, uint32_t ds_pc);
+      bool IdleLoadsOK(const IdleSnapshot *snap);
+      bool IdleCheck(int32_t &timestamp, uint32_t LDWhich, uint32_t LDValue);
+
+      // Services A0h/B0h kernel calls natively(bios.cpp) when the BIOS HLE option is on.
+      bool BIOS_HLE(int32_t &timestamp, uint32_t &PC);
+
+#ifdef HAVE_JIT
+      struct JITBlock
+      {
+         decomp_block_fn fn;	// NULL if the instruction at pc can't be translated.
+         uint32_t pc;
+         uint32_t end_pc;
+         uint32_t count;
+         uint32_t inst_cycles;
+         uint32_t cycles;
+         bool has_branch;	// Last two instructions are a branch and its delay slot.
+      };
+
+      JITBlock **JITBlocks;	// Indexed by physical word address, RAM then BIOS.
+      unsigned JITStaleCount;
+
+      unsigned JIT_InstCycles(uint32_t pc);
+      unsigned JIT_ICacheCycles(uint32_t pc, uint32_t end_pc);
+      void JIT_ICacheFetch(int32_t &timestamp, uint32_t pc, uint32_t end_pc);
+      JITBlock *JIT_Compile(uint32_t pc, unsigned index, unsigned inst_cycles);
+      void JIT_InvalidatePage(uint32_t page_address);
+      bool JIT_Execute(int32_t &timestamp, uint32_t &PC, uint32_t &new_PC, uint32_t &new_PC_mask);
+      void JIT_CheckSync(void);
+
+   public:
+      // Called from translated blocks(decomp.cpp).
+      uint32_t JIT_Load(uint32_t size, uint32_t address);
+      void JIT_Store(uint32_t size, uint32_t address, uint32_t value);
+      uint32_t JIT_ReadGTE(bool control, unsigned reg);
+      void JIT_WriteGTE(bool control, unsigned reg, uint32_t value);
+      void JIT_GTEInstruction(uint32_t instr);
+
+      void JIT_Flush(void);
+   private:
+#endif
 
       // Mednafen debugger stuff follows:
    public:
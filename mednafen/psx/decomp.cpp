@@ -2,7 +2,10 @@
 #include <jit/jit.h>
 #include <stdint.h>
 
-// This is passed as an array of uint32_t
+#include "psx.h"
+#include "decomp.h"
+
+// Blocks are passed PS_CPU's GPR file as an array of uint32_t; see decomp.h.
 typedef struct state_s {
 	uint32_t reg[32];
 	uint32_t pc;
@@ -11,146 +14,277 @@ typedef struct state_s {
 
 bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t inst, bool &branched);
 
-jit_value_t _make_uint(jit_function_t func, uint32_t val) {
+struct decomp_runtime decomp_rt;
+
+static jit_context_t context;
+static jit_type_t sig_1, sig_2, sig_3, block_sig;
+
+static jit_value_t _make_uint(jit_function_t func, uint32_t val) {
 	return jit_value_create_nint_constant(func, jit_type_uint, val);
 }
 #define make_uint(val) _make_uint(func, (val))
 
-jit_type_t sig_1, sig_2, sig_3;
-void store_memory(int size, uint32_t ptr, uint32_t val) {
+static jit_value_t _make_ptr(jit_function_t func, void *ptr) {
+	return jit_value_create_nint_constant(func, jit_type_void_ptr, (jit_nint) ptr);
 }
+#define make_ptr(ptr) _make_ptr(func, (ptr))
 
-void call_store_memory(jit_function_t func, int size, jit_value_t ptr, jit_value_t val) {
-	jit_value_t args[] = {make_uint(size), ptr, val};
-	jit_insn_call_native(func, 0, (void *) store_memory, sig_3, args, 3, 0);
+static int32_t signext(int size, uint32_t imm) {
+	return ((int32_t) (imm << (32 - size))) >> (32 - size);
 }
 
-uint32_t load_memory(int size, uint32_t ptr) {
-	return 0;
+// Leaves the block, with the PC of the current instruction in state.
+static void emit_exit(jit_function_t func, uint32_t status) {
+	jit_insn_store_relative(func, make_ptr(&decomp_rt.exit), 0, make_uint(status));
+	jit_insn_return(func, NULL);
 }
 
-jit_value_t call_load_memory(jit_function_t func, int size, jit_value_t ptr) {
-	jit_value_t args[] = {make_uint(size), ptr};
-	return jit_insn_call_native(func, 0, (void *) load_memory, sig_2, args, 2, 0);
+// Leaves the block if a runtime helper reported a fault; must directly follow the helper call,
+// before any architectural state is written.
+static void emit_fault_check(jit_function_t func) {
+	jit_label_t ok = jit_label_undefined;
+	jit_value_t status = jit_insn_load_relative(func, make_ptr(&decomp_rt.exit), 0, jit_type_uint);
+	jit_insn_branch_if_not(func, jit_insn_eq(func, status, make_uint(DECOMP_EXIT_FAULT)), &ok);
+	jit_insn_return(func, NULL);
+	jit_insn_label(func, &ok);
 }
 
-uint32_t read_copreg(int cop, int reg) {
-	return 0;
+// Leaves the block after a completed instruction if a helper asked for it.
+static void emit_sync_check(jit_function_t func) {
+	jit_label_t ok = jit_label_undefined;
+	jit_value_t status = jit_insn_load_relative(func, make_ptr(&decomp_rt.exit), 0, jit_type_uint);
+	jit_insn_branch_if_not(func, status, &ok);
+	jit_insn_return(func, NULL);
+	jit_insn_label(func, &ok);
 }
 
-jit_value_t call_read_copreg(jit_function_t func, int cop, int reg) {
-	jit_value_t args[] = {make_uint(cop), make_uint(reg)};
-	return jit_insn_call_native(func, 0, (void *) read_copreg, sig_2, args, 2, 0);
+static void emit_timestamp_add(jit_function_t func, unsigned cycles) {
+	if(!cycles)
+		return;
+
+	jit_value_t ptr = make_ptr(&decomp_rt.timestamp);
+	jit_value_t ts = jit_insn_load_relative(func, ptr, 0, jit_type_int);
+	jit_insn_store_relative(func, ptr, 0, jit_insn_add(func, ts, jit_value_create_nint_constant(func, jit_type_int, cycles)));
 }
 
-uint32_t read_copcreg(int cop, int reg) {
+static uint32_t store_memory(uint32_t size, uint32_t ptr, uint32_t val) {
+	CPU->JIT_Store(size, ptr, val);
 	return 0;
 }
 
-jit_value_t call_read_copcreg(jit_function_t func, int cop, int reg) {
-	jit_value_t args[] = {make_uint(cop), make_uint(reg)};
-	return jit_insn_call_native(func, 0, (void *) read_copcreg, sig_2, args, 2, 0);
+static void call_store_memory(jit_function_t func, int size, jit_value_t ptr, jit_value_t val) {
+	jit_value_t args[] = {make_uint(size), ptr, val};
+	jit_insn_call_native(func, 0, (void *) store_memory, sig_3, args, 3, 0);
+	emit_fault_check(func);
 }
 
-void write_copreg(int cop, int reg, uint32_t val) {
+static uint32_t load_memory(uint32_t size, uint32_t ptr) {
+	return CPU->JIT_Load(size, ptr);
 }
 
-void call_write_copreg(jit_function_t func, int cop, int reg, jit_value_t val) {
-	jit_value_t args[] = {make_uint(cop), make_uint(reg), val};
-	jit_insn_call_native(func, 0, (void *) write_copreg, sig_3, args, 3, 0);
+static jit_value_t call_load_memory(jit_function_t func, int size, jit_value_t ptr) {
+	jit_value_t args[] = {make_uint(size), ptr};
+	jit_value_t ret = jit_insn_call_native(func, 0, (void *) load_memory, sig_2, args, 2, 0);
+	emit_fault_check(func);
+	return ret;
 }
 
-void write_copcreg(int cop, int reg, uint32_t val) {
+// Only the GTE is reachable from translated code; other coprocessor accesses are
+// left to the interpreter.
+static uint32_t read_gte(uint32_t control, uint32_t reg) {
+	return CPU->JIT_ReadGTE(control, reg);
+}
+
+static jit_value_t call_read_gte(jit_function_t func, int cop, int reg, bool control) {
+	if(cop != 2) {
+		emit_exit(func, DECOMP_EXIT_FAULT);
+		return make_uint(0);
+	}
+
+	jit_value_t args[] = {make_uint(control), make_uint(reg)};
+	return jit_insn_call_native(func, 0, (void *) read_gte, sig_2, args, 2, 0);
 }
 
-void call_write_copcreg(jit_function_t func, int cop, int reg, jit_value_t val) {
-	jit_value_t args[] = {make_uint(cop), make_uint(reg), val};
-	jit_insn_call_native(func, 0, (void *) write_copcreg, sig_3, args, 3, 0);
+static jit_value_t call_read_copreg(jit_function_t func, int cop, int reg) {
+	return call_read_gte(func, cop, reg, false);
 }
 
-void copfun(int cop, int cofun) {
+static jit_value_t call_read_copcreg(jit_function_t func, int cop, int reg) {
+	return call_read_gte(func, cop, reg, true);
 }
 
-jit_value_t call_copfun(jit_function_t func, int cop, int cofun) {
-	jit_value_t args[] = {make_uint(cop), make_uint(cofun)};
-	return jit_insn_call_native(func, 0, (void *) copfun, sig_2, args, 2, 0);
+static uint32_t write_gte(uint32_t control, uint32_t reg, uint32_t val) {
+	CPU->JIT_WriteGTE(control, reg, val);
+	return 0;
 }
 
-int32_t signext(int size, uint32_t imm) {
-	if(size == 8)
-		return (int32_t) ((int8_t) ((uint8_t) imm));
-	else if(size == 16)
-		return (int32_t) ((int16_t) ((uint16_t) imm));
-	return (int32_t) imm;
+static void call_write_gte(jit_function_t func, int cop, int reg, jit_value_t val, bool control) {
+	if(cop != 2) {
+		emit_exit(func, DECOMP_EXIT_FAULT);
+		return;
+	}
+
+	jit_value_t args[] = {make_uint(control), make_uint(reg), val};
+	jit_insn_call_native(func, 0, (void *) write_gte, sig_3, args, 3, 0);
 }
 
-jit_value_t call_signext(jit_function_t func, int size, jit_value_t val) {
-	jit_value_t args[] = {make_uint(size), val};
-	return jit_insn_call_native(func, 0, (void *) signext, sig_2, args, 2, 0);
+static void call_write_copreg(jit_function_t func, int cop, int reg, jit_value_t val) {
+	call_write_gte(func, cop, reg, val, false);
 }
 
-void syscall(int code) {
+static void call_write_copcreg(jit_function_t func, int cop, int reg, jit_value_t val) {
+	call_write_gte(func, cop, reg, val, true);
 }
 
-void call_syscall(jit_function_t func, uint32_t code) {
-	jit_value_t args[] = {make_uint(code)};
-	jit_insn_call_native(func, 0, (void *) syscall, sig_1, args, 1, 0);
+static uint32_t gte_instruction(uint32_t instr) {
+	CPU->JIT_GTEInstruction(instr);
+	return 0;
 }
 
-void break_(int code) {
+static void call_copfun(jit_function_t func, int cop, int cofun) {
+	if(cop != 2) {
+		emit_exit(func, DECOMP_EXIT_FAULT);
+		return;
+	}
+
+	jit_value_t args[] = {make_uint((0x12 << 26) | (1 << 25) | cofun)};
+	jit_insn_call_native(func, 0, (void *) gte_instruction, sig_1, args, 1, 0);
 }
 
-void call_break(jit_function_t func, uint32_t code) {
-	jit_value_t args[] = {make_uint(code)};
-	jit_insn_call_native(func, 0, (void *) break_, sig_1, args, 1, 0);
+static jit_value_t call_signext(jit_function_t func, int size, jit_value_t val) {
+	jit_value_t narrow = jit_insn_convert(func, val, size == 8 ? jit_type_sbyte : jit_type_short, 0);
+	return jit_insn_convert(func, narrow, jit_type_int, 0);
 }
 
-void branch(uint32_t target) {
+// Exceptions are raised by the interpreter, which re-executes the instruction.
+static void call_syscall(jit_function_t func, uint32_t code) {
+	emit_exit(func, DECOMP_EXIT_FAULT);
 }
 
-void call_branch(jit_function_t func, jit_value_t val) {
-	jit_value_t args[] = {val};
-	jit_insn_call_native(func, 0, (void *) branch, sig_1, args, 1, 0);
+static void call_break(jit_function_t func, uint32_t code) {
+	emit_exit(func, DECOMP_EXIT_FAULT);
 }
 
-void overflow(uint32_t a, uint32_t b, int dir) {
+static void call_branch(jit_function_t func, jit_value_t val) {
+	jit_insn_store_relative(func, make_ptr(&decomp_rt.branch_target), 0, val);
+	jit_insn_store_relative(func, make_ptr(&decomp_rt.branch_taken), 0, make_uint(1));
 }
 
-void call_overflow(jit_function_t func, jit_value_t a, jit_value_t b, int dir) {
-	jit_value_t args[] = {a, b, make_uint(dir)};
-	jit_insn_call_native(func, 0, (void *) overflow, sig_3, args, 3, 0);
+static void call_overflow(jit_function_t func, jit_value_t a, jit_value_t b, int dir) {
+	jit_label_t ok = jit_label_undefined;
+	jit_value_t result = dir > 0 ? jit_insn_add(func, a, b) : jit_insn_sub(func, a, b);
+	// Same test as the interpreter: operand signs agree (add) or differ (sub), and the result's sign differs from a.
+	jit_value_t ops = dir > 0 ? jit_insn_not(func, jit_insn_xor(func, a, b)) : jit_insn_xor(func, a, b);
+	jit_value_t ov = jit_insn_and(func, jit_insn_and(func, ops, jit_insn_xor(func, a, result)), make_uint(0x80000000));
+	jit_insn_branch_if_not(func, ov, &ok);
+	emit_exit(func, DECOMP_EXIT_FAULT);
+	jit_insn_label(func, &ok);
 }
 
+// Instructions whose translation calls back into the emulator (memory, GTE) or can fault.
+static bool needs_sync(uint32_t inst) {
+	const uint32_t op = inst >> 26;
 
-int main() {
-	bool branched = false;
-	auto context = jit_context_create();
-	jit_context_build_start(context);
+	if(op >= 0x20 || op == 0x12 || op == 0x08)
+		return true;
+
+	return op == 0 && ((inst & 0x3F) == 0x20 || (inst & 0x3F) == 0x22);
+}
+
+void decomp_init(void) {
+	jit_init();
+	context = jit_context_create();
 
 	jit_type_t s3params[3];
 	s3params[0] = jit_type_uint;
 	s3params[1] = jit_type_uint;
 	s3params[2] = jit_type_uint;
 	sig_3 = jit_type_create_signature(jit_abi_cdecl, jit_type_uint, s3params, 3, 1);
-	
+
 	jit_type_t sparams[2];
 	sparams[0] = jit_type_uint;
 	sparams[1] = jit_type_uint;
 	sig_2 = jit_type_create_signature(jit_abi_cdecl, jit_type_uint, sparams, 2, 1);
-	
-	jit_type_t lparams[2];
+
+	jit_type_t lparams[1];
 	lparams[0] = jit_type_uint;
 	sig_1 = jit_type_create_signature(jit_abi_cdecl, jit_type_uint, lparams, 1, 1);
-	
+
 	jit_type_t params[1];
 	params[0] = jit_type_create_pointer(jit_type_uint, 0);
-	auto signature = jit_type_create_signature(jit_abi_cdecl, jit_type_int, params, 1, 1);
+	block_sig = jit_type_create_signature(jit_abi_cdecl, jit_type_void, params, 1, 1);
+}
 
-	auto func = jit_function_create(context, signature);
-	auto statevar = jit_value_get_param(func, 0);
-	decompile(func, statevar, 0xDEADBEE0, 0x0, branched);
-	return 0;
+void decomp_kill(void) {
+	if(!context)
+		return;
+
+	jit_context_destroy(context);
+	context = NULL;
+
+	jit_type_free(sig_1);
+	jit_type_free(sig_2);
+	jit_type_free(sig_3);
+	jit_type_free(block_sig);
+}
+
+void decomp_reset(void) {
+	// libjit cannot free single functions, so drop the whole context.
+	if(context)
+		jit_context_destroy(context);
+	context = jit_context_create();
 }
+
+decomp_block_fn decomp_translate(uint32_t pc, const uint32_t *insts, unsigned count, unsigned inst_cycles) {
+	jit_function_t func;
+	jit_value_t state;
+	unsigned pending = 0;
+	void *closure;
+
+	jit_context_build_start(context);
+
+	func = jit_function_create(context, block_sig);
+	state = jit_value_get_param(func, 0);
+
+	for(unsigned i = 0; i < count; i++) {
+		const uint32_t inst = insts[i];
+		const bool sync = needs_sync(inst);
+		bool branched = false;
+
+		pending += inst_cycles;
+
+		// Helpers see the timestamp as of the current instruction.
+		if(sync) {
+			emit_timestamp_add(func, pending);
+			pending = 0;
+		}
+
+		if(!decompile(func, state, pc + i * 4, inst, branched)) {
+			emit_timestamp_add(func, pending);
+			jit_insn_store_relative(func, state, 32*4, make_uint(pc + i * 4));
+			emit_exit(func, DECOMP_EXIT_FAULT);
+			break;
+		}
+
+		if(sync)
+			emit_sync_check(func);
+	}
+
+	emit_timestamp_add(func, pending);
+	jit_insn_return(func, NULL);
+
+	if(!jit_function_compile(func)) {
+		jit_function_abandon(func);
+		jit_context_build_end(context);
+		return NULL;
+	}
+
+	jit_context_build_end(context);
+
+	closure = jit_function_to_closure(func);
+	return (decomp_block_fn) closure;
+}
+
 bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t inst, bool &branched) {
 	switch((inst) >> (0x1a)) {
 		case 0x0: {
@@ -161,7 +295,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
 					uint32_t shamt = ((inst) >> (0x6)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_shl(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, shamt))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_shl(func, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, shamt))); }
 					return(true);
 					break;
 				}
@@ -171,7 +305,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
 					uint32_t shamt = ((inst) >> (0x6)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_ushr(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, shamt))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_ushr(func, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, shamt))); }
 					return(true);
 					break;
 				}
@@ -181,7 +315,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
 					uint32_t shamt = ((inst) >> (0x6)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_sshr(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, shamt))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_sshr(func, jit_insn_convert(func, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint), jit_type_int, 0), jit_value_create_nint_constant(func, jit_type_uint, shamt))); }
 					return(true);
 					break;
 				}
@@ -191,7 +325,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_shl(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_shl(func, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint), jit_insn_and(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, 0x1f)))); }
 					return(true);
 					break;
 				}
@@ -201,7 +335,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_ushr(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_ushr(func, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint), jit_insn_and(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, 0x1f)))); }
 					return(true);
 					break;
 				}
@@ -211,7 +345,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_sshr(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_sshr(func, jit_insn_convert(func, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint), jit_type_int, 0), jit_insn_and(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, 0x1f)))); }
 					return(true);
 					break;
 				}
@@ -219,7 +353,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					/* JR */
 					jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
-					call_branch(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					call_branch(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint));
 					branched = true;
 					return(true);
 					break;
@@ -229,8 +363,8 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_add(func, jit_insn_add(func, jit_value_create_nint_constant(func, jit_type_uint, pc), jit_value_create_nint_constant(func, jit_type_uint, 0x4)), jit_value_create_nint_constant(func, jit_type_uint, 0x4))); }
-					call_branch(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_add(func, jit_insn_add(func, jit_value_create_nint_constant(func, jit_type_uint, pc), jit_value_create_nint_constant(func, jit_type_uint, 0x4)), jit_value_create_nint_constant(func, jit_type_uint, 0x4))); }
+					call_branch(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint));
 					branched = true;
 					return(true);
 					break;
@@ -255,15 +389,15 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					/* MFHI */
 					jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_load_relative(func, state, 33*4, jit_type_uint)); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_load_relative(func, state, 33*4, jit_type_uint)); }
 					return(true);
 					break;
 				}
 				case 0x11: {
 					/* MTHI */
 					jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
-					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					jit_insn_store_relative(func, state, 33*4, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
+					jit_insn_store_relative(func, state, 33*4, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint));
 					return(true);
 					break;
 				}
@@ -271,15 +405,15 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					/* MFLO */
 					jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_load_relative(func, state, 34*4, jit_type_uint)); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_load_relative(func, state, 34*4, jit_type_uint)); }
 					return(true);
 					break;
 				}
 				case 0x13: {
 					/* MTLO */
 					jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
-					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					jit_insn_store_relative(func, state, 34*4, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
+					jit_insn_store_relative(func, state, 34*4, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint));
 					return(true);
 					break;
 				}
@@ -306,8 +440,8 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
-					jit_insn_store_relative(func, state, 34*4, jit_insn_div(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint)));
-					jit_insn_store_relative(func, state, 33*4, jit_insn_rem(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint)));
+					jit_insn_store_relative(func, state, 34*4, jit_insn_div(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint)));
+					jit_insn_store_relative(func, state, 33*4, jit_insn_rem(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint)));
 					return(true);
 					break;
 				}
@@ -316,8 +450,8 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
-					jit_insn_store_relative(func, state, 34*4, jit_insn_div(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint)));
-					jit_insn_store_relative(func, state, 33*4, jit_insn_rem(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint)));
+					jit_insn_store_relative(func, state, 34*4, jit_insn_div(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint)));
+					jit_insn_store_relative(func, state, 33*4, jit_insn_rem(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint)));
 					return(true);
 					break;
 				}
@@ -327,8 +461,8 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					call_overflow(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), 1);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint))); }
+					call_overflow(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint), 1);
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint))); }
 					return(true);
 					break;
 				}
@@ -338,7 +472,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint))); }
 					return(true);
 					break;
 				}
@@ -348,8 +482,8 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					call_overflow(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), -1);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_sub(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint))); }
+					call_overflow(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint), -1);
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_sub(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint))); }
 					return(true);
 					break;
 				}
@@ -359,7 +493,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_sub(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_sub(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint))); }
 					return(true);
 					break;
 				}
@@ -369,7 +503,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_and(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_and(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint))); }
 					return(true);
 					break;
 				}
@@ -379,7 +513,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_or(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_or(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint))); }
 					return(true);
 					break;
 				}
@@ -389,7 +523,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_xor(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_xor(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint))); }
 					return(true);
 					break;
 				}
@@ -399,7 +533,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rd) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_not(func, jit_insn_or(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint)))); }
+					if((rd) != (0x0)) { jit_insn_store_relative(func, state, (rd) * 4, jit_insn_not(func, jit_insn_or(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint)))); }
 					return(true);
 					break;
 				}
@@ -410,16 +544,16 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
 					jit_label_t temp_1 = jit_label_undefined, temp_2 = jit_label_undefined;
-					jit_insn_branch_if(func, jit_insn_lt(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint)), &temp_1);
+					jit_insn_branch_if_not(func, jit_insn_lt(func, jit_insn_convert(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_type_int, 0), jit_insn_convert(func, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint), jit_type_int, 0)), &temp_1);
 					jit_label_t temp_3 = jit_label_undefined;
 					jit_insn_branch_if_not(func, jit_insn_ne(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_3);
-					jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_value_create_nint_constant(func, jit_type_uint, 0x1));
+					jit_insn_store_relative(func, state, (rd) * 4, jit_value_create_nint_constant(func, jit_type_uint, 0x1));
 					jit_insn_label(func, &temp_3);
 					jit_insn_branch(func, &temp_2);
 					jit_insn_label(func, &temp_1);
 					jit_label_t temp_4 = jit_label_undefined;
 					jit_insn_branch_if_not(func, jit_insn_ne(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_4);
-					jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_value_create_nint_constant(func, jit_type_uint, 0x0));
+					jit_insn_store_relative(func, state, (rd) * 4, jit_value_create_nint_constant(func, jit_type_uint, 0x0));
 					jit_insn_label(func, &temp_4);
 					jit_insn_label(func, &temp_2);
 					return(true);
@@ -432,16 +566,16 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
 					jit_label_t temp_5 = jit_label_undefined, temp_6 = jit_label_undefined;
-					jit_insn_branch_if(func, jit_insn_lt(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint)), &temp_5);
+					jit_insn_branch_if_not(func, jit_insn_lt(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint)), &temp_5);
 					jit_label_t temp_7 = jit_label_undefined;
 					jit_insn_branch_if_not(func, jit_insn_ne(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_7);
-					jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_value_create_nint_constant(func, jit_type_uint, 0x1));
+					jit_insn_store_relative(func, state, (rd) * 4, jit_value_create_nint_constant(func, jit_type_uint, 0x1));
 					jit_insn_label(func, &temp_7);
 					jit_insn_branch(func, &temp_6);
 					jit_insn_label(func, &temp_5);
 					jit_label_t temp_8 = jit_label_undefined;
 					jit_insn_branch_if_not(func, jit_insn_ne(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_8);
-					jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rd), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_value_create_nint_constant(func, jit_type_uint, 0x0));
+					jit_insn_store_relative(func, state, (rd) * 4, jit_value_create_nint_constant(func, jit_type_uint, 0x0));
 					jit_insn_label(func, &temp_8);
 					jit_insn_label(func, &temp_6);
 					return(true);
@@ -459,7 +593,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t imm = (inst) & (0xffff);
 					uint32_t target = ((pc) + (0x4)) + (signext(0x12, (imm) << (0x2)));
 					jit_label_t temp_9 = jit_label_undefined;
-					jit_insn_branch_if_not(func, jit_insn_lt(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_9);
+					jit_insn_branch_if_not(func, jit_insn_lt(func, jit_insn_convert(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_type_int, 0), jit_value_create_nint_constant(func, jit_type_int, (int32_t) (0x0))), &temp_9);
 					call_branch(func, jit_value_create_nint_constant(func, jit_type_uint, target));
 					jit_insn_label(func, &temp_9);
 					branched = true;
@@ -473,7 +607,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t imm = (inst) & (0xffff);
 					uint32_t target = ((pc) + (0x4)) + (signext(0x12, (imm) << (0x2)));
 					jit_label_t temp_10 = jit_label_undefined;
-					jit_insn_branch_if_not(func, jit_insn_ge(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_10);
+					jit_insn_branch_if_not(func, jit_insn_ge(func, jit_insn_convert(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_type_int, 0), jit_value_create_nint_constant(func, jit_type_int, (int32_t) (0x0))), &temp_10);
 					call_branch(func, jit_value_create_nint_constant(func, jit_type_uint, target));
 					jit_insn_label(func, &temp_10);
 					branched = true;
@@ -485,10 +619,10 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t imm = (inst) & (0xffff);
-					if((0x1f) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, 0x1f), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_add(func, jit_value_create_nint_constant(func, jit_type_uint, pc), jit_value_create_nint_constant(func, jit_type_uint, 0x4))); }
+					if((0x1f) != (0x0)) { jit_insn_store_relative(func, state, (0x1f) * 4, jit_insn_add(func, jit_insn_add(func, jit_value_create_nint_constant(func, jit_type_uint, pc), jit_value_create_nint_constant(func, jit_type_uint, 0x4)), jit_value_create_nint_constant(func, jit_type_uint, 0x4))); }
 					uint32_t target = ((pc) + (0x4)) + (signext(0x12, (imm) << (0x2)));
 					jit_label_t temp_11 = jit_label_undefined;
-					jit_insn_branch_if_not(func, jit_insn_lt(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_11);
+					jit_insn_branch_if_not(func, jit_insn_lt(func, jit_insn_convert(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_type_int, 0), jit_value_create_nint_constant(func, jit_type_int, (int32_t) (0x0))), &temp_11);
 					call_branch(func, jit_value_create_nint_constant(func, jit_type_uint, target));
 					jit_insn_label(func, &temp_11);
 					branched = true;
@@ -500,10 +634,10 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
 					uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 					uint32_t imm = (inst) & (0xffff);
-					if((0x1f) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, 0x1f), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_add(func, jit_value_create_nint_constant(func, jit_type_uint, pc), jit_value_create_nint_constant(func, jit_type_uint, 0x4))); }
+					if((0x1f) != (0x0)) { jit_insn_store_relative(func, state, (0x1f) * 4, jit_insn_add(func, jit_insn_add(func, jit_value_create_nint_constant(func, jit_type_uint, pc), jit_value_create_nint_constant(func, jit_type_uint, 0x4)), jit_value_create_nint_constant(func, jit_type_uint, 0x4))); }
 					uint32_t target = ((pc) + (0x4)) + (signext(0x12, (imm) << (0x2)));
 					jit_label_t temp_12 = jit_label_undefined;
-					jit_insn_branch_if_not(func, jit_insn_ge(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_12);
+					jit_insn_branch_if_not(func, jit_insn_ge(func, jit_insn_convert(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_type_int, 0), jit_value_create_nint_constant(func, jit_type_int, (int32_t) (0x0))), &temp_12);
 					call_branch(func, jit_value_create_nint_constant(func, jit_type_uint, target));
 					jit_insn_label(func, &temp_12);
 					branched = true;
@@ -517,7 +651,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			/* J */
 			jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
 			uint32_t imm = (inst) & (0x3ffffff);
-			uint32_t target = (((pc) + (0x4)) & (0xf0000000)) + (0x1c);
+			uint32_t target = (((pc) + (0x4)) & (0xf0000000)) + (((imm) << (0x2)) & 0xfffffff);
 			call_branch(func, jit_value_create_nint_constant(func, jit_type_uint, target));
 			branched = true;
 			return(true);
@@ -527,8 +661,8 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			/* JAL */
 			jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
 			uint32_t imm = (inst) & (0x3ffffff);
-			if((0x1f) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, 0x1f), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_add(func, jit_insn_add(func, jit_value_create_nint_constant(func, jit_type_uint, pc), jit_value_create_nint_constant(func, jit_type_uint, 0x4)), jit_value_create_nint_constant(func, jit_type_uint, 0x4))); }
-			uint32_t target = (((pc) + (0x4)) & (0xf0000000)) + (0x1c);
+			if((0x1f) != (0x0)) { jit_insn_store_relative(func, state, (0x1f) * 4, jit_insn_add(func, jit_insn_add(func, jit_value_create_nint_constant(func, jit_type_uint, pc), jit_value_create_nint_constant(func, jit_type_uint, 0x4)), jit_value_create_nint_constant(func, jit_type_uint, 0x4))); }
+			uint32_t target = (((pc) + (0x4)) & (0xf0000000)) + (((imm) << (0x2)) & 0xfffffff);
 			call_branch(func, jit_value_create_nint_constant(func, jit_type_uint, target));
 			branched = true;
 			return(true);
@@ -542,7 +676,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t target = ((pc) + (0x4)) + (signext(0x12, (imm) << (0x2)));
 			jit_label_t temp_13 = jit_label_undefined;
-			jit_insn_branch_if_not(func, jit_insn_eq(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint)), &temp_13);
+			jit_insn_branch_if_not(func, jit_insn_eq(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint)), &temp_13);
 			call_branch(func, jit_value_create_nint_constant(func, jit_type_uint, target));
 			jit_insn_label(func, &temp_13);
 			branched = true;
@@ -557,7 +691,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t target = ((pc) + (0x4)) + (signext(0x12, (imm) << (0x2)));
 			jit_label_t temp_14 = jit_label_undefined;
-			jit_insn_branch_if_not(func, jit_insn_ne(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint)), &temp_14);
+			jit_insn_branch_if_not(func, jit_insn_ne(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint)), &temp_14);
 			call_branch(func, jit_value_create_nint_constant(func, jit_type_uint, target));
 			jit_insn_label(func, &temp_14);
 			branched = true;
@@ -573,7 +707,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t imm = (inst) & (0xffff);
 					uint32_t target = ((pc) + (0x4)) + (signext(0x12, (imm) << (0x2)));
 					jit_label_t temp_15 = jit_label_undefined;
-					jit_insn_branch_if_not(func, jit_insn_le(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_15);
+					jit_insn_branch_if_not(func, jit_insn_le(func, jit_insn_convert(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_type_int, 0), jit_value_create_nint_constant(func, jit_type_int, (int32_t) (0x0))), &temp_15);
 					call_branch(func, jit_value_create_nint_constant(func, jit_type_uint, target));
 					jit_insn_label(func, &temp_15);
 					branched = true;
@@ -592,7 +726,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t imm = (inst) & (0xffff);
 					uint32_t target = ((pc) + (0x4)) + (signext(0x12, (imm) << (0x2)));
 					jit_label_t temp_16 = jit_label_undefined;
-					jit_insn_branch_if_not(func, jit_insn_gt(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_16);
+					jit_insn_branch_if_not(func, jit_insn_gt(func, jit_insn_convert(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_type_int, 0), jit_value_create_nint_constant(func, jit_type_int, (int32_t) (0x0))), &temp_16);
 					call_branch(func, jit_value_create_nint_constant(func, jit_type_uint, target));
 					jit_insn_label(func, &temp_16);
 					branched = true;
@@ -609,8 +743,8 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t eimm = signext(0x10, imm);
-			call_overflow(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm), 1);
-			if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm))); }
+			call_overflow(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm), 1);
+			if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm))); }
 			return(true);
 			break;
 		}
@@ -621,7 +755,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t eimm = signext(0x10, imm);
-			if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm))); }
+			if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm))); }
 			return(true);
 			break;
 		}
@@ -633,16 +767,16 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t eimm = signext(0x10, imm);
 			jit_label_t temp_17 = jit_label_undefined, temp_18 = jit_label_undefined;
-			jit_insn_branch_if(func, jit_insn_lt(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm)), &temp_17);
+			jit_insn_branch_if_not(func, jit_insn_lt(func, jit_insn_convert(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_type_int, 0), jit_value_create_nint_constant(func, jit_type_int, (int32_t) (eimm))), &temp_17);
 			jit_label_t temp_19 = jit_label_undefined;
 			jit_insn_branch_if_not(func, jit_insn_ne(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_19);
-			jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_value_create_nint_constant(func, jit_type_uint, 0x1));
+			jit_insn_store_relative(func, state, (rt) * 4, jit_value_create_nint_constant(func, jit_type_uint, 0x1));
 			jit_insn_label(func, &temp_19);
 			jit_insn_branch(func, &temp_18);
 			jit_insn_label(func, &temp_17);
 			jit_label_t temp_20 = jit_label_undefined;
 			jit_insn_branch_if_not(func, jit_insn_ne(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_20);
-			jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_value_create_nint_constant(func, jit_type_uint, 0x0));
+			jit_insn_store_relative(func, state, (rt) * 4, jit_value_create_nint_constant(func, jit_type_uint, 0x0));
 			jit_insn_label(func, &temp_20);
 			jit_insn_label(func, &temp_18);
 			return(true);
@@ -656,16 +790,16 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t eimm = signext(0x10, imm);
 			jit_label_t temp_21 = jit_label_undefined, temp_22 = jit_label_undefined;
-			jit_insn_branch_if(func, jit_insn_lt(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm)), &temp_21);
+			jit_insn_branch_if_not(func, jit_insn_lt(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm)), &temp_21);
 			jit_label_t temp_23 = jit_label_undefined;
 			jit_insn_branch_if_not(func, jit_insn_ne(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_23);
-			jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_value_create_nint_constant(func, jit_type_uint, 0x1));
+			jit_insn_store_relative(func, state, (rt) * 4, jit_value_create_nint_constant(func, jit_type_uint, 0x1));
 			jit_insn_label(func, &temp_23);
 			jit_insn_branch(func, &temp_22);
 			jit_insn_label(func, &temp_21);
 			jit_label_t temp_24 = jit_label_undefined;
 			jit_insn_branch_if_not(func, jit_insn_ne(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 0x0)), &temp_24);
-			jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_value_create_nint_constant(func, jit_type_uint, 0x0));
+			jit_insn_store_relative(func, state, (rt) * 4, jit_value_create_nint_constant(func, jit_type_uint, 0x0));
 			jit_insn_label(func, &temp_24);
 			jit_insn_label(func, &temp_22);
 			return(true);
@@ -677,8 +811,8 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
-			uint32_t eimm = 0x10;
-			if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_and(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm))); }
+			uint32_t eimm = (imm) & 0xffff;
+			if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, jit_insn_and(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm))); }
 			return(true);
 			break;
 		}
@@ -688,8 +822,8 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
-			uint32_t eimm = 0x10;
-			if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_or(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm))); }
+			uint32_t eimm = (imm) & 0xffff;
+			if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, jit_insn_or(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm))); }
 			return(true);
 			break;
 		}
@@ -699,8 +833,8 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rs = ((inst) >> (0x15)) & (0x1f);
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
-			uint32_t eimm = 0x10;
-			if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_xor(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm))); }
+			uint32_t eimm = (imm) & 0xffff;
+			if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, jit_insn_xor(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, eimm))); }
 			return(true);
 			break;
 		}
@@ -709,7 +843,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			jit_insn_store_relative(func, state, 32*4, jit_value_create_nint_constant(func, jit_type_uint, pc));
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
-			if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_insn_shl(func, jit_value_create_nint_constant(func, jit_type_uint, imm), jit_value_create_nint_constant(func, jit_type_uint, 0x10))); }
+			if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, jit_insn_shl(func, jit_value_create_nint_constant(func, jit_type_uint, imm), jit_value_create_nint_constant(func, jit_type_uint, 0x10))); }
 			return(true);
 			break;
 		}
@@ -721,7 +855,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_read_copreg(func, cop, rd)); }
+					if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_read_copreg(func, cop, rd)); }
 					return(true);
 					break;
 				}
@@ -731,7 +865,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_read_copcreg(func, cop, rd)); }
+					if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_read_copcreg(func, cop, rd)); }
 					return(true);
 					break;
 				}
@@ -741,7 +875,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					call_write_copreg(func, cop, rd, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					call_write_copreg(func, cop, rd, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint));
 					return(true);
 					break;
 				}
@@ -751,7 +885,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					call_write_copcreg(func, cop, rd, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					call_write_copcreg(func, cop, rd, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint));
 					return(true);
 					break;
 				}
@@ -910,7 +1044,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_read_copreg(func, cop, rd)); }
+					if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_read_copreg(func, cop, rd)); }
 					return(true);
 					break;
 				}
@@ -920,7 +1054,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_read_copcreg(func, cop, rd)); }
+					if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_read_copcreg(func, cop, rd)); }
 					return(true);
 					break;
 				}
@@ -930,7 +1064,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					call_write_copreg(func, cop, rd, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					call_write_copreg(func, cop, rd, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint));
 					return(true);
 					break;
 				}
@@ -940,7 +1074,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					call_write_copcreg(func, cop, rd, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					call_write_copcreg(func, cop, rd, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint));
 					return(true);
 					break;
 				}
@@ -1099,7 +1233,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_read_copreg(func, cop, rd)); }
+					if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_read_copreg(func, cop, rd)); }
 					return(true);
 					break;
 				}
@@ -1109,7 +1243,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_read_copcreg(func, cop, rd)); }
+					if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_read_copcreg(func, cop, rd)); }
 					return(true);
 					break;
 				}
@@ -1119,7 +1253,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					call_write_copreg(func, cop, rd, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					call_write_copreg(func, cop, rd, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint));
 					return(true);
 					break;
 				}
@@ -1129,7 +1263,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					call_write_copcreg(func, cop, rd, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					call_write_copcreg(func, cop, rd, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint));
 					return(true);
 					break;
 				}
@@ -1288,7 +1422,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_read_copreg(func, cop, rd)); }
+					if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_read_copreg(func, cop, rd)); }
 					return(true);
 					break;
 				}
@@ -1298,7 +1432,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_read_copcreg(func, cop, rd)); }
+					if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_read_copcreg(func, cop, rd)); }
 					return(true);
 					break;
 				}
@@ -1308,7 +1442,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					call_write_copreg(func, cop, rd, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					call_write_copreg(func, cop, rd, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint));
 					return(true);
 					break;
 				}
@@ -1318,7 +1452,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 					uint32_t cop = ((inst) >> (0x1a)) & (0x3);
 					uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 					uint32_t rd = ((inst) >> (0xb)) & (0x1f);
-					call_write_copcreg(func, cop, rd, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+					call_write_copcreg(func, cop, rd, jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint));
 					return(true);
 					break;
 				}
@@ -1476,7 +1610,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t offset = signext(0x10, imm);
-			if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_signext(func, 8, call_load_memory(func, 8, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset))))); }
+			if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_signext(func, 8, call_load_memory(func, 8, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset))))); }
 			return(true);
 			break;
 		}
@@ -1487,7 +1621,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t offset = signext(0x10, imm);
-			if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_signext(func, 16, call_load_memory(func, 16, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset))))); }
+			if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_signext(func, 16, call_load_memory(func, 16, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset))))); }
 			return(true);
 			break;
 		}
@@ -1498,7 +1632,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t offset = signext(0x10, imm);
-			if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_load_memory(func, 32, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)))); }
+			if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_load_memory(func, 32, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)))); }
 			return(true);
 			break;
 		}
@@ -1509,7 +1643,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t offset = signext(0x10, imm);
-			if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_load_memory(func, 8, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)))); }
+			if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_load_memory(func, 8, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)))); }
 			return(true);
 			break;
 		}
@@ -1520,7 +1654,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t offset = signext(0x10, imm);
-			if((rt) != (0x0)) { jit_insn_store_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, call_load_memory(func, 16, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)))); }
+			if((rt) != (0x0)) { jit_insn_store_relative(func, state, (rt) * 4, call_load_memory(func, 16, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)))); }
 			return(true);
 			break;
 		}
@@ -1531,7 +1665,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t offset = signext(0x10, imm);
-			call_store_memory(func, 8, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+			call_store_memory(func, 8, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint));
 			return(true);
 			break;
 		}
@@ -1542,7 +1676,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t offset = signext(0x10, imm);
-			call_store_memory(func, 16, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+			call_store_memory(func, 16, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint));
 			return(true);
 			break;
 		}
@@ -1553,7 +1687,7 @@ bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t ins
 			uint32_t rt = ((inst) >> (0x10)) & (0x1f);
 			uint32_t imm = (inst) & (0xffff);
 			uint32_t offset = signext(0x10, imm);
-			call_store_memory(func, 32, jit_insn_add(func, jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rs), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)), jit_insn_load_relative(func, jit_insn_add(func, state, jit_insn_mul(func, jit_value_create_nint_constant(func, jit_type_uint, rt), jit_value_create_nint_constant(func, jit_type_uint, 4))), 0, jit_type_uint));
+			call_store_memory(func, 32, jit_insn_add(func, jit_insn_load_relative(func, state, (rs) * 4, jit_type_uint), jit_value_create_nint_constant(func, jit_type_uint, offset)), jit_insn_load_relative(func, state, (rt) * 4, jit_type_uint));
 			return(true);
 			break;
 		}
@@ -0,0 +1,46 @@
+#ifndef __MDFN_PSX_DECOMP_H
+#define __MDFN_PSX_DECOMP_H
+
+#include <stdint.h>
+
+// libjit-based recompiler backend; the translator lives in decomp.cpp, which is
+// generated from insts.td + decompstub.cpp by generator.py.
+
+// A translated block.  It is passed PS_CPU's register file, laid out as
+// GPR[0..31], the current instruction PC (stored over the load delay dummy
+// register), HI and LO.
+typedef void (*decomp_block_fn)(uint32_t *state);
+
+enum
+{
+   DECOMP_EXIT_NONE  = 0,
+   // The instruction at the stored PC was not executed and must be handed to the
+   // interpreter (address error, overflow, unsupported coprocessor access).
+   DECOMP_EXIT_FAULT = 1,
+   // The instruction at the stored PC completed, but an interrupt became pending
+   // or an event came due; leave the block so the interpreter can catch up.
+   DECOMP_EXIT_SYNC  = 2
+};
+
+struct decomp_runtime
+{
+   int32_t timestamp;
+   uint32_t exit;
+   uint32_t branch_taken;
+   uint32_t branch_target;
+};
+
+extern struct decomp_runtime decomp_rt;
+
+void decomp_init(void);
+void decomp_kill(void);
+
+// Frees every translated block; all decomp_block_fn pointers handed out
+// before are invalid afterwards.
+void decomp_reset(void);
+
+// Translates 'count' instructions starting at 'pc', charging 'inst_cycles'
+// cycles per instruction.  Returns NULL on failure.
+decomp_block_fn decomp_translate(uint32_t pc, const uint32_t *insts, unsigned count, unsigned inst_cycles);
+
+#endif
@@ -51,69 +51,9 @@ static OpEntry ops[] =
  MK_OP("nop",	"",	0, 0, MASK_RT | MASK_RD | MASK_SA),
 
  //
+ // Generated from insts.td by generator.py.
  //
- //
- MK_OP("sll",	"d, t, a", 0, 0, 0),
- MK_OP("srl",   "d, t, a", 0, 2, 0),
- MK_OP("sra",   "d, t, a", 0, 3, 0),
-
- MK_OP("sllv",   "d, t, s", 0, 4, 0),
- MK_OP("srlv",   "d, t, s", 0, 6, 0),
- MK_OP("srav",   "d, t, s", 0, 7, 0),
-
- MK_OP("jr",   	 "s", 0, 8, 0),
- MK_OP("jalr",   "d, s", 0, 9, 0),
-
- MK_OP("syscall", "", 0, 12, 0),	// TODO
- MK_OP("break",   "", 0, 13, 0),	// TODO
-
- MK_OP("mfhi",  "d", 0, 16, 0),
- MK_OP("mthi",  "s", 0, 17, 0),
- MK_OP("mflo",  "d", 0, 18, 0),
- MK_OP("mtlo",  "s", 0, 19, 0),
-
- MK_OP("mult",  "s, t", 0, 24, 0),
- MK_OP("multu", "s, t", 0, 25, 0),
- MK_OP("div",   "s, t", 0, 26, 0),
- MK_OP("divu",  "s, t", 0, 27, 0),
-
- MK_OP("add",   "d, s, t", 0, 32, 0),
- MK_OP("addu",  "d, s, t", 0, 33, 0),
- MK_OP("sub",	"d, s, t", 0, 34, 0),
- MK_OP("subu",	"d, s, t", 0, 35, 0),
- MK_OP("and",   "d, s, t", 0, 36, 0),
- MK_OP("or",    "d, s, t", 0, 37, 0),
- MK_OP("xor",   "d, s, t", 0, 38, 0),
- MK_OP("nor",   "d, s, t", 0, 39, 0),
- MK_OP("slt",   "d, s, t", 0, 42, 0),
- MK_OP("sltu",  "d, s, t", 0, 43, 0),
-
- /* keep *al before the non-linking versions, due to mask setup. */
- MK_OP_REGIMM("bgezal", 0x1F, 0x11),
- MK_OP_REGIMM("bltzal",	0x1F, 0x10),
-
- MK_OP_REGIMM("bgez",	0x01, 0x01),
- MK_OP_REGIMM("bltz",	0x00, 0x00),
-
- 
- MK_OP("j",	"P", 2, 0, 0),
- MK_OP("jal",	"P", 3, 0, 0),
-
- MK_OP("beq",	"s, t, p", 4, 0, 0),
- MK_OP("bne",   "s, t, p", 5, 0, 0),
- MK_OP("blez",  "s, p", 6, 0, 0),
- MK_OP("bgtz",  "s, p", 7, 0, 0),
-
- MK_OP("addi",  "t, s, i", 8, 0, 0),
- MK_OP("addiu", "t, s, i", 9, 0, 0),
- MK_OP("slti",  "t, s, i", 10, 0, 0),
- MK_OP("sltiu", "t, s, i", 11, 0, 0),
-
- MK_OP("andi",  "t, s, z", 12, 0, 0),
-
- MK_OP("ori",  	"t, s, z", 13, 0, 0),
- MK_OP("xori",  "t, s, z", 14, 0, 0),
- MK_OP("lui",	"t, z", 15, 0, 0),
+ #include "dis_ops.inc"
 
  MK_COPZ_XFER(0, "mfc0", "t, 0", 0x00),
  MK_COPZ_XFER(1, "mfc1", "t, ?", 0x00),
@@ -153,18 +93,11 @@ static OpEntry ops[] =
  MK_OP("swc2", "h, i(s)", 0x3A, 0, 0),
  MK_OP("swc3", "?, i(s)", 0x3B, 0, 0),
 
- MK_OP("lb",    "t, i(s)", 0x20, 0, 0),
- MK_OP("lh",    "t, i(s)", 0x21, 0, 0),
+ // The unaligned loads and stores aren't described by insts.td.
  MK_OP("lwl",   "t, i(s)", 0x22, 0, 0),
- MK_OP("lw",    "t, i(s)", 0x23, 0, 0),
- MK_OP("lbu",   "t, i(s)", 0x24, 0, 0),
- MK_OP("lhu",   "t, i(s)", 0x25, 0, 0),
  MK_OP("lwr",   "t, i(s)", 0x26, 0, 0),
 
- MK_OP("sb",    "t, i(s)", 0x28, 0, 0),
- MK_OP("sh",    "t, i(s)", 0x29, 0, 0),
  MK_OP("swl",   "t, i(s)", 0x2A, 0, 0),
- MK_OP("sw",	"t, i(s)", 0x2B, 0, 0),
  MK_OP("swr",   "t, i(s)", 0x2E, 0, 0),
 
  //
@@ -291,6 +291,53 @@ static INLINE void ChRW(const unsigned ch, const uint32_t CRModeCache, const uin
    DMACH[ch].ClockCounter -= std::max<int>(extra_cyc_overhead, (CRModeCache & 0x100) ? 7 : 0);
 }
 
+// Image data over channel 2 in block mode: moves as many words as the per-word
+// loop in RunChannel() would, from CurAddr on, in one go, with the same clock and
+// counter accounting left to the caller.  Returns how many words it moved(0 if
+// the words have to go one at a time).
+static uint32_t ChGPUBlock(const uint32_t CRModeCache)
+{
+   uint32_t buf[256];
+   uint32_t count;
+   uint32_t i;
+
+   // No linked list, chopping or decrementing addresses
+   if(CRModeCache & 0x502)
+      return 0;
+
+   if(DMACH[CH_GPU].CurAddr & 0x800000 || DMACH[CH_GPU].ClockCounter <= 0)
+      return 0;
+
+   count = GPU_DMABlockWords(CRModeCache & 0x1);
+   count = std::min<uint32_t>(count, DMACH[CH_GPU].WordCounter);
+   count = std::min<uint32_t>(count, DMACH[CH_GPU].ClockCounter);
+   count = std::min<uint32_t>(count, (0x800000 - DMACH[CH_GPU].CurAddr) >> 2);
+   count = std::min<uint32_t>(count, 256);
+
+   if(count < 2)
+      return 0;
+
+   if(CRModeCache & 0x1)
+   {
+      for(i = 0; i < count; i++)
+         buf[i] = MainRAM.ReadU32((DMACH[CH_GPU].CurAddr + (i << 2)) & 0x1FFFFC);
+
+      GPU_WriteDMABlock(buf, count);
+   }
+   else
+   {
+      GPU_ReadDMABlock(buf, count);
+
+      for(i = 0; i < count; i++)
+      {
+         MainRAM.WriteU32((DMACH[CH_GPU].CurAddr + (i << 2)) & 0x1FFFFC, buf[i]);
+         PSX_CodeWriteCheck(DMACH[CH_GPU].CurAddr + (i << 2));
+      }
+   }
+
+   return count;
+}
+
 static INLINE void RunChannelI(const unsigned ch, const uint32_t CRModeCache, int32_t clocks)
 {
 }
@@ -417,6 +464,19 @@ static INLINE void RunChannel(int32_t timestamp, int32_t clocks, int ch)
             DMACH[ch].WordCounter = DMACH[ch].BlockControl & 0xFFFF;
          }
 
+         if(ch == CH_GPU)
+         {
+            const uint32_t words = ChGPUBlock(CRModeCache);
+
+            if(words)
+            {
+               DMACH[ch].CurAddr       = (DMACH[ch].CurAddr + (words << 2)) & 0xFFFFFF;
+               DMACH[ch].WordCounter  -= words;
+               DMACH[ch].ClockCounter -= words;
+               goto SkipPayloadStuff;
+            }
+         }
+
          // Do the payload read/write
          {
             uint32_t vtmp;
@@ -437,7 +497,10 @@ static INLINE void RunChannel(int32_t timestamp, int32_t clocks, int ch)
             ChRW(ch, CRModeCache, DMACH[ch].CurAddr, &vtmp, &voffs);
 
             if(!(CRModeCache & 0x1))
+            {
                MainRAM.WriteU32((DMACH[ch].CurAddr + (voffs << 2)) & 0x1FFFFC, vtmp);
+               PSX_CodeWriteCheck(DMACH[ch].CurAddr + (voffs << 2));
+            }
          }
 
          if(CRModeCache & 0x2)
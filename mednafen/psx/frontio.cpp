@@ -78,7 +78,7 @@ void InputDevice::SetCrosshairsColor(uint32_t color)
    draw_chair = (color != (1 << 24));
 }
 
-INLINE void InputDevice::DrawCrosshairs(uint32 *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock)
+INLINE void InputDevice::DrawCrosshairs(surface_pixel *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock)
 {
    if(draw_chair && chair_y >= -8 && chair_y <= 8)
    {
@@ -198,7 +198,7 @@ bool InputDevice::RequireNoFrameskip(void)
  return false;
 }
 
-int32_t InputDevice::GPULineHook(const int32_t timestamp, bool vsync, uint32 *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock_offset, const unsigned pix_clock, const unsigned pix_clock_divider)
+int32_t InputDevice::GPULineHook(const int32_t timestamp, bool vsync, surface_pixel *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock_offset, const unsigned pix_clock, const unsigned pix_clock_divider)
 {
  return(PSX_EVENT_MAXTS);
 }
@@ -930,7 +930,7 @@ bool FrontIO::RequireNoFrameskip(void)
    return(false);
 }
 
-void FrontIO::GPULineHook(const int32_t timestamp, const int32_t line_timestamp, bool vsync, uint32 *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock_offset, const unsigned pix_clock, const unsigned pix_clock_divider)
+void FrontIO::GPULineHook(const int32_t timestamp, const int32_t line_timestamp, bool vsync, surface_pixel *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock_offset, const unsigned pix_clock, const unsigned pix_clock_divider)
 {
    Update(timestamp);
 
@@ -23,7 +23,18 @@
 #include "../pgxp/pgxp_gpu.h"
 #include "../pgxp/pgxp_mem.h"
 
+#include "gpu_threads.h"
+#include "gpu_simd.h"
 #include "gpu_common.h"
+#include "gpu_profiler.h"
+
+static const int8 dither_table[4][4] =
+{
+   { -4,  0, -3,  1 },
+   {  2, -2,  3, -1 },
+   { -3,  1, -4,  0 },
+   {  3, -1,  2, -2 },
+};
 
 #include "gpu_polygon.cpp"
 #include "gpu_sprite.cpp"
@@ -65,14 +76,6 @@
    Vertical start and end can be changed during active display, with effect(though it needs to be vs0->ve0->vs1->ve1->..., vs0->vs1->ve0 doesn't apparently do anything
    different from vs0->ve0.
    */
-static const int8 dither_table[4][4] =
-{
-   { -4,  0, -3,  1 },
-   {  2, -2,  3, -1 },
-   { -3,  1, -4,  0 },
-   {  3, -1,  2, -2 },
-};
-
 static FastFIFO<uint32, 0x20> GPU_BlitterFIFO; // 0x10 on an actual PS1 GPU, 0x20 here (see comment at top of gpu.h)
 
 struct CTEntry
@@ -85,6 +88,9 @@ struct CTEntry
 
 PS_GPU *GPU = NULL;
 
+static unsigned RasterThreads = 0;
+static bool PrevFrameSkipped = false;
+
 static INLINE void InvalidateTexCache(PS_GPU *gpu)
 {
    unsigned i;
@@ -98,6 +104,34 @@ static INLINE void InvalidateCache(PS_GPU *gpu)
    InvalidateTexCache(gpu);
 }
 
+static void RasterVRAMWrite(PS_GPU *gpu, const gpu_raster_job *job)
+{
+   InvalidateTexDecode(gpu, &job->vram_write);
+}
+
+/* Called before the emulation thread writes VRAM itself(rather than
+ * through the rasterizer), see RasterWriting().  The rasterizer threads
+ * drop their decoded texture pages in order with the primitives queued
+ * so far. */
+static void VRAMWriting(PS_GPU *gpu, uint32 x, uint32 y, uint32 w, uint32 h)
+{
+   gpu_raster_rect rect = { x, y, w, h };
+
+   ScanoutWriting(gpu, &rect);
+   InvalidateTexDecode(gpu, &rect);
+
+   if(GPU_RasterActive())
+   {
+      gpu_raster_rect none = { 0, 0, 0, 0 };
+      gpu_raster_job *job  = GPU_RasterNewJob(gpu);
+
+      job->draw       = RasterVRAMWrite;
+      job->vram_write = rect;
+
+      GPU_RasterSubmit(&none, NULL, 0);
+   }
+}
+
 static void SetTPage(PS_GPU *gpu, const uint32_t cmdw)
 {
    const unsigned NewTexPageX = (cmdw & 0xF) * 64;
@@ -150,11 +184,48 @@ static void Command_IRQ(PS_GPU* g, const uint32 *cb)
    IRQ_Assert(IRQ_GPU, g->IRQPending);
 }
 
+static void DrawFill(PS_GPU* gpu, uint16_t fill_value,
+      int32_t destX, int32_t destY, int32_t width, int32_t height)
+{
+   unsigned y;
+   gpu_raster_rect area = { (uint32)destX, (uint32)destY, (uint32)width, (uint32)height };
+
+   if(width && height)
+      RasterWriting(gpu, &area);
+
+   for(y = 0; y < height; y++)
+   {
+      int32 first;
+      const int32 d_y = (y + destY) & 511;
+
+      if(LineSkipTest(gpu, d_y))
+         continue;
+
+      gpu->DrawTimeAvail -= (width >> 3) + 9;
+      GPU_PROF_PIXELS(gpu, width);
+
+      if(!RasterLineOwned(gpu, d_y))
+         continue;
+
+      // Wrapping around to the start of the line at most once
+      first = std::min<int32>(width, 1024 - (destX & 1023));
+
+      SpriteFillRow(gpu, destX & 1023, d_y, fill_value, first);
+
+      if(first < width)
+         SpriteFillRow(gpu, 0, d_y, fill_value, width - first);
+   }
+}
+
+static void RasterFill(PS_GPU* gpu, const gpu_raster_job *job)
+{
+   DrawFill(gpu, job->fill.value, job->fill.x, job->fill.y, job->fill.w, job->fill.h);
+}
+
 // Special RAM write mode(16 pixels at a time),
 // does *not* appear to use mask drawing environment settings.
 static void Command_FBFill(PS_GPU* gpu, const uint32 *cb)
 {
-   unsigned y;
    int32_t r                 = cb[0] & 0xFF;
    int32_t g                 = (cb[0] >> 8) & 0xFF;
    int32_t b                 = (cb[0] >> 16) & 0xFF;
@@ -167,25 +238,113 @@ static void Command_FBFill(PS_GPU* gpu, const uint32 *cb)
    //printf("[GPU] FB Fill %d:%d w=%d, h=%d\n", destX, destY, width, height);
    gpu->DrawTimeAvail       -= 46; // Approximate
 
-   for(y = 0; y < height; y++)
+   if(GPU_RasterActive() && width && height)
    {
-      unsigned x;
-      const int32 d_y = (y + destY) & 511;
+      gpu_raster_rect area = { (uint32)destX, (uint32)destY, (uint32)width, (uint32)height };
+      gpu_raster_job *job  = GPU_RasterNewJob(gpu);
 
-      if(LineSkipTest(gpu, d_y))
-         continue;
+      job->draw    = RasterFill;
+      job->fill.value = fill_value;
+      job->fill.x  = destX;
+      job->fill.y  = destY;
+      job->fill.w  = width;
+      job->fill.h  = height;
 
-      gpu->DrawTimeAvail -= (width >> 3) + 9;
+      // Unless it skips every other line, see LineSkipTest()
+      job->overwrite = (gpu->DisplayMode & 0x24) != 0x24 || gpu->dfe;
+
+      GPU_RasterSubmit(&area, NULL, 0);
+   }
+
+   DrawFill(gpu, fill_value, destX, destY, width, height);
+
+   rsx_intf_fill_rect(cb[0], destX, destY, width, height);
+}
 
-      for(x = 0; x < width; x++)
+/* Stores native pixels[0..n) at x, y as whole upscaled blocks, with MaskSetOR,
+ * leaving the blocks with a MaskEvalAND bit set alone; the same as a texel_put()
+ * for each pixel texel_fetch() allows.  x + n mustn't go past the end of the line. */
+static void FBStoreRow(PS_GPU *g, uint32 x, uint32 y, const uint16 *pixels, uint32 n)
+{
+   const uint32 shift    = g->upscale_shift;
+   const uint32 pitch    = 1024 << shift;
+   const uint16 mask_and = g->MaskEvalAND;
+   const uint16 mask_or  = g->MaskSetOR;
+   uint16 *row           = g->vram + ((y << shift) << (10 + shift)) + (x << shift);
+   uint32 i              = 0;
+   unsigned sub;
+
+   if(!shift)
+   {
+#ifdef HAVE_GPU_SIMD
+      const simd_u16 v_and = simd_u16_set1(mask_and);
+      const simd_u16 v_or  = simd_u16_set1(mask_or);
+      const simd_u16 zero  = simd_u16_set1(0);
+
+      for(; i + 8 <= n; i += 8)
       {
-         const int32 d_x = (x + destX) & 1023;
+         simd_u16 old = simd_u16_load(row + i);
+         simd_u16 pix = simd_u16_or(simd_u16_load(pixels + i), v_or);
 
-         texel_put(d_x, d_y, fill_value);
+         simd_u16_store(row + i, simd_u16_select(simd_u16_cmpeq(simd_u16_and(old, v_and), zero), pix, old));
       }
+#endif
+
+      for(; i < n; i++)
+      {
+         if(!(row[i] & mask_and))
+            row[i] = pixels[i] | mask_or;
+      }
+      return;
    }
 
-   rsx_intf_fill_rect(cb[0], destX, destY, width, height);
+   if(mask_and)
+   {
+      // Only the top left pixel of a block is tested
+      for(; i < n; i++)
+      {
+         if(row[i << shift] & mask_and)
+            continue;
+
+         for(sub = 0; sub < UPSCALE(g); sub++)
+            SpriteFillSpan(row + sub * pitch + (i << shift), pixels[i] | mask_or, UPSCALE(g));
+      }
+      return;
+   }
+
+   // Fill the first line of blocks, then copy it to the others
+   for(; i < n; i++)
+      SpriteFillSpan(row + (i << shift), pixels[i] | mask_or, UPSCALE(g));
+
+   for(sub = 1; sub < UPSCALE(g); sub++)
+      memcpy(row + sub * pitch, row, (n << shift) * sizeof(uint16));
+}
+
+/* Copies up to 128 native pixels from s_x, s_y to d_x, d_y, wrapping around
+ * at the end of the lines.  Like texel_fetch()/texel_put(), this copies at 1x:
+ * each source block's top left pixel fills the whole destination block. */
+static void FBCopyChunk(PS_GPU *g, uint32 s_x, uint32 s_y, uint32 d_x, uint32 d_y, uint32 n)
+{
+   const uint32 shift   = g->upscale_shift;
+   const uint32 s_first = std::min<uint32>(n, 1024 - s_x);
+   const uint32 d_first = std::min<uint32>(n, 1024 - d_x);
+   const uint16 *src    = g->vram + ((s_y << shift) << (10 + shift));
+   uint16 tmpbuf[128];
+   uint32 i;
+
+   if(!shift)
+   {
+      memcpy(tmpbuf, src + s_x, s_first * sizeof(uint16));
+      memcpy(tmpbuf + s_first, src, (n - s_first) * sizeof(uint16));
+   }
+   else
+   {
+      for(i = 0; i < n; i++)
+         tmpbuf[i] = src[((s_x + i) & 1023) << shift];
+   }
+
+   FBStoreRow(g, d_x, d_y, tmpbuf, d_first);
+   FBStoreRow(g, 0, d_y, tmpbuf + d_first, n - d_first);
 }
 
 static void Command_FBCopy(PS_GPU* g, const uint32 *cb)
@@ -207,34 +366,33 @@ static void Command_FBCopy(PS_GPU* g, const uint32 *cb)
    InvalidateTexCache(g);
    //printf("FB Copy: %d %d %d %d %d %d\n", sourceX, sourceY, destX, destY, width, height);
 
+   if(GPU_RasterActive())
+   {
+      gpu_raster_rect src = { (uint32)sourceX, (uint32)sourceY, (uint32)width, (uint32)height };
+      gpu_raster_rect dst = { (uint32)destX, (uint32)destY, (uint32)width, (uint32)height };
+
+      GPU_RasterRead(&src);
+      GPU_RasterWrite(&dst);
+   }
+
+   VRAMWriting(g, destX, destY, width, height);
+
    g->DrawTimeAvail -= (width * height) * 2;
+   GPU_PROF_PIXELS(g, width * height);
 
    for(y = 0; y < height; y++)
    {
+      const int32 s_y = (y + sourceY) & 511;
+      const int32 d_y = (y + destY) & 511;
       unsigned x;
 
+      // A chunk is read before it's written, which matters when the
+      // rectangles overlap.  TODO: Check and see if the GPU is actually
+      // (ab)using the CLUT or texture cache.
       for(x = 0; x < width; x += 128)
       {
-         const int32 chunk_x_max = std::min<int32>(width - x, 128);
-         uint16 tmpbuf[128]; // TODO: Check and see if the GPU is actually (ab)using the CLUT or texture cache.
-
-         for(int32 chunk_x = 0; chunk_x < chunk_x_max; chunk_x++)
-         {
-            int32 s_y = (y + sourceY) & 511;
-            int32 s_x = (x + chunk_x + sourceX) & 1023;
-
-            // XXX make upscaling-friendly, as it is we copy at 1x
-            tmpbuf[chunk_x] = texel_fetch(g, s_x, s_y);
-         }
-
-         for(int32 chunk_x = 0; chunk_x < chunk_x_max; chunk_x++)
-         {
-            int32 d_y = (y + destY) & 511;
-            int32 d_x = (x + chunk_x + destX) & 1023;
-
-            if(!(texel_fetch(g, d_x, d_y) & g->MaskEvalAND))
-               texel_put(d_x, d_y, tmpbuf[chunk_x] | g->MaskSetOR);
-         }
+         FBCopyChunk(g, (x + sourceX) & 1023, s_y, (x + destX) & 1023, d_y,
+               std::min<int32>(width - x, 128));
       }
    }
 
@@ -262,6 +420,14 @@ static void Command_FBWrite(PS_GPU* g, const uint32 *cb)
 
    InvalidateTexCache(g);
 
+   if(GPU_RasterActive())
+   {
+      gpu_raster_rect rect = { g->FBRW_X, g->FBRW_Y, g->FBRW_W, g->FBRW_H };
+      GPU_RasterWrite(&rect);
+   }
+
+   VRAMWriting(g, g->FBRW_X, g->FBRW_Y, g->FBRW_W, g->FBRW_H);
+
    if(g->FBRW_W != 0 && g->FBRW_H != 0)
       g->InCmd = INCMD_FBWRITE;
 }
@@ -291,6 +457,12 @@ static void Command_FBRead(PS_GPU* g, const uint32 *cb)
 
    InvalidateTexCache(g);
 
+   if(GPU_RasterActive())
+   {
+      gpu_raster_rect rect = { g->FBRW_X, g->FBRW_Y, g->FBRW_W, g->FBRW_H };
+      GPU_RasterRead(&rect);
+   }
+
    if(g->FBRW_W != 0 && g->FBRW_H != 0)
       g->InCmd = INCMD_FBREAD;
 }
@@ -562,6 +734,19 @@ PS_GPU::PS_GPU(bool pal_clock_and_tv, int sls, int sle, uint8_t upscale_shift)
 
    this->upscale_shift = upscale_shift;
    this->dither_upscale_shift = 0;
+
+   for(unsigned i = 0; i < TEXDECODE_ENTRIES; i++)
+      TexDecode[i].Tag = ~0U;
+   TexDecodeClock = 0;
+   TexDecodeCur   = -1;
+
+   ScanoutRows    = 0;
+   ScanoutColumns = 0;
+
+   RasterLineStride = 1;
+   RasterLinePhase  = 0;
+
+   vram = (uint16 *)(this + 1);
 }
 
 PS_GPU::PS_GPU(const PS_GPU &g, uint8 ushift)
@@ -572,6 +757,17 @@ PS_GPU::PS_GPU(const PS_GPU &g, uint8 ushift)
    // Override the upscaling factor
    upscale_shift = ushift;
 
+   for(unsigned i = 0; i < TEXDECODE_ENTRIES; i++)
+      TexDecode[i].Tag = ~0U;
+
+   ScanoutRows    = 0;
+   ScanoutColumns = 0;
+
+   RasterLineStride = 1;
+   RasterLinePhase  = 0;
+
+   vram = (uint16 *)(this + 1);
+
    //For simplicity we do the transfer at 1x internal resolution.
    for (unsigned y = 0; y < 512; y++)
    {
@@ -620,6 +816,9 @@ void GPU_Destroy(void)
 {
    if(GPU)
    {
+      GPU_RasterStop(GPU);
+      RasterThreads = 0;
+
       GPU->~PS_GPU();
       delete [] (char*)GPU;
    }
@@ -638,9 +837,18 @@ void GPU_Reinit(uint8 ushift)
 {
    // We successfully changed the frontend's resolution, we can
    // apply the change immediately
-   PS_GPU *new_gpu = GPU_Rescale(GPU, ushift);
+   PS_GPU *new_gpu;
+   unsigned threads = RasterThreads;
+
+   // The rasterizer threads' GPU copies point to the old VRAM
+   GPU_RasterStop(GPU);
+   ScanoutFlush(GPU);
+
+   new_gpu = GPU_Rescale(GPU, ushift);
    GPU_Destroy();
    GPU = new_gpu;
+
+   GPU_set_raster_threads(threads);
 }
 
 void GPU_FillVideoParams(MDFNGI* gi)
@@ -762,7 +970,11 @@ void GPU_Power(void)
 {
    PS_GPU *gpu = (PS_GPU*)GPU;
 
+   ScanoutFlush(gpu);
+   GPU_RasterSync();
+
    memset(gpu->vram, 0, 512 * 1024 * UPSCALE(gpu) * UPSCALE(gpu) * sizeof(*gpu->vram));
+   VRAMWriting(gpu, 0, 0, 1024, 512);
 
    memset(gpu->CLUT_Cache, 0, sizeof(gpu->CLUT_Cache));
    gpu->CLUT_Cache_VB = ~0U;
@@ -864,8 +1076,114 @@ void GPU_ResetTS(void)
 {
    PS_GPU *gpu = (PS_GPU*)GPU;
    gpu->lastts = 0;
+
+   // End of the frame
+   ScanoutFlush(gpu);
+
+   // Don't let the rasterizer threads fall behind any further.  In lazy
+   // mode, what nobody looked at may well never need drawing.
+   if(!GPU_RasterLazy())
+      GPU_RasterSync();
+}
+
+
+/* The next n pixels of an FBWrite, a line at a time; stops early once the
+ * rectangle is complete, dropping the rest. */
+static void FBWritePixels(const uint16 *pixels, uint32 n)
+{
+   uint32 i = 0;
+
+#ifdef HAVE_GPU_PROFILER
+   GPU_PROF_Begin(0xA0, true, GPU->DrawTimeAvail);
+#endif
+
+   while(i < n)
+   {
+      const uint32 x = GPU->FBRW_CurX & 1023;
+      uint32 span    = std::min<uint32>(n - i, GPU->FBRW_X + GPU->FBRW_W - GPU->FBRW_CurX);
+
+      span = std::min<uint32>(span, 1024 - x);
+
+      FBStoreRow(GPU, x, GPU->FBRW_CurY & 511, pixels + i, span);
+      GPU_PROF_PIXELS(GPU, span);
+
+      i              += span;
+      GPU->FBRW_CurX += span;
+      if(GPU->FBRW_CurX == (GPU->FBRW_X + GPU->FBRW_W))
+      {
+         GPU->FBRW_CurX = GPU->FBRW_X;
+         GPU->FBRW_CurY++;
+         if(GPU->FBRW_CurY == (GPU->FBRW_Y + GPU->FBRW_H))
+         {
+            /* Upload complete, send over to RSX */
+            rsx_intf_load_image(
+                  GPU->FBRW_X, GPU->FBRW_Y,
+                  GPU->FBRW_W, GPU->FBRW_H,
+                  GPU->vram,
+                  GPU->MaskEvalAND,
+                  GPU->MaskSetOR);
+            GPU->InCmd = INCMD_NONE;
+            break;
+         }
+      }
+   }
+
+#ifdef HAVE_GPU_PROFILER
+   GPU_PROF_End(GPU->DrawTimeAvail);
+#endif
 }
 
+/* The next n pixels of an FBRead, a line at a time.  When the rectangle ends
+ * half way through a word, the pixel after it makes up the other half. */
+static void FBReadPixels(uint16 *pixels, uint32 n)
+{
+   const uint32 shift = GPU->upscale_shift;
+   uint32 i           = 0;
+
+#ifdef HAVE_GPU_PROFILER
+   GPU_PROF_Begin(0xC0, true, GPU->DrawTimeAvail);
+#endif
+
+   while(i < n)
+   {
+      const uint32 x    = GPU->FBRW_CurX & 1023;
+      const uint16 *src = GPU->vram + (((GPU->FBRW_CurY & 511) << shift) << (10 + shift));
+      uint32 span       = 1;
+      uint32 j;
+
+      if(GPU->InCmd == INCMD_FBREAD)
+      {
+         span = std::min<uint32>(n - i, GPU->FBRW_X + GPU->FBRW_W - GPU->FBRW_CurX);
+         span = std::min<uint32>(span, 1024 - x);
+      }
+
+      if(!shift)
+         memcpy(pixels + i, src + x, span * sizeof(uint16));
+      else
+      {
+         for(j = 0; j < span; j++)
+            pixels[i + j] = src[(x + j) << shift];
+      }
+      GPU_PROF_PIXELS(GPU, span);
+
+      i              += span;
+      GPU->FBRW_CurX += span;
+      if(GPU->FBRW_CurX == (GPU->FBRW_X + GPU->FBRW_W))
+      {
+         if((GPU->FBRW_CurY + 1) == (GPU->FBRW_Y + GPU->FBRW_H))
+            GPU->InCmd = INCMD_NONE;
+         else
+         {
+            GPU->FBRW_CurY++;
+            GPU->FBRW_CurX = GPU->FBRW_X;
+         }
+      }
+   }
+
+#ifdef HAVE_GPU_PROFILER
+   GPU_PROF_End(GPU->DrawTimeAvail);
+#endif
+}
 
 static void ProcessFIFO(uint32_t in_count)
 {
@@ -882,34 +1200,13 @@ static void ProcessFIFO(uint32_t in_count)
       case INCMD_NONE:
          break;
       case INCMD_FBWRITE:
-         InData = GPU_BlitterFIFO.Read();
-
-         for(i = 0; i < 2; i++)
          {
-            bool fetch = texel_fetch(GPU, GPU->FBRW_CurX & 1023, GPU->FBRW_CurY & 511) & GPU->MaskEvalAND;
-
-            if (!fetch)
-               texel_put(GPU->FBRW_CurX & 1023, GPU->FBRW_CurY & 511, InData | GPU->MaskSetOR);
+            uint16 pixels[2];
 
-            GPU->FBRW_CurX++;
-            if(GPU->FBRW_CurX == (GPU->FBRW_X + GPU->FBRW_W))
-            {
-               GPU->FBRW_CurX = GPU->FBRW_X;
-               GPU->FBRW_CurY++;
-               if(GPU->FBRW_CurY == (GPU->FBRW_Y + GPU->FBRW_H))
-               {
-                  /* Upload complete, send over to RSX */
-                  rsx_intf_load_image(
-                        GPU->FBRW_X, GPU->FBRW_Y,
-                        GPU->FBRW_W, GPU->FBRW_H,
-                        GPU->vram,
-                        GPU->MaskEvalAND,
-                        GPU->MaskSetOR);
-                  GPU->InCmd = INCMD_NONE;
-                  break;	// Break out of the for() loop.
-               }
-            }
-            InData >>= 16;
+            InData    = GPU_BlitterFIFO.Read();
+            pixels[0] = InData;
+            pixels[1] = InData >> 16;
+            FBWritePixels(pixels, 2);
          }
          return;
 
@@ -956,6 +1253,10 @@ static void ProcessFIFO(uint32_t in_count)
 	   CB[i] = GPU_BlitterFIFO.Read();
    }
 
+#ifdef HAVE_GPU_PROFILER
+   GPU_PROF_Begin(cc, read_fifo, GPU->DrawTimeAvail);
+#endif
+
    if (!read_fifo)
    {
       if(!command->ss_cmd)
@@ -981,6 +1282,10 @@ static void ProcessFIFO(uint32_t in_count)
 	   if (command->func[GPU->abr][GPU->TexMode])
 		   command->func[GPU->abr][GPU->TexMode | (GPU->MaskEvalAND ? 0x4 : 0x0)](GPU, CB);
    }
+
+#ifdef HAVE_GPU_PROFILER
+   GPU_PROF_End(GPU->DrawTimeAvail);
+#endif
 }
 
 static INLINE void GPU_WriteCB(uint32_t InData, uint32_t addr)
@@ -1194,29 +1499,11 @@ void GPU_WriteDMA(uint32_t V, uint32 addr)
 
 static INLINE uint32_t GPU_ReadData(void)
 {
-   unsigned i;
+   uint16 pixels[2];
 
-   GPU->DataReadBufferEx = 0;
+   FBReadPixels(pixels, 2);
 
-   for(i = 0; i < 2; i++)
-   {
-      GPU->DataReadBufferEx |=
-         texel_fetch(GPU,
-               GPU->FBRW_CurX & 1023,
-               GPU->FBRW_CurY & 511) << (i * 16);
-
-      GPU->FBRW_CurX++;
-      if(GPU->FBRW_CurX == (GPU->FBRW_X + GPU->FBRW_W))
-      {
-         if((GPU->FBRW_CurY + 1) == (GPU->FBRW_Y + GPU->FBRW_H))
-            GPU->InCmd = INCMD_NONE;
-         else
-         {
-            GPU->FBRW_CurY++;
-            GPU->FBRW_CurX = GPU->FBRW_X;
-         }
-      }
-   }
+   GPU->DataReadBufferEx = pixels[0] | (pixels[1] << 16);
 
    return GPU->DataReadBufferEx;
 }
@@ -1228,6 +1515,60 @@ uint32_t GPU_ReadDMA(void)
    return GPU_ReadData();
 }
 
+uint32 GPU_DMABlockWords(bool write)
+{
+   uint32 pixels;
+
+   if(write ? (GPU->InCmd != INCMD_FBWRITE || GPU_BlitterFIFO.in_count) : GPU->InCmd != INCMD_FBREAD)
+      return 0;
+
+   pixels = (GPU->FBRW_Y + GPU->FBRW_H - GPU->FBRW_CurY - 1) * GPU->FBRW_W +
+      GPU->FBRW_X + GPU->FBRW_W - GPU->FBRW_CurX;
+
+   return (pixels + 1) >> 1;
+}
+
+void GPU_WriteDMABlock(const uint32 *data, uint32 count)
+{
+   while(count)
+   {
+      uint16 pixels[512];
+      const uint32 chunk = std::min<uint32>(count, 256);
+      uint32 i;
+
+      for(i = 0; i < chunk; i++)
+      {
+         pixels[i * 2 + 0] = data[i];
+         pixels[i * 2 + 1] = data[i] >> 16;
+      }
+
+      FBWritePixels(pixels, chunk * 2);
+
+      data  += chunk;
+      count -= chunk;
+   }
+}
+
+void GPU_ReadDMABlock(uint32 *data, uint32 count)
+{
+   while(count)
+   {
+      uint16 pixels[512];
+      const uint32 chunk = std::min<uint32>(count, 256);
+      uint32 i;
+
+      FBReadPixels(pixels, chunk * 2);
+
+      for(i = 0; i < chunk; i++)
+         data[i] = pixels[i * 2 + 0] | (pixels[i * 2 + 1] << 16);
+
+      GPU->DataReadBufferEx = data[chunk - 1];
+
+      data  += chunk;
+      count -= chunk;
+   }
+}
+
 uint32_t GPU_Read(const int32_t timestamp, uint32_t A)
 {
    uint32_t ret = 0;
@@ -1298,50 +1639,306 @@ uint32_t GPU_Read(const int32_t timestamp, uint32_t A)
    return(ret >> ((A & 3) * 8));
 }
 
+// Converts count 15bpp pixels, none wrapping around the end of the VRAM line.
+static INLINE void ReorderRGB15(const uint16_t *src, surface_pixel *dest, int32 count)
+{
+   int32 x = 0;
+
+#if defined(HAVE_GPU_SIMD) && SURFACE_BPP == 16
+   const simd_u16 rb_mask = simd_u16_set1(0x001F);
+   const simd_u16 g_mask  = simd_u16_set1(0x03E0);
+
+   for(; x + 8 <= count; x += 8)
+   {
+      simd_u16 p = simd_u16_load(src + x);
+
+      simd_u16_store(dest + x, simd_u16_or(simd_u16_or(
+                  simd_u16_sll<RED_SHIFT>(simd_u16_and(p, rb_mask)),
+                  simd_u16_sll<GREEN_SHIFT + 1 - 5>(simd_u16_and(p, g_mask))),
+               simd_u16_and(simd_u16_srl<10 - BLUE_SHIFT>(p), rb_mask)));
+   }
+#elif defined(HAVE_GPU_SIMD)
+   const simd_s32 r_mask = simd_s32_set1(0x001F);
+   const simd_s32 g_mask = simd_s32_set1(0x03E0);
+   const simd_s32 b_mask = simd_s32_set1(0x7C00);
+
+   for(; x + 8 <= count; x += 8)
+   {
+      simd_u16 pix = simd_u16_load(src + x);
+      simd_s32 p[2] = { simd_u16_widen_lo(pix), simd_u16_widen_hi(pix) };
+
+      for(unsigned i = 0; i < 2; i++)
+      {
+         simd_s32 color = simd_s32_or(simd_s32_or(
+                  simd_s32_sll<RED_SHIFT + 3>(simd_s32_and(p[i], r_mask)),
+                  simd_s32_sll<GREEN_SHIFT + 3 - 5>(simd_s32_and(p[i], g_mask))),
+               simd_u32_srl<10 - 3 - BLUE_SHIFT>(simd_s32_and(p[i], b_mask)));
+
+         simd_s32_store((int32_t*)dest + x + i * 4, color);
+      }
+   }
+#endif
+
+   for(; x < count; x++)
+   {
+      uint32_t srcpix = src[x];
+      dest[x] = MAKECOLOR(
+            (((srcpix >> 0) & 0x1F) << 3),
+            (((srcpix >> 5) & 0x1F) << 3),
+            (((srcpix >> 10) & 0x1F) << 3),
+            0);
+   }
+}
+
+// One 24bpp pixel, fb_x in upscaled bytes.  The second halfword isn't wrapped around the
+// line, like it never was.
+static INLINE surface_pixel ReorderRGB24_Pixel(const uint16_t *src, int32 fb_x,
+      unsigned upscale_shift, int32_t fb_mask)
+{
+   uint32_t srcpix = src[(fb_x >> 1) + 0]
+      | (src[((fb_x >> 1) + (1 << upscale_shift)) & fb_mask] << 16);
+   srcpix >>= ((fb_x >> upscale_shift) & 1) * 8;
+
+   return MAKECOLOR(((srcpix >> 0) & 0xFF), ((srcpix >> 8) & 0xFF), ((srcpix >> 16) & 0xFF), 0);
+}
+
+#if defined(HAVE_GPU_SIMD) && !defined(MSB_FIRST)
+// Surface pixels for 4 lanes of packed 24bpp(R in the low byte, top byte ignored)
+static INLINE simd_s32 ConvertRGB24(simd_s32 p)
+{
+#if SURFACE_BPP == 16
+   return simd_s32_or(simd_s32_or(
+            simd_s32_sll<RED_SHIFT - 3>(simd_s32_and(p, simd_s32_set1(0x0000F8))),
+            simd_u32_srl<10 - GREEN_SHIFT>(simd_s32_and(p, simd_s32_set1(0x00FC00)))),
+         simd_s32_and(simd_u32_srl<19 - BLUE_SHIFT>(p), simd_s32_set1(0x1F)));
+#else
+   return simd_s32_or(simd_s32_or(
+            simd_s32_sll<RED_SHIFT>(simd_s32_and(p, simd_s32_set1(0x0000FF))),
+            simd_s32_and(p, simd_s32_set1(0x00FF00))),
+         simd_s32_and(simd_u32_srl<16 - BLUE_SHIFT>(p), simd_s32_set1(0xFF)));
+#endif
+}
+#endif
+
+// Each source pixel is repeated across (1 << upscale_shift) output pixels; a constant
+// shift lets that loop unroll into straight stores.
+template<unsigned upscale_shift>
+static INLINE void ReorderRGB24(const uint16_t *src, surface_pixel *dest,
+      const int32 dx_start, const int32 dx_end, int32 fb_x)
+{
+   const unsigned upscale = 1 << upscale_shift;
+   const int32_t fb_mask  = ((0x7FF << upscale_shift) + upscale - 1);
+   int32 x = dx_start;
+
+#if defined(HAVE_GPU_SIMD) && !defined(MSB_FIRST)
+   // Natively the line is just packed bytes, 8 pixels per two 16 byte loads as long as
+   // that doesn't run off the end of it.
+   if(upscale_shift == 0)
+   {
+      const uint8_t *bytes = (const uint8_t*)src;
+
+      for(; x + 8 <= dx_end; x += 8)
+      {
+         simd_s32 lo, hi;
+
+         if(fb_x + 28 > 2048)
+            break;
+
+         lo = ConvertRGB24(simd_s32_load_rgb24(bytes + fb_x));
+         hi = ConvertRGB24(simd_s32_load_rgb24(bytes + fb_x + 12));
+#if SURFACE_BPP == 16
+         simd_u16_store(dest + x, simd_s32_narrow(lo, hi));
+#else
+         simd_s32_store((int32_t*)dest + x, lo);
+         simd_s32_store((int32_t*)dest + x + 4, hi);
+#endif
+         fb_x += 24;
+      }
+   }
+#endif
+
+   for(; x < dx_end; x += upscale)
+   {
+      surface_pixel color = ReorderRGB24_Pixel(src, fb_x, upscale_shift, fb_mask);
+
+      for(unsigned i = 0; i < upscale; i++)
+         dest[x + i] = color;
+
+      fb_x = (fb_x + (3 << upscale_shift)) & fb_mask;
+   }
+}
+
 static INLINE void ReorderRGB_Var(uint32_t out_Rshift,
       uint32_t out_Gshift, uint32_t out_Bshift,
-      bool bpp24, const uint16_t *src, uint32_t *dest,
+      bool bpp24, const uint16_t *src, surface_pixel *dest,
       const int32 dx_start, const int32 dx_end, int32 fb_x,
       unsigned upscale_shift, unsigned upscale)
 {
-  int32_t fb_mask = ((0x7FF << upscale_shift) + upscale - 1);
-
    if(bpp24)	// 24bpp
    {
-      for(int32 x = dx_start; x < dx_end; x+= upscale)
+      switch(upscale_shift)
       {
-         int i;
-         uint32_t color;
-         uint32_t srcpix = src[(fb_x >> 1) + 0]
-            | (src[((fb_x >> 1) + (1 << upscale_shift)) & fb_mask] << 16);
-         srcpix >>= ((fb_x >> upscale_shift) & 1) * 8;
+         case 0: ReorderRGB24<0>(src, dest, dx_start, dx_end, fb_x); break;
+         case 1: ReorderRGB24<1>(src, dest, dx_start, dx_end, fb_x); break;
+         case 2: ReorderRGB24<2>(src, dest, dx_start, dx_end, fb_x); break;
+         case 3: ReorderRGB24<3>(src, dest, dx_start, dx_end, fb_x); break;
+         default:
+         {
+            int32_t fb_mask = ((0x7FF << upscale_shift) + upscale - 1);
 
-         color =   (((srcpix >> 0) << RED_SHIFT)   & (0xFF << RED_SHIFT))
-            | (((srcpix >> 8) << GREEN_SHIFT) & (0xFF << GREEN_SHIFT))
-            | (((srcpix >> 16) << BLUE_SHIFT) & (0xFF << BLUE_SHIFT));
+            for(int32 x = dx_start; x < dx_end; x+= upscale)
+            {
+               surface_pixel color = ReorderRGB24_Pixel(src, fb_x, upscale_shift, fb_mask);
 
-         for (i = 0; i < upscale; i++)
-            dest[x + i] = color;
+               for (unsigned i = 0; i < upscale; i++)
+                  dest[x + i] = color;
 
-         fb_x = (fb_x + (3 << upscale_shift)) & fb_mask;
+               fb_x = (fb_x + (3 << upscale_shift)) & fb_mask;
+            }
+         }
+         break;
       }
    }				// 15bpp
    else
    {
-      for(int32 x = dx_start; x < dx_end; x++)
+      // Consecutive pixels, wrapping around at the end of the VRAM line
+      const int32 line_w = 0x400 << upscale_shift;
+      int32 sx = fb_x >> 1;
+      int32 x  = dx_start;
+
+      while(x < dx_end)
       {
-         uint32_t srcpix = src[(fb_x >> 1)];
-         dest[x] = MAKECOLOR(
-               (((srcpix >> 0) & 0x1F) << 3),
-               (((srcpix >> 5) & 0x1F) << 3),
-               (((srcpix >> 10) & 0x1F) << 3),
-               0);
-
-         fb_x = (fb_x + 2) & fb_mask;
+         int32 count = std::min<int32>(dx_end - x, line_w - sx);
+
+         ReorderRGB15(src + sx, dest + x, count);
+
+         x  += count;
+         sx  = 0;
       }
    }
 }
 
+// A visible line as GPU_Update() found it when the beam got there, in
+// native coordinates.
+struct scanout_line
+{
+   uint32 y;            // VRAM line read out
+   int32 dest_line;     // Surface line
+   int32 dx_start, dx_end;
+   int32 fb_x;
+   uint32 dmw;
+   bool rgb24;
+};
+
+// Lines waiting to be output, see ScanoutDefer()
+#define SCANOUT_MAX_LINES 1024
+
+static scanout_line ScanoutLines[SCANOUT_MAX_LINES];
+static unsigned ScanoutCount = 0;
+
+static void ScanoutLineRect(const scanout_line *line, gpu_raster_rect *rect)
+{
+   const uint32 n = line->dx_end - line->dx_start;
+
+   rect->x = (uint32)(line->fb_x >> 1);
+   rect->y = line->y;
+   rect->w = line->rgb24 ? n * 3 / 2 + 2 : n;
+   rect->h = 1;
+}
+
+// Converts a line to the surface; returns the last(upscaled) surface line written.
+static surface_pixel *ScanoutLine(PS_GPU *gpu, const scanout_line *line)
+{
+   surface_pixel *dest = NULL;
+
+   if(GPU_RasterActive() && line->dx_end > line->dx_start)
+   {
+      gpu_raster_rect rect;
+
+      ScanoutLineRect(line, &rect);
+      GPU_RasterRead(&rect);
+   }
+
+   // Convert the necessary variables to the upscaled version
+   uint32_t y        = line->y << gpu->upscale_shift;
+   uint32_t udmw     = line->dmw      << gpu->upscale_shift;
+   int32 udx_start   = line->dx_start << gpu->upscale_shift;
+   int32 udx_end     = line->dx_end   << gpu->upscale_shift;
+   int32 ufb_x       = line->fb_x     << gpu->upscale_shift;
+   unsigned _upscale = UPSCALE(gpu);
+
+   for (uint32_t i = 0; i < _upscale; i++)
+   {
+      const uint16_t *src = gpu->vram +
+         ((y + i) << (10 + gpu->upscale_shift));
+
+      dest = gpu->surface->pixels +
+         ((line->dest_line << gpu->upscale_shift) + i) * gpu->surface->pitch32;
+      memset(dest, 0, udx_start * sizeof(surface_pixel));
+
+      ReorderRGB_Var(
+            RED_SHIFT,
+            GREEN_SHIFT,
+            BLUE_SHIFT,
+            line->rgb24,
+            src,
+            dest,
+            udx_start,
+            udx_end,
+            ufb_x,
+            gpu->upscale_shift,
+            _upscale);
+
+      if(udmw > (uint32_t)udx_end)
+         memset(dest + udx_end, 0, (udmw - udx_end) * sizeof(surface_pixel));
+   }
+
+   return dest;
+}
+
+/* Outputs the deferred lines.  Called at the end of the frame, and before
+ * anything writes VRAM they read(see ScanoutWriting()) or changes how
+ * they're output. */
+static void ScanoutFlush(PS_GPU *gpu)
+{
+   unsigned i;
+
+   for(i = 0; i < ScanoutCount; i++)
+      ScanoutLine(gpu, &ScanoutLines[i]);
+
+   ScanoutCount        = 0;
+   gpu->ScanoutRows    = 0;
+   gpu->ScanoutColumns = 0;
+}
+
+/* Unless the light guns need to look at the line right away, a visible
+ * line is only recorded here, and all of them get converted in one pass
+ * over VRAM later on.  That keeps the conversion out of the way of the CPU
+ * emulation, and it sees VRAM exactly as it was when the line went out,
+ * since whatever writes to it has to flush the lines first. */
+static void ScanoutDefer(PS_GPU *gpu, const scanout_line *line)
+{
+   if(ScanoutCount == SCANOUT_MAX_LINES)
+      ScanoutFlush(gpu);
+
+   ScanoutLines[ScanoutCount++] = *line;
+
+   if(line->dx_end > line->dx_start)
+   {
+      gpu_raster_rect rect;
+
+      ScanoutLineRect(line, &rect);
+
+      gpu->ScanoutRows    |= RasterTileSpan(rect.y, rect.h, 512, SCANOUT_TILE_SHIFT);
+      gpu->ScanoutColumns |= RasterTileSpan(rect.x, rect.w, 1024, SCANOUT_TILE_SHIFT);
+   }
+}
+
+void GPU_ScanoutWriting(const gpu_raster_rect *area)
+{
+   ScanoutWriting(GPU, area);
+}
+
 int32_t GPU_Update(const int32_t sys_timestamp)
 {
    int32 gpu_clocks;
@@ -1478,6 +2075,8 @@ int32_t GPU_Update(const int32_t sys_timestamp)
 
                if (rsx_intf_is_type() == RSX_SOFTWARE && gpu->espec)
                {
+                  ScanoutFlush(gpu);
+
                   if((bool)(gpu->DisplayMode & DISP_PAL) != gpu->HardwarePALType)
                   {
                      gpu->DisplayRect->x = 0;
@@ -1487,11 +2086,11 @@ int32_t GPU_Update(const int32_t sys_timestamp)
 
                      for(int32 y = 0; y < gpu->DisplayRect->h; y++)
                      {
-                        uint32_t *dest = gpu->surface->pixels + y * gpu->surface->pitch32;
+                        surface_pixel *dest = gpu->surface->pixels + y * gpu->surface->pitch32;
 
                         gpu->LineWidths[y] = 384;
 
-                        memset(dest, 0, 384 * sizeof(int32));
+                        memset(dest, 0, 384 * sizeof(surface_pixel));
                      }
 
                      //char buffer[256];
@@ -1592,7 +2191,7 @@ int32_t GPU_Update(const int32_t sys_timestamp)
             unsigned pix_clock_offset = 0;
             unsigned pix_clock = 0;
             unsigned pix_clock_div = 0;
-            uint32_t *dest = NULL;
+            surface_pixel *dest = NULL;
 
             if(      (bool)(gpu->DisplayMode & DISP_PAL) == gpu->HardwarePALType
                   && gpu->scanline >= FirstVisibleLine
@@ -1630,49 +2229,28 @@ int32_t GPU_Update(const int32_t sys_timestamp)
 
                //printf("dx_start base: %d, dmw: %d\n", dx_start, dmw);
 
-               if (rsx_intf_is_type() == RSX_SOFTWARE)
+               // Nothing to output for skipped frames
+               if (rsx_intf_is_type() == RSX_SOFTWARE && !gpu->espec->skip)
                {
-                  // Convert the necessary variables to the upscaled version
-                  uint32_t x;
-                  uint32_t y        = gpu->DisplayFB_CurLineYReadout << gpu->upscale_shift;
-                  uint32_t udmw     = dmw      << gpu->upscale_shift;
-                  int32 udx_start   = dx_start << gpu->upscale_shift;
-                  int32 udx_end     = dx_end   << gpu->upscale_shift;
-                  int32 ufb_x       = fb_x     << gpu->upscale_shift;
-                  unsigned _upscale = UPSCALE(gpu);
-
-                  for (uint32_t i = 0; i < _upscale; i++)
+                  scanout_line line;
+
+                  line.y         = gpu->DisplayFB_CurLineYReadout;
+                  line.dest_line = dest_line;
+                  line.dx_start  = dx_start;
+                  line.dx_end    = dx_end;
+                  line.fb_x      = fb_x;
+                  line.dmw       = dmw;
+                  line.rgb24     = gpu->DisplayMode & DISP_RGB24;
+
+                  // A CPU to VRAM transfer in progress only marks VRAM as
+                  // written when it starts, so it's just output right away.
+                  if(PSX_GPULineHookNeedsPixels() || (gpu->InCmd & INCMD_FBWRITE))
                   {
-                     const uint16_t *src = gpu->vram +
-                        ((y + i) << (10 + gpu->upscale_shift));
-
-                     // printf("surface: %dx%d (%d) %u %u + %u\n",
-                     // 	   surface->w, surface->h, surface->pitchinpix,
-                     // 	   dest_line, y, i);
-
-                     dest = gpu->surface->pixels +
-                        ((dest_line << gpu->upscale_shift) + i) * gpu->surface->pitch32;
-                     memset(dest, 0, udx_start * sizeof(int32));
-
-                     //printf("%d %d %d - %d %d\n", scanline, dx_start, dx_end, HorizStart, HorizEnd);
-                     ReorderRGB_Var(
-                           RED_SHIFT,
-                           GREEN_SHIFT,
-                           BLUE_SHIFT,
-                           gpu->DisplayMode & DISP_RGB24,
-                           src,
-                           dest,
-                           udx_start,
-                           udx_end,
-                           ufb_x,
-                           gpu->upscale_shift,
-                           _upscale);
-
-                     //printf("dx_end: %d, dmw: %d\n", udx_end, udmw);
-                     //
-                     for(x = udx_end; x < udmw; x++)
-                        dest[x] = 0;
+                     ScanoutFlush(gpu);
+                     dest = ScanoutLine(gpu, &line);
                   }
+                  else
+                     ScanoutDefer(gpu, &line);
                }
 
                //if(gpu->scanline == 64)
@@ -1731,6 +2309,21 @@ void GPU_StartFrame(EmulateSpecStruct *espec_arg)
    gpu->surface         = gpu->espec->surface;
    gpu->DisplayRect     = &gpu->espec->DisplayRect;
    gpu->LineWidths      = gpu->espec->LineWidths;
+
+   // A frame that won't be shown only needs drawing as far as something
+   // reads VRAM back.  Lazy mode stays on while frames keep being skipped
+   // (fast-forward, runahead, headless runs; frameskip never shows two in a
+   // row), and goes once two frames in a row are shown.
+   if(gpu->espec->skip && !RasterThreads && !GPU_RasterLazy() &&
+         rsx_intf_is_type() == RSX_SOFTWARE)
+   {
+      ScanoutFlush(gpu);
+      GPU_RasterStartLazy(gpu);
+   }
+   else if(!gpu->espec->skip && !PrevFrameSkipped && GPU_RasterLazy())
+      GPU_RasterStop(gpu);
+
+   PrevFrameSkipped = gpu->espec->skip;
 }
 
 uint32 TexCache_Tag[256];
@@ -1845,6 +2438,9 @@ int GPU_StateAction(StateMem *sm, int load, int data_only)
 {
    PS_GPU *gpu      = (PS_GPU*)GPU;
 
+   ScanoutFlush(gpu);
+   GPU_RasterSync();
+
    GPU_RestoreStateP1(load);
 
    SFORMAT StateRegs[] =
@@ -1973,7 +2569,10 @@ int GPU_StateAction(StateMem *sm, int load, int data_only)
    GPU_RestoreStateP2(load);
 
    if(load)
+   {
       GPU_RestoreStateP3();
+      VRAMWriting(gpu, 0, 0, 1024, 512);
+   }
 
    return(ret);
 }
@@ -2014,6 +2613,75 @@ uint8 GPU_get_upscale_shift(void)
    return gpu->upscale_shift;
 }
 
+void GPU_set_raster_threads(unsigned count)
+{
+   // The hardware renderers don't draw anything here
+   if (rsx_intf_is_type() != RSX_SOFTWARE)
+      count = 0;
+
+   if (count == RasterThreads)
+      return;
+
+   // The threads' copies of the GPU can't have lines to output
+   ScanoutFlush(GPU);
+
+   RasterThreads = count;
+   GPU_RasterStart(GPU, count);
+}
+
+unsigned GPU_get_raster_threads(void)
+{
+   return RasterThreads;
+}
+
+void GPU_RasterSaveState(const PS_GPU *gpu, gpu_raster_state *state)
+{
+   state->ClipX0               = gpu->ClipX0;
+   state->ClipY0               = gpu->ClipY0;
+   state->ClipX1               = gpu->ClipX1;
+   state->ClipY1               = gpu->ClipY1;
+   state->MaskSetOR            = gpu->MaskSetOR;
+   state->TexPageX             = gpu->TexPageX;
+   state->TexPageY             = gpu->TexPageY;
+   state->tww                  = gpu->tww;
+   state->twh                  = gpu->twh;
+   state->twx                  = gpu->twx;
+   state->twy                  = gpu->twy;
+   state->dtd                  = gpu->dtd;
+   state->dfe                  = gpu->dfe;
+   state->dither_upscale_shift = gpu->dither_upscale_shift;
+   state->DisplayMode          = gpu->DisplayMode;
+   state->DisplayFB_YStart     = gpu->DisplayFB_YStart;
+   state->field_ram_readout    = gpu->field_ram_readout;
+}
+
+void GPU_RasterLoadState(PS_GPU *gpu, const gpu_raster_state *state)
+{
+   bool tex_window_changed = state->tww != gpu->tww || state->twh != gpu->twh ||
+      state->twx != gpu->twx || state->twy != gpu->twy;
+
+   gpu->ClipX0               = state->ClipX0;
+   gpu->ClipY0               = state->ClipY0;
+   gpu->ClipX1               = state->ClipX1;
+   gpu->ClipY1               = state->ClipY1;
+   gpu->MaskSetOR            = state->MaskSetOR;
+   gpu->TexPageX             = state->TexPageX;
+   gpu->TexPageY             = state->TexPageY;
+   gpu->tww                  = state->tww;
+   gpu->twh                  = state->twh;
+   gpu->twx                  = state->twx;
+   gpu->twy                  = state->twy;
+   gpu->dtd                  = state->dtd;
+   gpu->dfe                  = state->dfe;
+   gpu->dither_upscale_shift = state->dither_upscale_shift;
+   gpu->DisplayMode          = state->DisplayMode;
+   gpu->DisplayFB_YStart     = state->DisplayFB_YStart;
+   gpu->field_ram_readout    = state->field_ram_readout;
+
+   if(tex_window_changed)
+      gpu->RecalcTexWindowStuff();
+}
+
 bool GPU_DMACanWrite(void)
 {
    return CalcFIFOReadyBit();
@@ -2022,16 +2690,20 @@ bool GPU_DMACanWrite(void)
 uint16 *GPU_get_vram(void)
 {
    PS_GPU *gpu = (PS_GPU*)GPU;
+   GPU_RasterSync();
    return gpu->vram;
 }
 
 uint16 GPU_PeekRAM(uint32 A)
 {
+   GPU_RasterSync();
    return texel_fetch(GPU, A & 0x3FF, (A >> 10) & 0x1FF);
 }
 
 void GPU_PokeRAM(uint32 A, uint16 V)
 {
+   GPU_RasterSync();
+   VRAMWriting(GPU, A & 0x3FF, (A >> 10) & 0x1FF, 1, 1);
    texel_put(A & 0x3FF, (A >> 10) & 0x1FF, V);
 }
 
@@ -27,6 +27,12 @@
 #define DISP_RGB24      0x10
 #define DISP_INTERLACED 0x20
 
+// Number of decoded texture pages kept per GPU(see PS_GPU::TexDecode)
+#define TEXDECODE_ENTRIES 8
+
+// Tiles PS_GPU::ScanoutRows/ScanoutColumns track: 16x16 native texels
+#define SCANOUT_TILE_SHIFT 4
+
 enum dither_mode
 {
    DITHER_NATIVE   = 0,
@@ -218,12 +224,39 @@ class PS_GPU
          uint32 Tag;
       } TexCache[256];
 
+      // 4bpp/8bpp texture pages with their CLUT already applied, for the
+      // rasterizer(see SelectTexDecode() in gpu_common.h).  Derived from VRAM,
+      // so not saved in save states.  Data is indexed by the texture window
+      // mapped v and u, and filled in 32 texel pieces of a row at a time as
+      // primitives need them; Valid has a bit per piece.
+      struct
+      {
+         uint32 Tag;	// TexDecodeTag(), ~0U when unused
+         uint32 LastUse;
+         uint8 Valid[256];
+         uint16 Data[256][256];
+      } TexDecode[TEXDECODE_ENTRIES];
+      uint32 TexDecodeClock;
+      int32 TexDecodeCur;	// Entry for the primitive being drawn, -1 for none
+
+      // VRAM tiles(rows and columns, see RasterTileSpan()) read by the display
+      // lines still waiting to be output; see ScanoutDefer().
+      uint64 ScanoutRows;
+      uint64 ScanoutColumns;
+
       uint8_t DitherLUT[4][4][512];	// Y, X, 8-bit source value(256 extra for saturation)
-      // "Flexible" array at the end of the struct. This lets us
-      // having a dynamically sized vram (depending on the internal
-      // upscaling ratio) without having an additional level of
-      // indirection since it'll be allocated right after the struct
-      uint16 vram[0];
+
+      // Rasterizer line ownership, used by the rasterizer threads(see
+      // gpu_threads.h): only native VRAM lines for which
+      // (y % RasterLineStride) == RasterLinePhase get drawn.  Normally 1 and 0.
+      uint32 RasterLineStride;
+      uint32 RasterLinePhase;
+
+      // The vram (whose size depends on the internal upscaling ratio)
+      // is allocated right after the struct. It's accessed through a
+      // pointer so that the rasterizer threads' copies of the GPU state
+      // can share it.
+      uint16 *vram;
 };
 
 uint16 *GPU_get_vram(void);
@@ -232,6 +265,14 @@ void GPU_WriteDMA(uint32 V, uint32 addr);
 
 uint32_t GPU_ReadDMA(void);
 
+// Image data for DMA channel 2, moved a line at a time: how many words of the
+// FBWrite/FBRead in progress can go through GPU_WriteDMABlock()/GPU_ReadDMABlock()
+// right now(0 if they have to go word by word), which then do the same as that many
+// GPU_WriteDMA()/GPU_ReadDMA() calls.
+uint32 GPU_DMABlockWords(bool write);
+void GPU_WriteDMABlock(const uint32 *data, uint32 count);
+void GPU_ReadDMABlock(uint32 *data, uint32 count);
+
 bool GPU_DMACanWrite(void);
 
 uint8 GPU_get_dither_upscale_shift(void);
@@ -242,6 +283,10 @@ uint8 GPU_get_upscale_shift(void);
 
 void GPU_set_upscale_shift(uint8 factor);
 
+unsigned GPU_get_raster_threads(void);
+
+void GPU_set_raster_threads(unsigned count);
+
 void GPU_set_display_change_count(unsigned a);
 
 unsigned GPU_get_display_change_count(void);
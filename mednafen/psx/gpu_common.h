@@ -68,6 +68,61 @@ static INLINE void PlotPixelBlend(uint16_t bg_pix, uint16_t *fore_pix)
 
 }
 
+#ifdef HAVE_GPU_SIMD
+/* PlotPixelBlend() on 4 pixels widened to 32 bits, the same
+ * arithmetic lane for lane. */
+template<int BlendMode>
+static INLINE simd_s32 PlotPixelBlend_SIMD32(simd_s32 bg_pix, simd_s32 fore_pix)
+{
+   simd_s32 sum, carry;
+
+   switch(BlendMode)
+   {
+      case BLEND_MODE_AVERAGE:
+         bg_pix   = simd_s32_or(bg_pix, simd_s32_set1(0x8000));
+         fore_pix = simd_u32_srl<1>(simd_s32_sub(simd_s32_add(fore_pix, bg_pix),
+                  simd_s32_and(simd_s32_xor(fore_pix, bg_pix), simd_s32_set1(0x0421))));
+         break;
+
+      case BLEND_MODE_ADD_FOURTH:
+         fore_pix = simd_s32_or(simd_s32_and(simd_u32_srl<2>(fore_pix), simd_s32_set1(0x1CE7)), simd_s32_set1(0x8000));
+         /* fall through */
+      case BLEND_MODE_ADD:
+         bg_pix   = simd_s32_and(bg_pix, simd_s32_set1(0x7FFF));
+         sum      = simd_s32_add(fore_pix, bg_pix);
+         carry    = simd_s32_and(simd_s32_sub(sum, simd_s32_and(simd_s32_xor(fore_pix, bg_pix), simd_s32_set1(0x8421))),
+               simd_s32_set1(0x8420));
+         fore_pix = simd_s32_or(simd_s32_sub(sum, carry), simd_s32_sub(carry, simd_u32_srl<5>(carry)));
+         break;
+
+      case BLEND_MODE_SUBTRACT:
+         {
+            simd_s32 diff, borrow;
+
+            bg_pix   = simd_s32_or(bg_pix, simd_s32_set1(0x8000));
+            fore_pix = simd_s32_and(fore_pix, simd_s32_set1(0x7FFF));
+            diff     = simd_s32_add(simd_s32_sub(bg_pix, fore_pix), simd_s32_set1(0x108420));
+            borrow   = simd_s32_and(simd_s32_sub(diff, simd_s32_and(simd_s32_xor(bg_pix, fore_pix), simd_s32_set1(0x108420))),
+                  simd_s32_set1(0x108420));
+            fore_pix = simd_s32_and(simd_s32_sub(diff, borrow), simd_s32_sub(borrow, simd_u32_srl<5>(borrow)));
+         }
+         break;
+   }
+
+   return fore_pix;
+}
+
+/* PlotPixelBlend() on 8 pixels, all of which have bit 15 set. */
+template<int BlendMode>
+static INLINE simd_u16 PlotPixelBlend_SIMD(simd_u16 bg_pix, simd_u16 fore_pix)
+{
+   simd_s32 lo = PlotPixelBlend_SIMD32<BlendMode>(simd_u16_widen_lo(bg_pix), simd_u16_widen_lo(fore_pix));
+   simd_s32 hi = PlotPixelBlend_SIMD32<BlendMode>(simd_u16_widen_hi(bg_pix), simd_u16_widen_hi(fore_pix));
+
+   return simd_s32_narrow(lo, hi);
+}
+#endif
+
 template<int BlendMode, bool MaskEval_TA, bool textured>
 static INLINE void PlotPixel(PS_GPU *gpu, int32_t x, int32_t y, uint16_t fore_pix)
 {
@@ -123,6 +178,12 @@ static INLINE void Update_CLUT_Cache(PS_GPU *gpu, uint16 raw_clut)
          const uint32_t cxo = (raw_clut & 0x3F) << 4;
          const uint32_t count = (TexMode_TA ? 256 : 16);
 
+         if(GPU_RasterActive())
+         {
+            gpu_raster_rect rect = { cxo, y, count, 1 };
+            GPU_RasterRead(&rect);
+         }
+
          gpu->DrawTimeAvail -= count;
 
          for(i = 0; i < count; i++)
@@ -251,6 +312,257 @@ static INLINE bool LineSkipTest(PS_GPU* g, unsigned y)
    return false;
 }
 
+/* Whether this copy of the GPU draws native VRAM line y(see RasterLineStride) */
+static INLINE bool RasterLineOwned(const PS_GPU *g, uint32_t y)
+{
+   if(g->RasterLineStride == 1)
+      return g->RasterLinePhase == 0;
+
+   return (y % g->RasterLineStride) == g->RasterLinePhase;
+}
+
+/* VRAM area a primitive spanning native x0..x1, y0..y1 can draw to,
+ * false if none of it is inside the drawing area. */
+static INLINE bool RasterDrawArea(PS_GPU *gpu, int32_t x0, int32_t y0, int32_t x1, int32_t y1, gpu_raster_rect *rect)
+{
+   if(x0 < gpu->ClipX0)
+      x0 = gpu->ClipX0;
+   if(y0 < gpu->ClipY0)
+      y0 = gpu->ClipY0;
+   if(x1 > gpu->ClipX1)
+      x1 = gpu->ClipX1;
+   if(y1 > gpu->ClipY1)
+      y1 = gpu->ClipY1;
+
+   if(x0 > x1 || y0 > y1)
+      return false;
+
+   rect->x = x0;
+   rect->y = y0;
+   rect->w = x1 - x0 + 1;
+   rect->h = y1 - y0 + 1;
+
+   return true;
+}
+
+/* VRAM area of the current texture page.  Interpolated coordinates
+ * can stray outside of the vertices' range, so take all of it. */
+template<uint32_t TexMode_TA>
+static INLINE void RasterTexArea(PS_GPU *gpu, gpu_raster_rect *rect)
+{
+   rect->x = gpu->TexPageX;
+   rect->y = gpu->TexPageY;
+   rect->w = 256 >> (2 - TexMode_TA);
+   rect->h = 256;
+}
+
+template<uint32_t TexMode_TA>
+static INLINE void RasterClutArea(uint32_t clut_offset, gpu_raster_rect *rect)
+{
+   rect->x = clut_offset & 1023;
+   rect->y = (clut_offset >> 10) & 511;
+   rect->w = TexMode_TA ? 256 : 16;
+   rect->h = 1;
+}
+
+/* Whether two VRAM areas overlap, wrapping around at 1024x512. */
+static INLINE bool RasterRectsIntersect(const gpu_raster_rect *a, const gpu_raster_rect *b)
+{
+   return (((b->x - a->x) & 1023) < a->w || ((a->x - b->x) & 1023) < b->w) &&
+      (((b->y - a->y) & 511) < a->h || ((a->y - b->y) & 511) < b->h);
+}
+
+static void ScanoutFlush(PS_GPU *gpu);
+
+/* Outputs the display lines still waiting for it first if rect of VRAM
+ * may be one they read(see ScanoutDefer() in gpu.cpp). */
+static INLINE void ScanoutWriting(PS_GPU *gpu, const gpu_raster_rect *rect)
+{
+   if(!gpu->ScanoutRows)
+      return;
+
+   if((RasterTileSpan(rect->y, rect->h, 512, SCANOUT_TILE_SHIFT) & gpu->ScanoutRows) &&
+         (RasterTileSpan(rect->x, rect->w, 1024, SCANOUT_TILE_SHIFT) & gpu->ScanoutColumns))
+      ScanoutFlush(gpu);
+}
+
+/* Decoded texture pages.
+ *
+ * Textured primitives in 4bpp and 8bpp modes look their texels up in one
+ * of the PS_GPU::TexDecode entries, keyed on the texture page, the CLUT
+ * and the mode, instead of unpacking the index and fetching the CLUT entry
+ * from VRAM for every pixel.  Whatever draws to VRAM drops the entries
+ * whose texture page or CLUT it overlaps first, and a primitive drawing
+ * over its own texture or CLUT goes through GetTexel() instead. */
+
+template<uint32_t TexMode_TA>
+static INLINE uint32 TexDecodeTag(PS_GPU *gpu, uint32_t clut_offset)
+{
+   return (clut_offset & 0x7FFFF) | ((gpu->TexPageX >> 6) << 19) |
+      ((gpu->TexPageY >> 8) << 23) | (TexMode_TA << 24);
+}
+
+static INLINE void TexDecodeAreas(uint32 tag, gpu_raster_rect *tex, gpu_raster_rect *clut)
+{
+   const uint32 mode = tag >> 24;
+
+   tex->x  = ((tag >> 19) & 0xF) << 6;
+   tex->y  = ((tag >> 23) & 0x1) << 8;
+   tex->w  = 64 << mode;
+   tex->h  = 256;
+
+   clut->x = tag & 1023;
+   clut->y = (tag >> 10) & 511;
+   clut->w = mode ? 256 : 16;
+   clut->h = 1;
+}
+
+static void InvalidateTexDecode(PS_GPU *gpu, const gpu_raster_rect *rect)
+{
+   unsigned i;
+
+   for(i = 0; i < TEXDECODE_ENTRIES; i++)
+   {
+      gpu_raster_rect tex, clut;
+
+      if(gpu->TexDecode[i].Tag == ~0U)
+         continue;
+
+      TexDecodeAreas(gpu->TexDecode[i].Tag, &tex, &clut);
+
+      if(RasterRectsIntersect(rect, &tex) || RasterRectsIntersect(rect, &clut))
+         gpu->TexDecode[i].Tag = ~0U;
+   }
+}
+
+template<uint32_t TexMode_TA>
+static void SelectTexDecode(PS_GPU *gpu, uint32_t clut_offset, const gpu_raster_rect *area)
+{
+   const uint32 tag = TexDecodeTag<TexMode_TA>(gpu, clut_offset);
+   gpu_raster_rect tex, clut;
+   unsigned i, victim = 0;
+
+   TexDecodeAreas(tag, &tex, &clut);
+
+   if(RasterRectsIntersect(area, &tex) || RasterRectsIntersect(area, &clut))
+      return;
+
+   gpu->TexDecodeClock++;
+
+   for(i = 0; i < TEXDECODE_ENTRIES; i++)
+   {
+      if(gpu->TexDecode[i].Tag == tag)
+      {
+         gpu->TexDecode[i].LastUse = gpu->TexDecodeClock;
+         gpu->TexDecodeCur         = i;
+         return;
+      }
+
+      if(gpu->TexDecode[victim].Tag != ~0U &&
+            (gpu->TexDecode[i].Tag == ~0U || gpu->TexDecode[i].LastUse < gpu->TexDecode[victim].LastUse))
+         victim = i;
+   }
+
+   gpu->TexDecode[victim].Tag     = tag;
+   gpu->TexDecode[victim].LastUse = gpu->TexDecodeClock;
+   memset(gpu->TexDecode[victim].Valid, 0, sizeof(gpu->TexDecode[victim].Valid));
+
+   gpu->TexDecodeCur = victim;
+}
+
+/* Called by the rasterizer before it draws to area. */
+static INLINE void RasterWriting(PS_GPU *gpu, const gpu_raster_rect *area)
+{
+   ScanoutWriting(gpu, area);
+   InvalidateTexDecode(gpu, area);
+}
+
+/* Called by the rasterizer before drawing a primitive covering native
+ * x0..x1, y0..y1; also picks the decoded texture page it samples, if any. */
+template<bool textured, uint32_t TexMode_TA>
+static INLINE void RasterBegin(PS_GPU *gpu, uint32_t clut_offset, int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+   gpu_raster_rect area;
+
+   gpu->TexDecodeCur = -1;
+
+   if(!RasterDrawArea(gpu, x0, y0, x1, y1, &area))
+      return;
+
+   RasterWriting(gpu, &area);
+
+   if(textured && TexMode_TA < 2)
+      SelectTexDecode<TexMode_TA>(gpu, clut_offset, &area);
+}
+
+/* The pieces of a decoded row holding u..u+count-1(mod 256), after
+ * the texture window.  The window only touches bits 3 to 7, so bits 5 to 7
+ * of the result only depend on those of u. */
+static INLINE uint32 TexDecodePieces(PS_GPU *gpu, uint32 u, uint32 count)
+{
+   uint32 pieces = 0;
+
+   u &= 0xFF;
+
+   if(count > 256)
+      count = 256;
+
+   while(count)
+   {
+      const uint32 step = 32 - (u & 31);
+
+      pieces |= 1 << (gpu->TexWindowXLUT[u] >> 5);
+
+      if(step >= count)
+         break;
+
+      count -= step;
+      u      = (u + step) & 0xFF;
+   }
+
+   return pieces;
+}
+
+/* Decodes the pieces of row v of the current entry that aren't yet, and
+ * returns the row. */
+template<uint32_t TexMode_TA>
+static INLINE const uint16 *TexDecodeRow(PS_GPU *gpu, uint32 v, uint32 pieces)
+{
+   unsigned p;
+   const uint32 clut_offset = gpu->TexDecode[gpu->TexDecodeCur].Tag & 0x7FFFF;
+   const uint32 fbtex_y     = gpu->TexPageY + v;
+   uint16 *row              = gpu->TexDecode[gpu->TexDecodeCur].Data[v];
+   uint8 *valid             = &gpu->TexDecode[gpu->TexDecodeCur].Valid[v];
+   const uint32 missing     = pieces & ~*valid;
+
+   if(MDFN_LIKELY(!missing))
+      return row;
+
+   for(p = 0; p < 8; p++)
+   {
+      uint32 u;
+
+      if(!((missing >> p) & 1))
+         continue;
+
+      for(u = p << 5; u < ((p + 1) << 5); u++)
+      {
+         uint16_t fbw = texel_fetch(gpu, (gpu->TexPageX + (u >> (2 - TexMode_TA))) & 1023, fbtex_y);
+
+         if(TexMode_TA == 0)
+            fbw = (fbw >> ((u & 3) * 4)) & 0xF;
+         else
+            fbw = (fbw >> ((u & 1) * 8)) & 0xFF;
+
+         row[u] = texel_fetch(gpu, (clut_offset + fbw) & 1023, (clut_offset >> 10) & 511);
+      }
+   }
+
+   *valid |= missing;
+
+   return row;
+}
+
 // Command table generation macros follow:
 
 //#define BM_HELPER(fg) { fg(0), fg(1), fg(2), fg(3) }
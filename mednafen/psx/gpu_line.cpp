@@ -101,67 +101,269 @@ static INLINE void AddLineStep(line_fxp_coord *point, const line_fxp_step *step)
    }
 }
 
-template<bool goraud, int BlendMode, bool MaskEval_TA>
-static void DrawLine(PS_GPU *gpu, line_point *points)
+/* VRAM area a line can draw to, see RasterDrawArea() */
+static bool LineDrawArea(PS_GPU *gpu, const line_point *points, gpu_raster_rect *rect)
 {
-   line_fxp_coord cur_point;
-   line_fxp_step step;
-   int32_t delta_x = abs(points[1].x - points[0].x);
-   int32_t delta_y = abs(points[1].y - points[0].y);
-   int32_t k       = (delta_x > delta_y) ? delta_x : delta_y;
+   int32_t x0 = std::min(points[0].x, points[1].x);
+   int32_t x1 = std::max(points[0].x, points[1].x);
+   int32_t y0 = std::min(points[0].y, points[1].y);
+   int32_t y1 = std::max(points[0].y, points[1].y);
 
-   if(points[0].x > points[1].x && k)
-      vertex_swap(line_point, points[1], points[0]);
+   // DrawLine() wraps the coordinates at 2048, so a line crossing that can land anywhere.
+   if(x0 < 0 || x1 > 2047)
+   {
+      x0 = 0;
+      x1 = 2047;
+   }
 
-   gpu->DrawTimeAvail -= k * 2;
+   if(y0 < 0 || y1 > 2047)
+   {
+      y0 = 0;
+      y1 = 2047;
+   }
 
-   line_points_to_fixed_point_step<goraud>(&points[0], &points[1], k, &step);
-   line_point_to_fixed_point_coord<goraud>(&points[0], &step, &cur_point);
+   return RasterDrawArea(gpu, x0, y0, x1, y1, rect);
+}
 
-   for(int32_t i = 0; i <= k; i++)  // <= is not a typo.
+// Longer lines are dropped by Command_DrawLine(), and the end point is drawn too.
+#define LINE_MAX_PIXELS 1024
+
+/* DitherLUT[][][v] for the dither_table[] offset d */
+static INLINE uint16_t LineDither(int v, int d)
+{
+   return std::min(std::max(v + d, 0) >> 3, 0x1F);
+}
+
+/* The colors of the count points of a line, as AddLineStep() steps them from
+ * start: 0x8000 | BGR555, dithered with the dither_table[] offsets in dither
+ * unless that's NULL.  8 at a time where there's SIMD. */
+template<bool goraud>
+static void LineColors(const line_point *point, const line_fxp_coord *start, const line_fxp_step *step,
+      const int16_t *dither, uint16_t *pix, int32_t count)
+{
+   int32_t i = 0;
+
+#ifdef HAVE_GPU_SIMD
    {
-      // Sign extension is not necessary here for x and y, due to the maximum values that ClipX1 and ClipY1 can contain.
-      int32_t x = (cur_point.x >> LINE_XY_FRACTBITS) & 2047;
-      int32_t y = (cur_point.y >> LINE_XY_FRACTBITS) & 2047;
+      const simd_s32 byte_mask = simd_s32_set1(0xFF);
+      simd_s32 r_lo, r_hi, g_lo, g_hi, b_lo, b_hi, r_step, g_step, b_step;
+
+      if(goraud)
+      {
+         int32_t r[8], g[8], b[8];
+
+         for(unsigned j = 0; j < 8; j++)
+         {
+            r[j] = start->r + step->dr_dk * j;
+            g[j] = start->g + step->dg_dk * j;
+            b[j] = start->b + step->db_dk * j;
+         }
+
+         r_lo = simd_s32_load(&r[0]); r_hi = simd_s32_load(&r[4]);
+         g_lo = simd_s32_load(&g[0]); g_hi = simd_s32_load(&g[4]);
+         b_lo = simd_s32_load(&b[0]); b_hi = simd_s32_load(&b[4]);
+
+         r_step = simd_s32_set1(step->dr_dk * 8);
+         g_step = simd_s32_set1(step->dg_dk * 8);
+         b_step = simd_s32_set1(step->db_dk * 8);
+      }
 
-      if(!LineSkipTest(gpu, y))
+      for(; i + 8 <= count; i += 8)
       {
-         uint8_t r, g, b;
-         uint16_t pix = 0x8000;
+         simd_u16 r, g, b;
 
          if(goraud)
          {
-            r = cur_point.r >> LINE_RGB_FRACTBITS;
-            g = cur_point.g >> LINE_RGB_FRACTBITS;
-            b = cur_point.b >> LINE_RGB_FRACTBITS;
+            r = simd_s32_narrow(simd_s32_and(simd_u32_srl<LINE_RGB_FRACTBITS>(r_lo), byte_mask),
+                  simd_s32_and(simd_u32_srl<LINE_RGB_FRACTBITS>(r_hi), byte_mask));
+            g = simd_s32_narrow(simd_s32_and(simd_u32_srl<LINE_RGB_FRACTBITS>(g_lo), byte_mask),
+                  simd_s32_and(simd_u32_srl<LINE_RGB_FRACTBITS>(g_hi), byte_mask));
+            b = simd_s32_narrow(simd_s32_and(simd_u32_srl<LINE_RGB_FRACTBITS>(b_lo), byte_mask),
+                  simd_s32_and(simd_u32_srl<LINE_RGB_FRACTBITS>(b_hi), byte_mask));
+
+            r_lo = simd_s32_add(r_lo, r_step); r_hi = simd_s32_add(r_hi, r_step);
+            g_lo = simd_s32_add(g_lo, g_step); g_hi = simd_s32_add(g_hi, g_step);
+            b_lo = simd_s32_add(b_lo, b_step); b_hi = simd_s32_add(b_hi, b_step);
          }
          else
          {
-            r = points[0].r;
-            g = points[0].g;
-            b = points[0].b;
+            r = simd_u16_set1(point->r);
+            g = simd_u16_set1(point->g);
+            b = simd_u16_set1(point->b);
          }
 
-         if(DitherEnabled(gpu))
+         if(dither)
          {
-            uint8_t *dither_offset = gpu->DitherLUT[y & 3][x & 3];
-            pix = 0x8000 | (dither_offset[r] << 0) | (dither_offset[g] << 5) | 
-               (dither_offset[b] << 10);
+            simd_u16 d = simd_u16_load((const uint16_t*)&dither[i]);
+
+            r = SpanDither_SIMD(r, d);
+            g = SpanDither_SIMD(g, d);
+            b = SpanDither_SIMD(b, d);
          }
          else
          {
-            pix = 0x8000 | ((r >> 3) << 0) | ((g >> 3) << 5) | ((b >> 3) << 10);
+            r = simd_s16_sra<3>(r);
+            g = simd_s16_sra<3>(g);
+            b = simd_s16_sra<3>(b);
          }
 
-         // FIXME: There has to be a faster way than checking for being inside the drawing area for each pixel.
-         if(x >= gpu->ClipX0 && x <= gpu->ClipX1 && y >= gpu->ClipY0 && y <= gpu->ClipY1)
-            PlotNativePixel<BlendMode, MaskEval_TA, false>(gpu, x, y, pix);
+         simd_u16_store(&pix[i], simd_u16_or(simd_u16_or(simd_u16_set1(0x8000), r),
+                  simd_u16_or(simd_u16_sll<5>(g), simd_u16_sll<10>(b))));
       }
+   }
+#endif
 
-      AddLineStep<goraud>(&cur_point, &step);
+   for(; i < count; i++)
+   {
+      uint8_t r, g, b;
+
+      if(goraud)
+      {
+         r = (start->r + step->dr_dk * i) >> LINE_RGB_FRACTBITS;
+         g = (start->g + step->dg_dk * i) >> LINE_RGB_FRACTBITS;
+         b = (start->b + step->db_dk * i) >> LINE_RGB_FRACTBITS;
+      }
+      else
+      {
+         r = point->r;
+         g = point->g;
+         b = point->b;
+      }
+
+      if(dither)
+      {
+         const int d = dither[i];
+
+         pix[i] = 0x8000 | (LineDither(r, d) << 0) | (LineDither(g, d) << 5) |
+            (LineDither(b, d) << 10);
+      }
+      else
+         pix[i] = 0x8000 | ((r >> 3) << 0) | ((g >> 3) << 5) | ((b >> 3) << 10);
    }
 }
 
+/* Unblended, unmasked horizontal line: the runs of its count pixels inside
+ * the drawing area are stored in one go. */
+static void DrawLineSpan(PS_GPU *gpu, const int16_t *xs, int32_t y, uint16_t *pix, int32_t count)
+{
+   int32_t i = 0;
+
+   if(LineSkipTest(gpu, y) || !RasterLineOwned(gpu, y & 511) || y < gpu->ClipY0 || y > gpu->ClipY1)
+      return;
+
+   while(i < count)
+   {
+      int32_t end = i + 1;
+      int32_t j;
+
+      if(xs[i] < gpu->ClipX0 || xs[i] > gpu->ClipX1)
+      {
+         i++;
+         continue;
+      }
+
+      // x only wraps around(at 2048) well past ClipX1
+      while(end < count && xs[end] <= gpu->ClipX1)
+         end++;
+
+      for(j = i; j < end; j++)
+         pix[j] = (pix[j] & 0x7FFF) | gpu->MaskSetOR;
+
+      SpriteCopyRow(gpu, xs[i], y, pix + i, end - i);
+      i = end;
+   }
+}
+
+template<bool goraud, int BlendMode, bool MaskEval_TA>
+static void DrawLine(PS_GPU *gpu, line_point *points)
+{
+   line_fxp_coord cur_point, start;
+   line_fxp_step step;
+   gpu_raster_rect area;
+   int16_t xs[LINE_MAX_PIXELS], ys[LINE_MAX_PIXELS], dither[LINE_MAX_PIXELS];
+   uint16_t pix[LINE_MAX_PIXELS];
+   const bool dither_enabled = DitherEnabled(gpu);
+   int32_t delta_x = abs(points[1].x - points[0].x);
+   int32_t delta_y = abs(points[1].y - points[0].y);
+   int32_t k       = (delta_x > delta_y) ? delta_x : delta_y;
+
+   if(LineDrawArea(gpu, points, &area))
+      RasterWriting(gpu, &area);
+
+   if(points[0].x > points[1].x && k)
+      vertex_swap(line_point, points[1], points[0]);
+
+   gpu->DrawTimeAvail -= k * 2;
+   GPU_PROF_PIXELS(gpu, k + 1);
+
+   line_points_to_fixed_point_step<goraud>(&points[0], &points[1], k, &step);
+   line_point_to_fixed_point_coord<goraud>(&points[0], &step, &cur_point);
+   start = cur_point;
+
+   // The positions have to be stepped one at a time, the colors don't
+   for(int32_t i = 0; i <= k; i++)  // <= is not a typo.
+   {
+      // Sign extension is not necessary here for x and y, due to the maximum values that ClipX1 and ClipY1 can contain.
+      xs[i] = (cur_point.x >> LINE_XY_FRACTBITS) & 2047;
+      ys[i] = (cur_point.y >> LINE_XY_FRACTBITS) & 2047;
+
+      if(dither_enabled)
+         dither[i] = dither_table[ys[i] & 3][xs[i] & 3];
+
+      AddLineStep<false>(&cur_point, &step);
+   }
+
+   LineColors<goraud>(&points[0], &start, &step, dither_enabled ? dither : NULL, pix, k + 1);
+
+   if(BlendMode < 0 && !MaskEval_TA && !delta_y)
+   {
+      DrawLineSpan(gpu, xs, ys[0], pix, k + 1);
+      return;
+   }
+
+   for(int32_t i = 0; i <= k; i++)
+   {
+      const int32_t x = xs[i];
+      const int32_t y = ys[i];
+
+      if(LineSkipTest(gpu, y) || !RasterLineOwned(gpu, y & 511))
+         continue;
+
+      // FIXME: There has to be a faster way than checking for being inside the drawing area for each pixel.
+      if(x >= gpu->ClipX0 && x <= gpu->ClipX1 && y >= gpu->ClipY0 && y <= gpu->ClipY1)
+         PlotNativePixel<BlendMode, MaskEval_TA, false>(gpu, x, y, pix[i]);
+   }
+}
+
+template<bool goraud, int BlendMode, bool MaskEval_TA>
+static void RasterLine(PS_GPU *gpu, const gpu_raster_job *job)
+{
+   // DrawLine() may swap the points.
+   line_point points[2];
+
+   points[0] = job->line.points[0];
+   points[1] = job->line.points[1];
+
+   DrawLine<goraud, BlendMode, MaskEval_TA>(gpu, points);
+}
+
+template<bool goraud, int BlendMode, bool MaskEval_TA>
+static void QueueLine(PS_GPU *gpu, const line_point *points)
+{
+   gpu_raster_rect area;
+   gpu_raster_job *job;
+
+   if(!LineDrawArea(gpu, points, &area))
+      return;
+
+   job = GPU_RasterNewJob(gpu);
+   job->draw = RasterLine<goraud, BlendMode, MaskEval_TA>;
+   job->line.points[0] = points[0];
+   job->line.points[1] = points[1];
+
+   GPU_RasterSubmit(&area, NULL, 0);
+}
+
 template<bool polyline, bool goraud, int BlendMode, bool MaskEval_TA>
 static void Command_DrawLine(PS_GPU *gpu, const uint32_t *cb)
 {
@@ -240,5 +442,10 @@ static void Command_DrawLine(PS_GPU *gpu, const uint32_t *cb)
 #endif
 
    if (rsx_intf_has_software_renderer())
+   {
+      if (GPU_RasterActive())
+         QueueLine<goraud, BlendMode, MaskEval_TA>(gpu, points);
+
       DrawLine<goraud, BlendMode, MaskEval_TA>(gpu, points);
+   }
 }
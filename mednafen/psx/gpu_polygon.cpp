@@ -130,6 +130,176 @@ static INLINE void AddIDeltas_DY(i_group &ig, const i_deltas &idl, uint32_t coun
    }
 }
 
+/* Decodes whatever the span of count pixels starting at ig samples from
+ * the current decoded texture page.  False if its texture coordinates go
+ * past what the texture window tables cover; GetTexel() then has to do. */
+template<uint32_t TexMode_TA>
+static bool PrepareTexDecodeSpan(PS_GPU *gpu, const i_group &ig, const i_deltas &idl, int32_t count)
+{
+   int64_t u0 = COORD_GET_INT(ig.u);
+   int64_t v0 = COORD_GET_INT(ig.v);
+   int64_t u1 = ((int64_t)(int32_t)ig.u + (int64_t)(int32_t)idl.du_dx * (count - 1)) >> COORD_FBS;
+   int64_t v1 = ((int64_t)(int32_t)ig.v + (int64_t)(int32_t)idl.dv_dx * (count - 1)) >> COORD_FBS;
+   uint32_t pieces;
+
+   if(u0 > u1)
+      std::swap(u0, u1);
+
+   if(v0 > v1)
+      std::swap(v0, v1);
+
+   if(u0 < -16 || u1 > 255 + 16 || v0 < -16 || v1 > 255 + 16)
+      return false;
+
+   u0 = std::max<int64_t>(u0, 0);
+   u1 = std::min<int64_t>(u1, 255);
+   v0 = std::max<int64_t>(v0, 0);
+   v1 = std::min<int64_t>(v1, 255);
+
+   pieces = TexDecodePieces(gpu, u0, u1 - u0 + 1);
+
+   for(int64_t v = v0; v <= v1; v++)
+      TexDecodeRow<TexMode_TA>(gpu, gpu->TexWindowYLUT[v], pieces);
+
+   return true;
+}
+
+#ifdef HAVE_GPU_SIMD
+// Largest dither pattern period: 4 pixels at 32x upscaling
+#define SPAN_DITHER_PERIOD_MAX (4 << 5)
+
+/* Gouraud channel values for 8 pixels, saturated to 0..255 like RGB8SAT[] does */
+static INLINE simd_u16 SpanChannel_SIMD(simd_s32 lo, simd_s32 hi)
+{
+   simd_u16 c = simd_s32_narrow_sat(simd_s32_sra<COORD_FBS>(lo), simd_s32_sra<COORD_FBS>(hi));
+
+   return simd_s16_min(simd_s16_max(c, simd_u16_set1(0)), simd_u16_set1(0xFF));
+}
+
+/* DitherLUT[][][c] for 8 pixels, with the dither_table[] offsets in d */
+static INLINE simd_u16 SpanDither_SIMD(simd_u16 c, simd_u16 d)
+{
+   c = simd_s16_max(simd_u16_add(c, d), simd_u16_set1(0));
+
+   return simd_s16_min(simd_s16_sra<3>(c), simd_u16_set1(0x1F));
+}
+
+/* Untextured DrawSpan() loop, 8 pixels at a time.  Returns how many pixels
+ * it drew, the caller draws the rest(and all of it if this returns 0). */
+template<bool goraud, int BlendMode, bool MaskEval_TA>
+static int32_t DrawSpan_SIMD(PS_GPU *gpu, int y, const int32_t xs, const int32_t xb, const i_group &ig, const i_deltas &idl)
+{
+   const int32_t count = (xb > xs) ? ((xb - xs) & ~7) : 0;
+   const bool dither   = goraud && DitherEnabled(gpu);
+   const simd_u16 mask_or = simd_u16_set1(gpu->MaskSetOR);
+   int16_t dither_pattern[SPAN_DITHER_PERIOD_MAX + 8];
+   uint32_t dither_period = 0;
+   simd_s32 r_lo, r_hi, g_lo, g_hi, b_lo, b_hi, r_step, g_step, b_step;
+   simd_u16 flat_pix;
+   uint16_t *row;
+
+   if(!count)
+      return 0;
+
+   if(dither)
+   {
+      const unsigned ds = gpu->dither_upscale_shift;
+      const int8 *dt    = dither_table[(y >> ds) & 3];
+
+      dither_period = 4 << ds;
+
+      if(dither_period > SPAN_DITHER_PERIOD_MAX)
+         return 0;
+
+      // Repeats every dither_period pixels, the extra 8 let every
+      // offset in the period be read as a whole vector.
+      for(uint32_t i = 0; i < dither_period + 8; i++)
+         dither_pattern[i] = dt[((xs + i) >> ds) & 3];
+   }
+
+   if(goraud)
+   {
+      int32_t r[8], g[8], b[8];
+
+      for(unsigned i = 0; i < 8; i++)
+      {
+         r[i] = ig.r + idl.dr_dx * i;
+         g[i] = ig.g + idl.dg_dx * i;
+         b[i] = ig.b + idl.db_dx * i;
+      }
+
+      r_lo = simd_s32_load(&r[0]); r_hi = simd_s32_load(&r[4]);
+      g_lo = simd_s32_load(&g[0]); g_hi = simd_s32_load(&g[4]);
+      b_lo = simd_s32_load(&b[0]); b_hi = simd_s32_load(&b[4]);
+
+      r_step = simd_s32_set1(idl.dr_dx * 8);
+      g_step = simd_s32_set1(idl.dg_dx * 8);
+      b_step = simd_s32_set1(idl.db_dx * 8);
+   }
+   else
+   {
+      const uint32_t r = COORD_GET_INT(ig.r);
+      const uint32_t g = COORD_GET_INT(ig.g);
+      const uint32_t b = COORD_GET_INT(ig.b);
+
+      flat_pix = simd_u16_set1(0x8000 | ((r >> 3) << 0) | ((g >> 3) << 5) | ((b >> 3) << 10));
+   }
+
+   y  &= (512 << gpu->upscale_shift) - 1;
+   row = gpu->vram + (y << (10 + gpu->upscale_shift)) + xs;
+
+   for(int32_t i = 0; i < count; i += 8)
+   {
+      simd_u16 pix, bg_pix;
+
+      if(goraud)
+      {
+         simd_u16 r = SpanChannel_SIMD(r_lo, r_hi);
+         simd_u16 g = SpanChannel_SIMD(g_lo, g_hi);
+         simd_u16 b = SpanChannel_SIMD(b_lo, b_hi);
+
+         if(dither)
+         {
+            simd_u16 d = simd_u16_load((const uint16_t*)&dither_pattern[i & (dither_period - 1)]);
+
+            r = SpanDither_SIMD(r, d);
+            g = SpanDither_SIMD(g, d);
+            b = SpanDither_SIMD(b, d);
+         }
+         else
+         {
+            r = simd_s16_sra<3>(r);
+            g = simd_s16_sra<3>(g);
+            b = simd_s16_sra<3>(b);
+         }
+
+         pix = simd_u16_or(simd_u16_or(simd_u16_set1(0x8000), r),
+               simd_u16_or(simd_u16_sll<5>(g), simd_u16_sll<10>(b)));
+
+         r_lo = simd_s32_add(r_lo, r_step); r_hi = simd_s32_add(r_hi, r_step);
+         g_lo = simd_s32_add(g_lo, g_step); g_hi = simd_s32_add(g_hi, g_step);
+         b_lo = simd_s32_add(b_lo, b_step); b_hi = simd_s32_add(b_hi, b_step);
+      }
+      else
+         pix = flat_pix;
+
+      bg_pix = simd_u16_load(row + i);
+
+      if(BlendMode >= 0)
+         pix = PlotPixelBlend_SIMD<BlendMode>(bg_pix, pix);
+
+      pix = simd_u16_or(simd_u16_and(pix, simd_u16_set1(0x7FFF)), mask_or);
+
+      if(MaskEval_TA)
+         pix = simd_u16_select(simd_s16_sra<15>(bg_pix), bg_pix, pix);
+
+      simd_u16_store(row + i, pix);
+   }
+
+   return count;
+}
+#endif
+
 template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA>
 static INLINE void DrawSpan(PS_GPU *gpu, int y, uint32_t clut_offset, const int32_t x_start, const int32_t x_bound, i_group ig, const i_deltas &idl)
 {
@@ -151,6 +321,7 @@ static INLINE void DrawSpan(PS_GPU *gpu, int y, uint32_t clut_offset, const int3
       if(xs < xb && ((y & (UPSCALE(gpu) - 1)) == 0))
       {
          gpu->DrawTimeAvail -= (xb - xs) >> gpu->upscale_shift;
+         GPU_PROF_PIXELS(gpu, (xb - xs) >> gpu->upscale_shift);
 
          if(goraud || textured)
          {
@@ -162,6 +333,9 @@ static INLINE void DrawSpan(PS_GPU *gpu, int y, uint32_t clut_offset, const int3
          }
       }
 
+      if(!RasterLineOwned(gpu, (y >> gpu->upscale_shift) & 511))
+         return;
+
       if(textured)
       {
          ig.u += (xs * idl.du_dx) + (y * idl.du_dy);
@@ -175,8 +349,22 @@ static INLINE void DrawSpan(PS_GPU *gpu, int y, uint32_t clut_offset, const int3
          ig.b += (xs * idl.db_dx) + (y * idl.db_dy);
       }
 
+      int32_t x = xs;
+      const uint16 (*tex_decode)[256] = NULL;
 
-      for(int32_t x = xs; MDFN_LIKELY(x < xb); x++)
+      if(textured && TexMode_TA < 2 && gpu->TexDecodeCur >= 0 && xs < xb &&
+            PrepareTexDecodeSpan<TexMode_TA>(gpu, ig, idl, xb - xs))
+         tex_decode = gpu->TexDecode[gpu->TexDecodeCur].Data;
+
+#ifdef HAVE_GPU_SIMD
+      if(!textured)
+      {
+         x += DrawSpan_SIMD<goraud, BlendMode, MaskEval_TA>(gpu, y, xs, xb, ig, idl);
+         AddIDeltas_DX<goraud, textured>(ig, idl, x - xs);
+      }
+#endif
+
+      for(; MDFN_LIKELY(x < xb); x++)
       {
          uint32_t r, g, b;
 
@@ -199,7 +387,12 @@ static INLINE void DrawSpan(PS_GPU *gpu, int y, uint32_t clut_offset, const int3
 
          if(textured)
          {
-            uint16_t fbw = GetTexel<TexMode_TA>(gpu, clut_offset, COORD_GET_INT(ig.u), COORD_GET_INT(ig.v));
+            uint16_t fbw;
+
+            if(TexMode_TA < 2 && tex_decode)
+               fbw = tex_decode[gpu->TexWindowYLUT[COORD_GET_INT(ig.v)]][gpu->TexWindowXLUT[COORD_GET_INT(ig.u)]];
+            else
+               fbw = GetTexel<TexMode_TA>(gpu, clut_offset, COORD_GET_INT(ig.u), COORD_GET_INT(ig.v));
 
             if(fbw)
             {
@@ -259,6 +452,12 @@ static INLINE void DrawTriangle(PS_GPU *gpu, tri_vertex *vertices, uint32_t clut
    if(!CalcIDeltas(idl, vertices[0], vertices[1], vertices[2]))
       return;
 
+   RasterBegin<textured, TexMode_TA>(gpu, clut,
+         std::min(vertices[0].x, std::min(vertices[1].x, vertices[2].x)) >> gpu->upscale_shift,
+         vertices[0].y >> gpu->upscale_shift,
+         std::max(vertices[0].x, std::max(vertices[1].x, vertices[2].x)) >> gpu->upscale_shift,
+         vertices[2].y >> gpu->upscale_shift);
+
    // [0] should be top vertex, [2] should be bottom vertex, [1] should be off to the side vertex.
    //
    //
@@ -413,6 +612,49 @@ static INLINE void DrawTriangle(PS_GPU *gpu, tri_vertex *vertices, uint32_t clut
 #endif
 }
 
+template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA>
+static void RasterTriangle(PS_GPU *gpu, const gpu_raster_job *job)
+{
+   tri_vertex vertices[3];
+
+   // DrawTriangle() sorts them in place
+   memcpy(vertices, job->tri.vertices, sizeof(vertices));
+
+   DrawTriangle<goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(gpu, vertices, job->tri.clut);
+}
+
+template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA>
+static void QueueTriangle(PS_GPU *gpu, const tri_vertex *vertices, uint32_t clut)
+{
+   gpu_raster_rect area;
+   gpu_raster_rect reads[2];
+   unsigned num_reads = 0;
+   gpu_raster_job *job;
+   int32_t x0 = std::min(vertices[0].x, std::min(vertices[1].x, vertices[2].x));
+   int32_t x1 = std::max(vertices[0].x, std::max(vertices[1].x, vertices[2].x));
+   int32_t y0 = std::min(vertices[0].y, std::min(vertices[1].y, vertices[2].y));
+   int32_t y1 = std::max(vertices[0].y, std::max(vertices[1].y, vertices[2].y));
+
+   if(!RasterDrawArea(gpu, x0 >> gpu->upscale_shift, y0 >> gpu->upscale_shift,
+            x1 >> gpu->upscale_shift, y1 >> gpu->upscale_shift, &area))
+      return;
+
+   if(textured)
+   {
+      RasterTexArea<TexMode_TA>(gpu, &reads[num_reads++]);
+
+      if(TexMode_TA < 2)
+         RasterClutArea<TexMode_TA>(clut, &reads[num_reads++]);
+   }
+
+   job = GPU_RasterNewJob(gpu);
+   job->draw = RasterTriangle<goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>;
+   memcpy(job->tri.vertices, vertices, sizeof(job->tri.vertices));
+   job->tri.clut = clut;
+
+   GPU_RasterSubmit(&area, reads, num_reads);
+}
+
 template<int numvertices, bool goraud, bool textured, int BlendMode, bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA, bool pgxp>
 static void Command_DrawPolygon(PS_GPU *gpu, const uint32_t *cb)
 {
@@ -682,7 +924,13 @@ static void Command_DrawPolygon(PS_GPU *gpu, const uint32_t *cb)
 #endif
 
    if (rsx_intf_has_software_renderer())
+   {
+      if (GPU_RasterActive())
+         QueueTriangle<goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(gpu, vertices, clut);
+
+      // Only does the timing when the rasterizer threads draw it.
       DrawTriangle<goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(gpu, vertices, clut);
+   }
 }
 
 #undef COORD_POST_PADDING
@@ -0,0 +1,281 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "psx.h"
+#include "gpu_profiler.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+#define GPU_PROF_SUMMARY_OPCODES 3
+
+struct GPUProfCounter
+{
+   uint64_t count;
+   uint64_t pixels;
+   uint64_t nsec;
+   int64_t draw_time;
+};
+
+static GPUProfCounter GPUProfTotal[256];
+static GPUProfCounter GPUProfPeriod[256];	// Since the last GPU_PROF_Summary()
+
+uint64_t GPU_PROF_PixelCount;
+
+static uint32_t GPUProfCC;
+static uint64_t GPUProfStartTime;
+static uint64_t GPUProfStartPixels;
+static int32_t GPUProfStartDrawTime;
+
+static uint64_t GPU_PROF_Now(void)
+{
+#if defined(_WIN32)
+   static LARGE_INTEGER freq;
+   LARGE_INTEGER now;
+
+   if(!freq.QuadPart)
+      QueryPerformanceFrequency(&freq);
+
+   QueryPerformanceCounter(&now);
+
+   return (uint64_t)((double)now.QuadPart * 1000000000.0 / freq.QuadPart);
+#elif defined(__APPLE__)
+   static mach_timebase_info_data_t timebase;
+
+   if(!timebase.denom)
+      mach_timebase_info(&timebase);
+
+   return mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+// What the opcode does, going by the bits ProcessFIFO() and the Commands table decode.
+static std::string GPU_PROF_Name(uint32_t cc)
+{
+   std::string name;
+
+   switch(cc >> 5)
+   {
+      case 0:
+         if(cc == 0x01)
+            return "clear cache";
+         if(cc == 0x02)
+            return "fill";
+         if(cc == 0x1F)
+            return "irq";
+         return "nop";
+
+      case 1:
+         name = (cc & 0x08) ? "quad" : "triangle";
+         if(cc & 0x10)
+            name += " gouraud";
+         if(cc & 0x04)
+            name += (cc & 0x01) ? " raw-textured" : " textured";
+         break;
+
+      case 2:
+         name = (cc & 0x08) ? "polyline" : "line";
+         if(cc & 0x10)
+            name += " gouraud";
+         break;
+
+      case 3:
+         {
+            static const char *const sizes[4] = { "sprite", "sprite 1x1", "sprite 8x8", "sprite 16x16" };
+
+            name = sizes[(cc >> 3) & 3];
+            if(cc & 0x04)
+               name += (cc & 0x01) ? " raw-textured" : " textured";
+         }
+         break;
+
+      case 4:
+         return "vram copy";
+      case 5:
+         return "vram write";
+      case 6:
+         return "vram read";
+
+      default:
+         switch(cc)
+         {
+            case 0xE1: return "draw mode";
+            case 0xE2: return "texture window";
+            case 0xE3: return "draw area top-left";
+            case 0xE4: return "draw area bottom-right";
+            case 0xE5: return "draw offset";
+            case 0xE6: return "mask bits";
+         }
+         return "nop";
+   }
+
+   if(cc & 0x02)
+      name += " semi";
+
+   return name;
+}
+
+void GPU_PROF_Reset(void)
+{
+   memset(GPUProfTotal, 0, sizeof(GPUProfTotal));
+   memset(GPUProfPeriod, 0, sizeof(GPUProfPeriod));
+   GPU_PROF_PixelCount = 0;
+}
+
+void GPU_PROF_Begin(uint32_t cc, bool resumed, int32_t draw_time_avail)
+{
+   // Dispatched by range, see ProcessFIFO()
+   if(cc >= 0x80 && cc <= 0xDF)
+      cc &= ~0x1F;
+
+   GPUProfCC            = cc;
+   GPUProfStartPixels   = GPU_PROF_PixelCount;
+   GPUProfStartDrawTime = draw_time_avail;
+
+   if(!resumed)
+   {
+      GPUProfTotal[cc].count++;
+      GPUProfPeriod[cc].count++;
+   }
+
+   GPUProfStartTime     = GPU_PROF_Now();
+}
+
+void GPU_PROF_End(int32_t draw_time_avail)
+{
+   const uint64_t nsec     = GPU_PROF_Now() - GPUProfStartTime;
+   const uint64_t pixels   = GPU_PROF_PixelCount - GPUProfStartPixels;
+   const int32_t draw_time = GPUProfStartDrawTime - draw_time_avail;
+   GPUProfCounter *c[2]    = { &GPUProfTotal[GPUProfCC], &GPUProfPeriod[GPUProfCC] };
+
+   for(unsigned i = 0; i < 2; i++)
+   {
+      c[i]->pixels    += pixels;
+      c[i]->nsec      += nsec;
+      c[i]->draw_time += draw_time;
+   }
+}
+
+struct GPUProfSortByTime
+{
+   const GPUProfCounter *c;
+
+   bool operator()(uint32_t a, uint32_t b) const
+   {
+      return c[a].nsec > c[b].nsec;
+   }
+};
+
+static void GPU_PROF_Sort(const GPUProfCounter *c, std::vector<uint32_t> &opcodes)
+{
+   GPUProfSortByTime cmp;
+
+   opcodes.clear();
+
+   for(uint32_t cc = 0; cc < 256; cc++)
+   {
+      if(c[cc].count)
+         opcodes.push_back(cc);
+   }
+
+   cmp.c = c;
+   std::sort(opcodes.begin(), opcodes.end(), cmp);
+}
+
+void GPU_PROF_Summary(char *buf, size_t size, unsigned frames)
+{
+   std::vector<uint32_t> opcodes;
+   uint64_t nsec = 0;
+   size_t len;
+   size_t i;
+
+   GPU_PROF_Sort(GPUProfPeriod, opcodes);
+
+   for(i = 0; i < opcodes.size(); i++)
+      nsec += GPUProfPeriod[opcodes[i]].nsec;
+
+   if(!frames)
+      frames = 1;
+
+   len = snprintf(buf, size, "GPU %.2f ms/frame", nsec / 1000000.0 / frames);
+
+   for(i = 0; i < opcodes.size() && i < GPU_PROF_SUMMARY_OPCODES && len < size; i++)
+   {
+      const GPUProfCounter *c = &GPUProfPeriod[opcodes[i]];
+
+      len += snprintf(buf + len, size - len, " | %02X %.2f", opcodes[i], c->nsec / 1000000.0 / frames);
+   }
+
+   memset(GPUProfPeriod, 0, sizeof(GPUProfPeriod));
+}
+
+void GPU_PROF_Dump(const char *path)
+{
+   std::vector<uint32_t> opcodes;
+   GPUProfCounter total;
+   FILE *fp;
+   size_t i;
+
+   if(!(fp = fopen(path, "w")))
+      return;
+
+   GPU_PROF_Sort(GPUProfTotal, opcodes);
+
+   memset(&total, 0, sizeof(total));
+
+   for(i = 0; i < opcodes.size(); i++)
+   {
+      total.count     += GPUProfTotal[opcodes[i]].count;
+      total.pixels    += GPUProfTotal[opcodes[i]].pixels;
+      total.nsec      += GPUProfTotal[opcodes[i]].nsec;
+      total.draw_time += GPUProfTotal[opcodes[i]].draw_time;
+   }
+
+   fprintf(fp, "Commands:  %llu\n", (unsigned long long)total.count);
+   fprintf(fp, "Pixels:    %llu\n", (unsigned long long)total.pixels);
+   fprintf(fp, "Host time: %.3f ms\n", total.nsec / 1000000.0);
+   fprintf(fp, "Draw time: %lld GPU cycles\n", (long long)total.draw_time);
+
+   fprintf(fp, "\n  %-2s %-32s %12s %14s %12s %7s %10s %14s\n", "cc", "command", "count", "pixels", "host ms", "%", "ns/cmd", "draw time");
+
+   for(i = 0; i < opcodes.size(); i++)
+   {
+      const GPUProfCounter *c = &GPUProfTotal[opcodes[i]];
+
+      fprintf(fp, "  %02X %-32s %12llu %14llu %12.3f %6.2f%% %10llu %14lld\n", opcodes[i], GPU_PROF_Name(opcodes[i]).c_str(),
+            (unsigned long long)c->count, (unsigned long long)c->pixels, c->nsec / 1000000.0,
+            total.nsec ? c->nsec * 100.0 / total.nsec : 0.0, (unsigned long long)(c->nsec / c->count), (long long)c->draw_time);
+   }
+
+   fclose(fp);
+}
@@ -0,0 +1,43 @@
+#ifndef __MDFN_PSX_GPU_PROFILER_H
+#define __MDFN_PSX_GPU_PROFILER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//
+// GP0 command profiler, built with HAVE_GPU_PROFILER=1.  ProcessFIFO() brackets every
+// command it dispatches with GPU_PROF_Begin()/GPU_PROF_End(), which charge it, per opcode,
+// the host time and the DrawTimeAvail it took along with the pixels the rasterizer counted
+// in the meantime.  Opcodes dispatched by range(VRAM copies, writes and reads) are kept
+// under the first one of the range.  With the rasterizer threads or lazy mode on, the host
+// time is only what the emulation thread spent.
+//
+#ifdef HAVE_GPU_PROFILER
+
+// Pixels drawn, filled, copied or transferred so far.  Only the emulation thread's GPU
+// counts, so that the rasterizer threads' copies don't count them over again.
+extern uint64_t GPU_PROF_PixelCount;
+
+#define GPU_PROF_PIXELS(gpu, n) do { if((gpu) == GPU) GPU_PROF_PixelCount += (n); } while(0)
+
+void GPU_PROF_Reset(void);
+
+// resumed is for the rest of a command already counted once: the second half of a quad,
+// the next segment of a polyline, the image data of a VRAM write or read.
+void GPU_PROF_Begin(uint32_t cc, bool resumed, int32_t draw_time_avail);
+void GPU_PROF_End(int32_t draw_time_avail);
+
+// One line about the opcodes that took the most host time since the last call, over
+// frames frames, for the on screen display.
+void GPU_PROF_Summary(char *buf, size_t size, unsigned frames);
+
+// Writes the totals of every opcode seen to path, the slowest first.
+void GPU_PROF_Dump(const char *path);
+
+#else
+
+#define GPU_PROF_PIXELS(gpu, n) do { } while(0)
+
+#endif
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef __MDFN_PSX_GPU_SIMD_H
+#define __MDFN_PSX_GPU_SIMD_H
+
+// Thin wrappers over the SSE2 and NEON integer operations the software renderer's vector
+// paths use, so each kernel is only written once.  HAVE_GPU_SIMD is left undefined when
+// neither is available, and the scalar code is used instead.
+//
+// simd_u16 holds 8 16-bit lanes(pixels), simd_s32 4 32-bit lanes.  Shift counts are
+// template parameters since NEON wants them as immediates.
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+#define HAVE_GPU_SIMD 1
+
+typedef __m128i simd_u16;
+typedef __m128i simd_s32;
+
+static INLINE simd_u16 simd_u16_load(const uint16_t *p)          { return _mm_loadu_si128((const __m128i*)p); }
+static INLINE void     simd_u16_store(uint16_t *p, simd_u16 v)   { _mm_storeu_si128((__m128i*)p, v); }
+static INLINE simd_u16 simd_u16_set1(uint16_t v)                 { return _mm_set1_epi16((int16_t)v); }
+static INLINE simd_u16 simd_u16_and(simd_u16 a, simd_u16 b)      { return _mm_and_si128(a, b); }
+static INLINE simd_u16 simd_u16_or(simd_u16 a, simd_u16 b)       { return _mm_or_si128(a, b); }
+static INLINE simd_u16 simd_u16_add(simd_u16 a, simd_u16 b)      { return _mm_add_epi16(a, b); }
+static INLINE simd_u16 simd_s16_min(simd_u16 a, simd_u16 b)      { return _mm_min_epi16(a, b); }
+static INLINE simd_u16 simd_s16_max(simd_u16 a, simd_u16 b)      { return _mm_max_epi16(a, b); }
+template<int n> static INLINE simd_u16 simd_u16_sll(simd_u16 v)  { return _mm_slli_epi16(v, n); }
+template<int n> static INLINE simd_u16 simd_u16_srl(simd_u16 v)  { return _mm_srli_epi16(v, n); }
+template<int n> static INLINE simd_u16 simd_s16_sra(simd_u16 v)  { return _mm_srai_epi16(v, n); }
+
+// All ones in the lanes where a == b, zeroes elsewhere
+static INLINE simd_u16 simd_u16_cmpeq(simd_u16 a, simd_u16 b)    { return _mm_cmpeq_epi16(a, b); }
+
+// mask lanes must be all ones or all zeroes; picks a where set, b elsewhere.
+static INLINE simd_u16 simd_u16_select(simd_u16 mask, simd_u16 a, simd_u16 b)
+{
+   return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static INLINE simd_s32 simd_s32_load(const int32_t *p)           { return _mm_loadu_si128((const __m128i*)p); }
+static INLINE void     simd_s32_store(int32_t *p, simd_s32 v)    { _mm_storeu_si128((__m128i*)p, v); }
+static INLINE simd_s32 simd_s32_set1(int32_t v)                  { return _mm_set1_epi32(v); }
+static INLINE simd_s32 simd_s32_add(simd_s32 a, simd_s32 b)      { return _mm_add_epi32(a, b); }
+static INLINE simd_s32 simd_s32_sub(simd_s32 a, simd_s32 b)      { return _mm_sub_epi32(a, b); }
+static INLINE simd_s32 simd_s32_and(simd_s32 a, simd_s32 b)      { return _mm_and_si128(a, b); }
+static INLINE simd_s32 simd_s32_or(simd_s32 a, simd_s32 b)       { return _mm_or_si128(a, b); }
+static INLINE simd_s32 simd_s32_xor(simd_s32 a, simd_s32 b)      { return _mm_xor_si128(a, b); }
+template<int n> static INLINE simd_s32 simd_s32_sra(simd_s32 v)  { return _mm_srai_epi32(v, n); }
+template<int n> static INLINE simd_s32 simd_u32_srl(simd_s32 v)  { return _mm_srli_epi32(v, n); }
+template<int n> static INLINE simd_s32 simd_s32_sll(simd_s32 v)  { return _mm_slli_epi32(v, n); }
+
+// Loads 4 packed 3-byte pixels(from 16 bytes at p) into the low 24 bits of each lane; the
+// top byte is garbage.
+static INLINE simd_s32 simd_s32_load_rgb24(const uint8_t *p)
+{
+   __m128i v  = _mm_loadu_si128((const __m128i*)p);
+   __m128i lo = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+   __m128i hi = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+
+   return _mm_unpacklo_epi64(lo, hi);
+}
+
+// Zero-extends the low/high 4 lanes to 32 bits
+static INLINE simd_s32 simd_u16_widen_lo(simd_u16 v)             { return _mm_unpacklo_epi16(v, _mm_setzero_si128()); }
+static INLINE simd_s32 simd_u16_widen_hi(simd_u16 v)             { return _mm_unpackhi_epi16(v, _mm_setzero_si128()); }
+
+// Keeps the low 16 bits of each lane
+static INLINE simd_u16 simd_s32_narrow(simd_s32 lo, simd_s32 hi)
+{
+   lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+   hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+
+   return _mm_packs_epi32(lo, hi);
+}
+
+// Saturates each lane to -32768..32767
+static INLINE simd_u16 simd_s32_narrow_sat(simd_s32 lo, simd_s32 hi)
+{
+   return _mm_packs_epi32(lo, hi);
+}
+
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+
+#define HAVE_GPU_SIMD 1
+
+typedef uint16x8_t simd_u16;
+typedef int32x4_t  simd_s32;
+
+static INLINE simd_u16 simd_u16_load(const uint16_t *p)          { return vld1q_u16(p); }
+static INLINE void     simd_u16_store(uint16_t *p, simd_u16 v)   { vst1q_u16(p, v); }
+static INLINE simd_u16 simd_u16_set1(uint16_t v)                 { return vdupq_n_u16(v); }
+static INLINE simd_u16 simd_u16_and(simd_u16 a, simd_u16 b)      { return vandq_u16(a, b); }
+static INLINE simd_u16 simd_u16_or(simd_u16 a, simd_u16 b)       { return vorrq_u16(a, b); }
+static INLINE simd_u16 simd_u16_add(simd_u16 a, simd_u16 b)      { return vaddq_u16(a, b); }
+static INLINE simd_u16 simd_s16_min(simd_u16 a, simd_u16 b)      { return vreinterpretq_u16_s16(vminq_s16(vreinterpretq_s16_u16(a), vreinterpretq_s16_u16(b))); }
+static INLINE simd_u16 simd_s16_max(simd_u16 a, simd_u16 b)      { return vreinterpretq_u16_s16(vmaxq_s16(vreinterpretq_s16_u16(a), vreinterpretq_s16_u16(b))); }
+template<int n> static INLINE simd_u16 simd_u16_sll(simd_u16 v)  { return vshlq_n_u16(v, n); }
+template<int n> static INLINE simd_u16 simd_u16_srl(simd_u16 v)  { return vshrq_n_u16(v, n); }
+template<int n> static INLINE simd_u16 simd_s16_sra(simd_u16 v)  { return vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(v), n)); }
+
+static INLINE simd_u16 simd_u16_cmpeq(simd_u16 a, simd_u16 b)    { return vceqq_u16(a, b); }
+
+static INLINE simd_u16 simd_u16_select(simd_u16 mask, simd_u16 a, simd_u16 b)
+{
+   return vbslq_u16(mask, a, b);
+}
+
+static INLINE simd_s32 simd_s32_load(const int32_t *p)           { return vld1q_s32(p); }
+static INLINE void     simd_s32_store(int32_t *p, simd_s32 v)    { vst1q_s32(p, v); }
+static INLINE simd_s32 simd_s32_set1(int32_t v)                  { return vdupq_n_s32(v); }
+static INLINE simd_s32 simd_s32_add(simd_s32 a, simd_s32 b)      { return vaddq_s32(a, b); }
+static INLINE simd_s32 simd_s32_sub(simd_s32 a, simd_s32 b)      { return vsubq_s32(a, b); }
+static INLINE simd_s32 simd_s32_and(simd_s32 a, simd_s32 b)      { return vandq_s32(a, b); }
+static INLINE simd_s32 simd_s32_or(simd_s32 a, simd_s32 b)       { return vorrq_s32(a, b); }
+static INLINE simd_s32 simd_s32_xor(simd_s32 a, simd_s32 b)      { return veorq_s32(a, b); }
+template<int n> static INLINE simd_s32 simd_s32_sra(simd_s32 v)  { return vshrq_n_s32(v, n); }
+template<int n> static INLINE simd_s32 simd_u32_srl(simd_s32 v)  { return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(v), n)); }
+template<int n> static INLINE simd_s32 simd_s32_sll(simd_s32 v)  { return vshlq_n_s32(v, n); }
+
+static INLINE simd_s32 simd_s32_load_rgb24(const uint8_t *p)
+{
+   uint8x16_t v  = vld1q_u8(p);
+   uint32x2_t a  = vget_low_u32(vreinterpretq_u32_u8(v));
+   uint32x2_t b  = vget_low_u32(vreinterpretq_u32_u8(vextq_u8(v, v, 3)));
+   uint32x2_t c  = vget_low_u32(vreinterpretq_u32_u8(vextq_u8(v, v, 6)));
+   uint32x2_t d  = vget_low_u32(vreinterpretq_u32_u8(vextq_u8(v, v, 9)));
+
+   return vreinterpretq_s32_u32(vcombine_u32(vzip_u32(a, b).val[0], vzip_u32(c, d).val[0]));
+}
+
+static INLINE simd_s32 simd_u16_widen_lo(simd_u16 v)             { return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(v))); }
+static INLINE simd_s32 simd_u16_widen_hi(simd_u16 v)             { return vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(v))); }
+
+static INLINE simd_u16 simd_s32_narrow(simd_s32 lo, simd_s32 hi)
+{
+   return vcombine_u16(vmovn_u32(vreinterpretq_u32_s32(lo)), vmovn_u32(vreinterpretq_u32_s32(hi)));
+}
+
+static INLINE simd_u16 simd_s32_narrow_sat(simd_s32 lo, simd_s32 hi)
+{
+   return vreinterpretq_u16_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+}
+
+#endif
+
+#endif
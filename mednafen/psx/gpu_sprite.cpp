@@ -1,3 +1,184 @@
+/* Sprites that don't blend, look at the mask bit or modulate their texels
+ * don't depend on what's in VRAM already: their rows are built as native
+ * pixels first, then stored in one go, each pixel as a whole upscaled block. */
+
+/* n copies of value at dst */
+static INLINE void SpriteFillSpan(uint16 *dst, uint16 value, uint32 n)
+{
+   uint32 i = 0;
+
+#ifdef HAVE_GPU_SIMD
+   const simd_u16 v = simd_u16_set1(value);
+
+   for(; i + 8 <= n; i += 8)
+      simd_u16_store(dst + i, v);
+#endif
+
+   for(; i < n; i++)
+      dst[i] = value;
+}
+
+/* pixels[0..n) at dst, leaving the zero(transparent) ones alone */
+static INLINE void SpriteStoreSpan(uint16 *dst, const uint16 *pixels, uint32 n)
+{
+   uint32 i = 0;
+
+#ifdef HAVE_GPU_SIMD
+   const simd_u16 zero = simd_u16_set1(0);
+
+   for(; i + 8 <= n; i += 8)
+   {
+      simd_u16 pix = simd_u16_load(pixels + i);
+
+      simd_u16_store(dst + i, simd_u16_select(simd_u16_cmpeq(pix, zero), simd_u16_load(dst + i), pix));
+   }
+#endif
+
+   for(; i < n; i++)
+   {
+      if(pixels[i])
+         dst[i] = pixels[i];
+   }
+}
+
+/* VRAM row for native pixel x of native line y, at the top of its block */
+static INLINE uint16 *SpriteRow(PS_GPU *gpu, int32_t x, int32_t y)
+{
+   return gpu->vram + (((y & 511) << gpu->upscale_shift) << (10 + gpu->upscale_shift)) +
+      (x << gpu->upscale_shift);
+}
+
+static void SpriteFillRow(PS_GPU *gpu, int32_t x, int32_t y, uint16 value, int32_t count)
+{
+   uint16 *row = SpriteRow(gpu, x, y);
+   unsigned i;
+
+   for(i = 0; i < UPSCALE(gpu); i++)
+      SpriteFillSpan(row + (i << (10 + gpu->upscale_shift)), value, count << gpu->upscale_shift);
+}
+
+/* Stores native pixels[0..count) at x, y, all of them */
+static void SpriteCopyRow(PS_GPU *gpu, int32_t x, int32_t y, const uint16 *pixels, int32_t count)
+{
+   const uint32 shift = gpu->upscale_shift;
+   uint16 *row        = SpriteRow(gpu, x, y);
+   int32_t i;
+   unsigned sub;
+
+   if(!shift)
+   {
+      memcpy(row, pixels, count * sizeof(uint16));
+      return;
+   }
+
+   // Fill the first line of blocks, then copy it to the others
+   for(i = 0; i < count; i++)
+      SpriteFillSpan(row + (i << shift), pixels[i], UPSCALE(gpu));
+
+   for(sub = 1; sub < UPSCALE(gpu); sub++)
+      memcpy(row + (sub << (10 + shift)), row, (count << shift) * sizeof(uint16));
+}
+
+/* Stores native pixels[0..count) at x, y, zero ones being transparent */
+static void SpriteStoreRow(PS_GPU *gpu, int32_t x, int32_t y, const uint16 *pixels, int32_t count)
+{
+   const uint32 shift = gpu->upscale_shift;
+   const uint32 pitch = 1024 << shift;
+   uint16 *row        = SpriteRow(gpu, x, y);
+   bool opaque        = true;
+   int32_t i;
+   unsigned sub;
+
+   if(!shift)
+   {
+      SpriteStoreSpan(row, pixels, count);
+      return;
+   }
+
+   for(i = 0; i < count; i++)
+   {
+      if(!pixels[i])
+      {
+         opaque = false;
+         break;
+      }
+   }
+
+   if(!opaque)
+   {
+      for(sub = 0; sub < UPSCALE(gpu); sub++, row += pitch)
+      {
+         for(i = 0; i < count; i++)
+         {
+            if(pixels[i])
+               SpriteFillSpan(row + (i << shift), pixels[i], UPSCALE(gpu));
+         }
+      }
+      return;
+   }
+
+   SpriteCopyRow(gpu, x, y, pixels, count);
+}
+
+/* count texels of sprite row v from u on, u_inc apart, with MaskSetOR
+ * applied to the non-transparent ones. */
+template<uint32_t TexMode_TA>
+static INLINE void SpriteFetchRow(PS_GPU *gpu, const uint16 *tex_row, uint32_t clut_offset,
+      uint8_t u, uint8_t v, int32_t u_inc, uint16 *pixels, int32_t count)
+{
+   const uint16 mask_or = gpu->MaskSetOR;
+   int32_t i            = 0;
+
+   // Without a texture window or flipping the texels are contiguous, but
+   // for u wrapping around at 256(and 15bpp pages at the edge of VRAM).
+   if(u_inc == 1 && !gpu->tww && (TexMode_TA < 2 ? tex_row != NULL : !gpu->upscale_shift))
+   {
+      const uint32 fbtex_y = gpu->TexPageY + gpu->TexWindowYLUT[v];
+
+      while(i < count)
+      {
+         int32_t chunk = std::min<int32_t>(count - i, 256 - u);
+         const uint16 *src;
+         int32_t j;
+
+         if(TexMode_TA < 2)
+            src = tex_row + u;
+         else
+         {
+            const uint32 fbtex_x = (gpu->TexPageX + u) & 1023;
+
+            chunk = std::min<int32_t>(chunk, 1024 - fbtex_x);
+            src   = gpu->vram + (fbtex_y << 10) + fbtex_x;
+         }
+
+         if(!mask_or)
+            memcpy(pixels + i, src, chunk * sizeof(uint16));
+         else
+         {
+            for(j = 0; j < chunk; j++)
+               pixels[i + j] = src[j] ? (src[j] | mask_or) : 0;
+         }
+
+         i += chunk;
+         u += chunk;
+      }
+
+      return;
+   }
+
+   for(; i < count; i++, u += u_inc)
+   {
+      uint16_t fbw;
+
+      if(TexMode_TA < 2 && tex_row)
+         fbw = tex_row[gpu->TexWindowXLUT[u]];
+      else
+         fbw = GetTexel<TexMode_TA>(gpu, clut_offset, u, v);
+
+      pixels[i] = fbw ? (fbw | mask_or) : 0;
+   }
+}
+
 
 template<bool textured, int BlendMode, bool TexMult, uint32_t TexMode_TA,
    bool MaskEval_TA, bool FlipX, bool FlipY>
@@ -15,6 +196,7 @@ static void DrawSprite(PS_GPU *gpu, int32_t x_arg, int32_t y_arg, int32_t w, int
    int32_t x_bound           = x_arg + w;
    int32_t y_start           = y_arg;
    int32_t y_bound           = y_arg + h;
+   uint32_t tex_pieces       = 0;
 
    //printf("[GPU] Sprite: x=%d, y=%d, w=%d, h=%d\n", x_arg, y_arg, w, h);
 
@@ -62,6 +244,15 @@ static void DrawSprite(PS_GPU *gpu, int32_t x_arg, int32_t y_arg, int32_t w, int
    if(y_bound > (gpu->ClipY1 + 1))
       y_bound = gpu->ClipY1 + 1;
 
+   RasterBegin<textured, TexMode_TA>(gpu, clut_offset, x_start, y_start, x_bound - 1, y_bound - 1);
+
+   if(textured && TexMode_TA < 2 && gpu->TexDecodeCur >= 0)
+   {
+      const int32_t count = x_bound - x_start;
+
+      tex_pieces = TexDecodePieces(gpu, FlipX ? (u - (count - 1)) : u, count);
+   }
+
    //HeightMode && !dfe && ((y & 1) == ((DisplayFB_YStart + !field_atvs) & 1)) && !DisplayOff
    //printf("%d:%d, %d, %d ---- heightmode=%d displayfb_ystart=%d field_atvs=%d displayoff=%d\n", w, h, scanline, dfe, HeightMode, DisplayFB_YStart, field_atvs, DisplayOff);
 
@@ -85,29 +276,72 @@ static void DrawSprite(PS_GPU *gpu, int32_t x_arg, int32_t y_arg, int32_t w, int
                suck_time += (((x_bound + 1) & ~1) - (x_start & ~1)) >> 1;
 
             gpu->DrawTimeAvail -= suck_time;
+            GPU_PROF_PIXELS(gpu, x_bound - x_start);
          }
 
-         for(int32_t x = x_start; MDFN_LIKELY(x < x_bound); x++)
+         if(RasterLineOwned(gpu, y & 511))
          {
-            if(textured)
-            {
-               uint16_t fbw = GetTexel<TexMode_TA>(gpu, clut_offset, u_r, v);
+            const uint16 *tex_row = NULL;
+
+            if(TexMode_TA < 2 && tex_pieces)
+               tex_row = TexDecodeRow<TexMode_TA>(gpu, gpu->TexWindowYLUT[v], tex_pieces);
 
-               if(fbw)
+            bool whole_row = BlendMode < 0 && !MaskEval_TA && !TexMult;
+
+            // Texels read straight from VRAM may have just been drawn by
+            // this very row(sprites texturing from their own drawing area).
+            if(textured && !tex_row &&
+                  ((gpu->TexPageY + gpu->TexWindowYLUT[v]) == (uint32)(y & 511) ||
+                   (TexMode_TA < 2 && ((clut_offset >> 10) & 511) == (uint32)(y & 511))))
+               whole_row = false;
+
+            if(whole_row)
+            {
+               if(x_bound > x_start)
                {
-                  if(TexMult)
+                  if(textured)
                   {
-                     uint8_t *dither_offset = gpu->DitherLUT[2][3];
-                     fbw = ModTexel(dither_offset, fbw, r, g, b);
+                     uint16 pixels[1024];
+
+                     SpriteFetchRow<TexMode_TA>(gpu, tex_row, clut_offset, u_r, v, u_inc,
+                           pixels, x_bound - x_start);
+                     SpriteStoreRow(gpu, x_start, y, pixels, x_bound - x_start);
                   }
-                  PlotNativePixel<BlendMode, MaskEval_TA, true>(gpu, x, y, fbw);
+                  else
+                     SpriteFillRow(gpu, x_start, y, (fill_color & 0x7FFF) | gpu->MaskSetOR,
+                           x_bound - x_start);
                }
             }
             else
-               PlotNativePixel<BlendMode, MaskEval_TA, false>(gpu, x, y, fill_color);
+            {
+               for(int32_t x = x_start; MDFN_LIKELY(x < x_bound); x++)
+               {
+                  if(textured)
+                  {
+                     uint16_t fbw;
+
+                     if(TexMode_TA < 2 && tex_row)
+                        fbw = tex_row[gpu->TexWindowXLUT[u_r]];
+                     else
+                        fbw = GetTexel<TexMode_TA>(gpu, clut_offset, u_r, v);
+
+                     if(fbw)
+                     {
+                        if(TexMult)
+                        {
+                           uint8_t *dither_offset = gpu->DitherLUT[2][3];
+                           fbw = ModTexel(dither_offset, fbw, r, g, b);
+                        }
+                        PlotNativePixel<BlendMode, MaskEval_TA, true>(gpu, x, y, fbw);
+                     }
+                  }
+                  else
+                     PlotNativePixel<BlendMode, MaskEval_TA, false>(gpu, x, y, fill_color);
 
-            if(textured)
-               u_r += u_inc;
+                  if(textured)
+                     u_r += u_inc;
+               }
+            }
          }
       }
       if(textured)
@@ -115,6 +349,85 @@ static void DrawSprite(PS_GPU *gpu, int32_t x_arg, int32_t y_arg, int32_t w, int
    }
 }
 
+template<bool textured, int BlendMode, bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA>
+static void DispatchSprite(PS_GPU *gpu, uint32_t flip, int32_t x, int32_t y, int32_t w, int32_t h,
+      uint8_t u, uint8_t v, uint32_t color, uint32_t clut)
+{
+   switch(flip & 0x3000)
+   {
+      case 0x0000:
+         if(!TexMult || color == 0x808080)
+            DrawSprite<textured, BlendMode, false, TexMode_TA, MaskEval_TA, false, false>(gpu, x, y, w, h, u, v, color, clut);
+         else
+            DrawSprite<textured, BlendMode, true, TexMode_TA, MaskEval_TA, false, false>(gpu, x, y, w, h, u, v, color, clut);
+         break;
+
+      case 0x1000:
+         if(!TexMult || color == 0x808080)
+            DrawSprite<textured, BlendMode, false, TexMode_TA, MaskEval_TA, true, false>(gpu, x, y, w, h, u, v, color, clut);
+         else
+            DrawSprite<textured, BlendMode, true, TexMode_TA, MaskEval_TA, true, false>(gpu, x, y, w, h, u, v, color, clut);
+         break;
+
+      case 0x2000:
+         if(!TexMult || color == 0x808080)
+            DrawSprite<textured, BlendMode, false, TexMode_TA, MaskEval_TA, false, true>(gpu, x, y, w, h, u, v, color, clut);
+         else
+            DrawSprite<textured, BlendMode, true, TexMode_TA, MaskEval_TA, false, true>(gpu, x, y, w, h, u, v, color, clut);
+         break;
+
+      case 0x3000:
+         if(!TexMult || color == 0x808080)
+            DrawSprite<textured, BlendMode, false, TexMode_TA, MaskEval_TA, true, true>(gpu, x, y, w, h, u, v, color, clut);
+         else
+            DrawSprite<textured, BlendMode, true, TexMode_TA, MaskEval_TA, true, true>(gpu, x, y, w, h, u, v, color, clut);
+         break;
+   }
+}
+
+template<bool textured, int BlendMode, bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA>
+static void RasterSprite(PS_GPU *gpu, const gpu_raster_job *job)
+{
+   DispatchSprite<textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(gpu, job->sprite.flip,
+         job->sprite.x, job->sprite.y, job->sprite.w, job->sprite.h,
+         job->sprite.u, job->sprite.v, job->sprite.color, job->sprite.clut);
+}
+
+template<bool textured, int BlendMode, bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA>
+static void QueueSprite(PS_GPU *gpu, int32_t x, int32_t y, int32_t w, int32_t h,
+      uint8_t u, uint8_t v, uint32_t color, uint32_t clut)
+{
+   gpu_raster_rect area;
+   gpu_raster_rect reads[2];
+   unsigned num_reads = 0;
+   gpu_raster_job *job;
+
+   if(!RasterDrawArea(gpu, x, y, x + w - 1, y + h - 1, &area))
+      return;
+
+   if(textured)
+   {
+      RasterTexArea<TexMode_TA>(gpu, &reads[num_reads++]);
+
+      if(TexMode_TA < 2)
+         RasterClutArea<TexMode_TA>(clut, &reads[num_reads++]);
+   }
+
+   job = GPU_RasterNewJob(gpu);
+   job->draw = RasterSprite<textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>;
+   job->sprite.x = x;
+   job->sprite.y = y;
+   job->sprite.w = w;
+   job->sprite.h = h;
+   job->sprite.u = u;
+   job->sprite.v = v;
+   job->sprite.color = color;
+   job->sprite.clut = clut;
+   job->sprite.flip = gpu->SpriteFlip;
+
+   GPU_RasterSubmit(&area, reads, num_reads);
+}
+
 template<uint8_t raw_size, bool textured, int BlendMode,
    bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA>
 static void Command_DrawSprite(PS_GPU *gpu, const uint32_t *cb)
@@ -232,34 +545,8 @@ static void Command_DrawSprite(PS_GPU *gpu, const uint32_t *cb)
    if (!rsx_intf_has_software_renderer())
       return;
 
-   switch(gpu->SpriteFlip & 0x3000)
-   {
-      case 0x0000:
-         if(!TexMult || color == 0x808080)
-            DrawSprite<textured, BlendMode, false, TexMode_TA, MaskEval_TA, false, false>(gpu, x, y, w, h, u, v, color, clut);
-         else
-            DrawSprite<textured, BlendMode, true, TexMode_TA, MaskEval_TA, false, false>(gpu, x, y, w, h, u, v, color, clut);
-         break;
+   if (GPU_RasterActive())
+      QueueSprite<textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(gpu, x, y, w, h, u, v, color, clut);
 
-      case 0x1000:
-         if(!TexMult || color == 0x808080)
-            DrawSprite<textured, BlendMode, false, TexMode_TA, MaskEval_TA, true, false>(gpu, x, y, w, h, u, v, color, clut);
-         else
-            DrawSprite<textured, BlendMode, true, TexMode_TA, MaskEval_TA, true, false>(gpu, x, y, w, h, u, v, color, clut);
-         break;
-
-      case 0x2000:
-         if(!TexMult || color == 0x808080)
-            DrawSprite<textured, BlendMode, false, TexMode_TA, MaskEval_TA, false, true>(gpu, x, y, w, h, u, v, color, clut);
-         else
-            DrawSprite<textured, BlendMode, true, TexMode_TA, MaskEval_TA, false, true>(gpu, x, y, w, h, u, v, color, clut);
-         break;
-
-      case 0x3000:
-         if(!TexMult || color == 0x808080)
-            DrawSprite<textured, BlendMode, false, TexMode_TA, MaskEval_TA, true, true>(gpu, x, y, w, h, u, v, color, clut);
-         else
-            DrawSprite<textured, BlendMode, true, TexMode_TA, MaskEval_TA, true, true>(gpu, x, y, w, h, u, v, color, clut);
-         break;
-   }
+   DispatchSprite<textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(gpu, gpu->SpriteFlip, x, y, w, h, u, v, color, clut);
 }
@@ -0,0 +1,517 @@
+#include "psx.h"
+#include "gpu_threads.h"
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+
+#define RASTER_MAX_THREADS 8
+
+// Must be a power of 2.  Big enough for a frame's worth of primitives in most games, so
+// lazy mode gets to drop them before it has to draw them.
+#define RASTER_QUEUE_SIZE  4096
+
+// VRAM is tracked in 32 columns of 32 pixels by 32 rows of 16 lines
+#define RASTER_TILE_X_SHIFT 5
+#define RASTER_TILE_Y_SHIFT 4
+
+struct raster_worker
+{
+   sthread_t *thread;
+
+   // This worker's copy of the GPU, sharing the main GPU's VRAM.
+   PS_GPU *gpu;
+   unsigned index;
+
+   // Number of jobs run so far, guarded by RasterLock.
+   uint32 done;
+};
+
+static raster_worker RasterWorkers[RASTER_MAX_THREADS];
+static unsigned RasterNumWorkers = 0;
+
+static gpu_raster_job RasterQueue[RASTER_QUEUE_SIZE];
+
+static slock_t *RasterLock     = NULL;
+static scond_t *RasterWorkCond = NULL;
+static scond_t *RasterDoneCond = NULL;
+
+// Guarded by RasterLock
+static uint32 RasterSubmitted;
+static unsigned RasterSleeping;
+static bool RasterWaiting;
+static bool RasterQuit;
+
+// Only touched by the emulation thread: the oldest job that may still be
+// running, and the tiles the running jobs write and read.
+static uint32 RasterRetired;
+static uint32 RasterPendingWrite[32];
+static uint32 RasterPendingRead[32];
+
+// Lazy mode's copy of the GPU, NULL when it's off.
+static PS_GPU *RasterLazyGPU = NULL;
+
+static bool TestTiles(const uint32 *tiles, const gpu_raster_rect *rect)
+{
+   uint32 columns = RasterTileSpan(rect->x, rect->w, 1024, RASTER_TILE_X_SHIFT);
+   uint32 rows    = RasterTileSpan(rect->y, rect->h, 512, RASTER_TILE_Y_SHIFT);
+   unsigned row;
+
+   if(!columns)
+      return false;
+
+   for(row = 0; row < 32; row++)
+   {
+      if(((rows >> row) & 1) && (tiles[row] & columns))
+         return true;
+   }
+
+   return false;
+}
+
+static void MarkTiles(uint32 *tiles, const gpu_raster_rect *rect)
+{
+   uint32 columns = RasterTileSpan(rect->x, rect->w, 1024, RASTER_TILE_X_SHIFT);
+   uint32 rows    = RasterTileSpan(rect->y, rect->h, 512, RASTER_TILE_Y_SHIFT);
+   unsigned row;
+
+   for(row = 0; row < 32; row++)
+   {
+      if((rows >> row) & 1)
+         tiles[row] |= columns;
+   }
+}
+
+static bool RectsOverlap(const gpu_raster_rect *a, const gpu_raster_rect *b)
+{
+   return (RasterTileSpan(a->x, a->w, 1024, RASTER_TILE_X_SHIFT) & RasterTileSpan(b->x, b->w, 1024, RASTER_TILE_X_SHIFT)) &&
+      (RasterTileSpan(a->y, a->h, 512, RASTER_TILE_Y_SHIFT) & RasterTileSpan(b->y, b->h, 512, RASTER_TILE_Y_SHIFT));
+}
+
+// Whether [a, a + alen) lies within [b, b + blen), wrapping around at limit.
+static bool SpanInside(uint32 a, uint32 alen, uint32 b, uint32 blen, uint32 limit)
+{
+   if(blen >= limit)
+      return true;
+
+   return alen <= blen && ((a - b) & (limit - 1)) <= blen - alen;
+}
+
+static bool RectInside(const gpu_raster_rect *a, const gpu_raster_rect *b)
+{
+   if(!a->w || !a->h)
+      return false;
+
+   return SpanInside(a->x, a->w, b->x, b->w, 1024) && SpanInside(a->y, a->h, b->y, b->h, 512);
+}
+
+// Draws the oldest queued jobs until no more than max_pending are left.
+static void RasterLazyRun(uint32 max_pending)
+{
+   while(RasterSubmitted - RasterRetired > max_pending)
+   {
+      const gpu_raster_job *job = &RasterQueue[RasterRetired++ & (RASTER_QUEUE_SIZE - 1)];
+
+      if(!job->draw)
+         continue;
+
+      GPU_RasterLoadState(RasterLazyGPU, &job->state);
+      job->draw(RasterLazyGPU, job);
+   }
+}
+
+// Drops the queued jobs that only write inside area, about to be overwritten, unless a
+// job after them still reads what they wrote.
+static void RasterLazyDrop(const gpu_raster_rect *area)
+{
+   uint32 reads[32];
+   uint32 i;
+
+   memset(reads, 0, sizeof(reads));
+
+   for(i = RasterSubmitted; i != RasterRetired; )
+   {
+      gpu_raster_job *job = &RasterQueue[--i & (RASTER_QUEUE_SIZE - 1)];
+      unsigned j;
+
+      if(!job->draw)
+         continue;
+
+      if(RectInside(&job->area, area) && !TestTiles(reads, &job->area))
+      {
+         job->draw = NULL;
+         continue;
+      }
+
+      for(j = 0; j < job->num_reads; j++)
+         MarkTiles(reads, &job->reads[j]);
+   }
+}
+
+// The oldest job some worker hasn't finished yet; called with RasterLock held.
+static uint32 RasterMinDone(void)
+{
+   uint32 lag = 0;
+   unsigned i;
+
+   for(i = 0; i < RasterNumWorkers; i++)
+   {
+      uint32 l = RasterSubmitted - RasterWorkers[i].done;
+
+      if(l > lag)
+         lag = l;
+   }
+
+   return RasterSubmitted - lag;
+}
+
+// Waits until no more than max_pending jobs are still running.
+static void RasterWait(uint32 max_pending)
+{
+   if(RasterSubmitted - RasterRetired <= max_pending)
+      return;
+
+   if(RasterLazyGPU)
+   {
+      RasterLazyRun(max_pending);
+      return;
+   }
+
+   slock_lock(RasterLock);
+
+   RasterWaiting = true;
+
+   while(RasterSubmitted - RasterMinDone() > max_pending)
+      scond_wait(RasterDoneCond, RasterLock);
+
+   RasterWaiting = false;
+   RasterRetired = RasterMinDone();
+
+   slock_unlock(RasterLock);
+}
+
+static void RunJob(raster_worker *w, const gpu_raster_job *job)
+{
+   GPU_RasterLoadState(w->gpu, &job->state);
+
+   if(!job->exclusive)
+   {
+      job->draw(w->gpu, job);
+      return;
+   }
+
+   if(w->index != 0)
+      return;
+
+   // Nothing else is in flight, draw all of the lines.
+   w->gpu->RasterLineStride = 1;
+   job->draw(w->gpu, job);
+   w->gpu->RasterLineStride = RasterNumWorkers;
+}
+
+static void RasterThread(void *data)
+{
+   raster_worker *w = (raster_worker*)data;
+
+   slock_lock(RasterLock);
+
+   for(;;)
+   {
+      uint32 i, end;
+
+      while(w->done == RasterSubmitted && !RasterQuit)
+      {
+         RasterSleeping++;
+         scond_wait(RasterWorkCond, RasterLock);
+         RasterSleeping--;
+      }
+
+      if(w->done == RasterSubmitted)
+         break;
+
+      end = RasterSubmitted;
+      slock_unlock(RasterLock);
+
+      for(i = w->done; i != end; i++)
+         RunJob(w, &RasterQueue[i & (RASTER_QUEUE_SIZE - 1)]);
+
+      slock_lock(RasterLock);
+      w->done = end;
+
+      if(RasterWaiting)
+         scond_signal(RasterDoneCond);
+   }
+
+   slock_unlock(RasterLock);
+}
+
+void GPU_RasterStart(PS_GPU *gpu, unsigned count)
+{
+   unsigned i;
+
+   GPU_RasterStop(gpu);
+
+   if(!count)
+      return;
+
+   if(count > RASTER_MAX_THREADS)
+      count = RASTER_MAX_THREADS;
+
+   RasterLock     = slock_new();
+   RasterWorkCond = scond_new();
+   RasterDoneCond = scond_new();
+
+   RasterSubmitted = 0;
+   RasterRetired   = 0;
+   RasterSleeping  = 0;
+   RasterWaiting   = false;
+   RasterQuit      = false;
+
+   memset(RasterPendingWrite, 0, sizeof(RasterPendingWrite));
+   memset(RasterPendingRead, 0, sizeof(RasterPendingRead));
+
+   RasterNumWorkers = count;
+
+   for(i = 0; i < count; i++)
+   {
+      raster_worker *w = &RasterWorkers[i];
+
+      w->gpu                   = new PS_GPU(*gpu);
+      w->gpu->RasterLineStride = count;
+      w->gpu->RasterLinePhase  = i;
+      w->index                 = i;
+      w->done                  = 0;
+   }
+
+   for(i = 0; i < count; i++)
+      RasterWorkers[i].thread = sthread_create(RasterThread, &RasterWorkers[i]);
+
+   // From now on the GPU itself only keeps the timing
+   gpu->RasterLineStride = 1;
+   gpu->RasterLinePhase  = 1;
+}
+
+void GPU_RasterStartLazy(PS_GPU *gpu)
+{
+   GPU_RasterStop(gpu);
+
+   RasterSubmitted = 0;
+   RasterRetired   = 0;
+
+   memset(RasterPendingWrite, 0, sizeof(RasterPendingWrite));
+   memset(RasterPendingRead, 0, sizeof(RasterPendingRead));
+
+   RasterLazyGPU                   = new PS_GPU(*gpu);
+   RasterLazyGPU->RasterLineStride = 1;
+   RasterLazyGPU->RasterLinePhase  = 0;
+
+   // Like with the threads, the GPU itself only keeps the timing
+   gpu->RasterLineStride = 1;
+   gpu->RasterLinePhase  = 1;
+}
+
+bool GPU_RasterLazy(void)
+{
+   return RasterLazyGPU != NULL;
+}
+
+void GPU_RasterStop(PS_GPU *gpu)
+{
+   unsigned i;
+
+   if(RasterLazyGPU)
+   {
+      GPU_RasterSync();
+
+      delete RasterLazyGPU;
+      RasterLazyGPU = NULL;
+
+      gpu->RasterLineStride = 1;
+      gpu->RasterLinePhase  = 0;
+   }
+
+   if(!RasterNumWorkers)
+      return;
+
+   GPU_RasterSync();
+
+   slock_lock(RasterLock);
+   RasterQuit = true;
+   scond_broadcast(RasterWorkCond);
+   slock_unlock(RasterLock);
+
+   for(i = 0; i < RasterNumWorkers; i++)
+   {
+      sthread_join(RasterWorkers[i].thread);
+      delete RasterWorkers[i].gpu;
+
+      RasterWorkers[i].thread = NULL;
+      RasterWorkers[i].gpu    = NULL;
+   }
+
+   scond_free(RasterDoneCond);
+   scond_free(RasterWorkCond);
+   slock_free(RasterLock);
+
+   RasterDoneCond   = NULL;
+   RasterWorkCond   = NULL;
+   RasterLock       = NULL;
+   RasterNumWorkers = 0;
+
+   gpu->RasterLineStride = 1;
+   gpu->RasterLinePhase  = 0;
+}
+
+bool GPU_RasterActive(void)
+{
+   return RasterNumWorkers != 0 || RasterLazyGPU;
+}
+
+void GPU_RasterSync(void)
+{
+   if(!GPU_RasterActive())
+      return;
+
+   RasterWait(0);
+
+   memset(RasterPendingWrite, 0, sizeof(RasterPendingWrite));
+   memset(RasterPendingRead, 0, sizeof(RasterPendingRead));
+}
+
+void GPU_RasterRead(const gpu_raster_rect *rect)
+{
+   if(!GPU_RasterActive())
+      return;
+
+   if(TestTiles(RasterPendingWrite, rect))
+      GPU_RasterSync();
+}
+
+void GPU_RasterWrite(const gpu_raster_rect *rect)
+{
+   if(!GPU_RasterActive())
+      return;
+
+   if(TestTiles(RasterPendingWrite, rect) || TestTiles(RasterPendingRead, rect))
+      GPU_RasterSync();
+}
+
+gpu_raster_job *GPU_RasterNewJob(PS_GPU *gpu)
+{
+   gpu_raster_job *job;
+
+   RasterWait(RASTER_QUEUE_SIZE - 1);
+
+   job = &RasterQueue[RasterSubmitted & (RASTER_QUEUE_SIZE - 1)];
+   job->exclusive = false;
+   job->overwrite = false;
+   GPU_RasterSaveState(gpu, &job->state);
+
+   return job;
+}
+
+void GPU_RasterSubmit(const gpu_raster_rect *area, const gpu_raster_rect *reads, unsigned num_reads)
+{
+   gpu_raster_job *job = &RasterQueue[RasterSubmitted & (RASTER_QUEUE_SIZE - 1)];
+   unsigned i;
+
+   // The display lines have to see VRAM from before this job
+   GPU_ScanoutWriting(area);
+
+   // A worker may only start on lines it doesn't own once the jobs
+   // reading them (or writing what this one reads) are done with.
+   // A single worker runs everything in order by itself.
+   if(RasterNumWorkers > 1)
+   {
+      bool sync = TestTiles(RasterPendingRead, area);
+
+      for(i = 0; i < num_reads; i++)
+      {
+         if(TestTiles(RasterPendingWrite, &reads[i]))
+            sync = true;
+
+         if(RectsOverlap(&reads[i], area))
+            job->exclusive = true;
+      }
+
+      if(sync || job->exclusive)
+         GPU_RasterSync();
+   }
+
+   MarkTiles(RasterPendingWrite, area);
+
+   for(i = 0; i < num_reads; i++)
+      MarkTiles(RasterPendingRead, &reads[i]);
+
+   job->area      = *area;
+   job->num_reads = num_reads;
+
+   for(i = 0; i < num_reads; i++)
+      job->reads[i] = reads[i];
+
+   if(RasterLazyGPU)
+   {
+      if(job->overwrite)
+         RasterLazyDrop(area);
+
+      RasterSubmitted++;
+      return;
+   }
+
+   slock_lock(RasterLock);
+   RasterSubmitted++;
+
+   if(RasterSleeping)
+      scond_broadcast(RasterWorkCond);
+
+   slock_unlock(RasterLock);
+
+   if(job->exclusive)
+      GPU_RasterSync();
+}
+
+#else
+
+void GPU_RasterStart(PS_GPU *gpu, unsigned count)
+{
+}
+
+void GPU_RasterStop(PS_GPU *gpu)
+{
+}
+
+void GPU_RasterStartLazy(PS_GPU *gpu)
+{
+}
+
+bool GPU_RasterLazy(void)
+{
+   return false;
+}
+
+bool GPU_RasterActive(void)
+{
+   return false;
+}
+
+void GPU_RasterSync(void)
+{
+}
+
+void GPU_RasterRead(const gpu_raster_rect *rect)
+{
+}
+
+void GPU_RasterWrite(const gpu_raster_rect *rect)
+{
+}
+
+gpu_raster_job *GPU_RasterNewJob(PS_GPU *gpu)
+{
+   return NULL;
+}
+
+void GPU_RasterSubmit(const gpu_raster_rect *area, const gpu_raster_rect *reads, unsigned num_reads)
+{
+}
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef __MDFN_PSX_GPU_THREADS_H
+#define __MDFN_PSX_GPU_THREADS_H
+
+// Multi-threaded software rasterizer.
+//
+// Every primitive is handed to all of the worker threads, and worker i of N only draws the
+// native VRAM lines for which (y % N) == i, so each pixel is still written by one thread, in
+// command order.  The emulation thread runs the same rasterizer code without drawing anything
+// to keep the DrawTimeAvail accounting, and only waits for the workers when it has to touch
+// VRAM that a queued primitive reads or writes(tracked in 32x16 tiles), and at the end of
+// every frame.
+//
+// With a single worker this is just an asynchronous GPU thread: it draws everything, in
+// order, while the emulation thread goes on with the CPU and the rest of the system.
+//
+// Lazy mode(GPU_RasterStartLazy()) uses the same queue as a display list with no threads
+// at all: primitives are only drawn, in order and on the emulation thread, once something
+// touches VRAM they read or write, or the queue is full.  A fill drops the queued
+// primitives it entirely paints over that nothing reads in between, so the frames nobody
+// looks at(frameskip, headless runs) mostly never get drawn.
+
+// A VRAM rectangle in native coordinates; wraps around at 1024x512 like GPU addressing does.
+struct gpu_raster_rect
+{
+   uint32 x, y;
+   uint32 w, h;
+};
+
+// Bitmap of the tiles, 1 << shift texels each, covering [start, start + len) wrapping around
+// at limit.
+static INLINE uint64 RasterTileSpan(uint32 start, uint32 len, uint32 limit, unsigned shift)
+{
+   uint32 first, last;
+
+   if(!len)
+      return 0;
+
+   if(len >= limit)
+      return ~(uint64)0;
+
+   start &= limit - 1;
+   first  = start >> shift;
+   last   = ((start + len - 1) & (limit - 1)) >> shift;
+
+   if(start + len > limit)
+      return (~(uint64)0 << first) | ((2ULL << last) - 1);
+
+   return ((2ULL << last) - 1) & ~((1ULL << first) - 1);
+}
+
+// The parts of the GPU state the rasterizer reads, copied into every job so the workers
+// never look at the emulation thread's GPU.
+struct gpu_raster_state
+{
+   int32 ClipX0, ClipY0;
+   int32 ClipX1, ClipY1;
+
+   uint32 MaskSetOR;
+
+   uint32 TexPageX;
+   uint32 TexPageY;
+   uint8 tww, twh, twx, twy;
+
+   bool dtd;
+   bool dfe;
+   uint8 dither_upscale_shift;
+
+   // For LineSkipTest()
+   uint32 DisplayMode;
+   uint32 DisplayFB_YStart;
+   bool field_ram_readout;
+};
+
+struct gpu_raster_job
+{
+   // Called on each worker with its own copy of the GPU, already loaded with state.
+   void (*draw)(PS_GPU *gpu, const gpu_raster_job *job);
+
+   gpu_raster_state state;
+
+   // Set for primitives texturing from their own drawing area; the first worker then
+   // draws it alone, with no other job in flight.
+   bool exclusive;
+
+   // Set for jobs writing every pixel of their area whatever was there(fills); see lazy mode.
+   bool overwrite;
+
+   // What GPU_RasterSubmit() was given, for lazy mode.  Dropped jobs have draw set to NULL.
+   gpu_raster_rect area;
+   gpu_raster_rect reads[2];
+   unsigned num_reads;
+
+   union
+   {
+      struct
+      {
+         tri_vertex vertices[3];
+         uint32 clut;
+      } tri;
+
+      struct
+      {
+         int32 x, y, w, h;
+         uint8 u, v;
+         uint32 color;
+         uint32 clut;
+         uint32 flip;
+      } sprite;
+
+      struct
+      {
+         line_point points[2];
+      } line;
+
+      struct
+      {
+         uint16 value;
+         int32 x, y, w, h;
+      } fill;
+
+      // VRAM the emulation thread writes itself
+      gpu_raster_rect vram_write;
+   };
+};
+
+// count == 0 stops the threads; the GPU then draws by itself again.
+void GPU_RasterStart(PS_GPU *gpu, unsigned count);
+void GPU_RasterStop(PS_GPU *gpu);
+
+// Lazy mode instead of the threads; stopped by GPU_RasterStop() and GPU_RasterStart() too.
+// Only available with HAVE_THREADS, like the rest of the queue.
+void GPU_RasterStartLazy(PS_GPU *gpu);
+bool GPU_RasterLazy(void);
+
+// Whether primitives go through the queue(threads or lazy mode)
+bool GPU_RasterActive(void);
+
+// Waits until all of the queued primitives have been drawn(or draws them, in lazy mode).
+void GPU_RasterSync(void);
+
+// Called before the emulation thread reads or writes VRAM itself; waits for the workers if
+// a queued primitive writes(or, for VRAM writes, reads) any of the rectangle.
+void GPU_RasterRead(const gpu_raster_rect *rect);
+void GPU_RasterWrite(const gpu_raster_rect *rect);
+
+// Returns the next job slot, with state filled in from gpu.  The caller sets draw and the
+// primitive parameters, then queues it with GPU_RasterSubmit(), passing the area the
+// primitive may draw to and the texture/CLUT areas it reads.
+gpu_raster_job *GPU_RasterNewJob(PS_GPU *gpu);
+void GPU_RasterSubmit(const gpu_raster_rect *area, const gpu_raster_rect *reads, unsigned num_reads);
+
+// Implemented in gpu.cpp, next to the rasterizer they feed.
+void GPU_RasterSaveState(const PS_GPU *gpu, gpu_raster_state *state);
+void GPU_RasterLoadState(PS_GPU *gpu, const gpu_raster_state *state);
+
+// Implemented in gpu.cpp; outputs the display lines still waiting for it if a primitive
+// about to be queued may draw over VRAM they read.
+void GPU_ScanoutWriting(const gpu_raster_rect *area);
+
+#endif
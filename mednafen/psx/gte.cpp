@@ -27,6 +27,7 @@
 #include "../pgxp/pgxp_main.h"
 
 extern bool psx_cpu_overclock;
+extern bool psx_gte_lazy_flags;
 
 #include "../clamp.h"
 
@@ -161,6 +162,29 @@ static uint32_t Reg23;        /* Register 23: 32bit read/write but not used for
 
 // end DR
 
+/* Lazy FLAG computation(psx_gte_lazy_flags): most commands are run with Flags == false,
+ * which keeps only the saturation and truncation the results need.  The DR values those
+ * commands can read are kept in ReplayState, and FLAGS/CR[31] are rebuilt by running
+ * the command again with Flags == true on that copy, but only if CR[31] is read or the
+ * state is saved before the next command replaces them.  Nothing else reads FLAGS,
+ * except the chained OTZ saturation in AVSZ3/AVSZ4, which is never deferred. */
+typedef struct
+{
+   int16_t Vectors[3][4];
+   gtergb RGB;
+   int16_t IR[4];
+   int32_t MAC[4];
+   gtergb RGB_FIFO[3];
+   unsigned char widescreen_hack;
+} gte_replay_state;
+
+static gte_replay_state ReplayState;
+static uint32_t ReplayInstr;
+static bool FlagsPending = false;
+static bool FlagsReplaying = false;
+
+static void ResolvePendingFlags(void);
+
 extern "C" unsigned char widescreen_hack;
 
 static INLINE uint8_t Sat5(int16_t cc)
@@ -238,11 +262,16 @@ void GTE_Power(void)
    LZCR = 0;
 
    Reg23 = 0;
+
+   FlagsPending = false;
 }
 
 // TODO: Don't save redundant state, regarding CR cache variables
 int GTE_StateAction(StateMem *sm, int load, int data_only)
 {
+   if(!load)
+      ResolvePendingFlags();
+
    SFORMAT StateRegs[] =
    {
       { CR, (uint32_t)(32 * sizeof(uint32_t)), MDFNSTATE_RLSB32 | 0, "CR" },
@@ -292,7 +321,7 @@ int GTE_StateAction(StateMem *sm, int load, int data_only)
 
    if(load)
    {
-
+      FlagsPending = false;
    }
 
    return(ret);
@@ -317,6 +346,12 @@ void GTE_WriteCR(unsigned int which, uint32_t value)
 
    //PSX_WARNING("[GTE] Write CR %d, 0x%08x", which, value);
 
+   /* The pending command's inputs include the CRs, which aren't kept in ReplayState */
+   if(which == 31)
+      FlagsPending = false;
+   else
+      ResolvePendingFlags();
+
    value &= mask_table[which];
 
    CR[which] = value | (CR[which] & ~mask_table[which]);
@@ -416,6 +451,7 @@ uint32_t GTE_ReadCR(unsigned int which)
          break;
 
       case 31:
+         ResolvePendingFlags();
          ret = CR[31];
          break;
    }
@@ -720,13 +756,17 @@ uint32_t GTE_ReadDR(unsigned int which)
 
 /* Truncate i64 value to only keep the low 43 bits + sign and
  * update the flags if an overflow occurs */
+template<bool Flags>
 static INLINE int64_t i64_to_i44(unsigned which, int64_t value)
 {
-   if(value >= 0x7ffffffffffLL)
-      FLAGS |= 1 << (30 - which);
+   if(Flags)
+   {
+      if(value >= 0x7ffffffffffLL)
+         FLAGS |= 1 << (30 - which);
 
-   if(value < -0x80000000000LL)
-      FLAGS |= 1 << (27 - which);
+      if(value < -0x80000000000LL)
+         FLAGS |= 1 << (27 - which);
+   }
 
    return (((int64_t)((uint64_t)(value) << (64 - 44))) >> (64 - 44));
 }
@@ -736,6 +776,7 @@ static INLINE int64_t i64_to_i44(unsigned which, int64_t value)
  * overflow and updating the flags if an overflow occurs. If
  * `flags.clamp_negative` is true negative values will be clamped
  * to 0. */
+template<bool Flags>
 static INLINE int16_t i32_to_i16_saturate(unsigned int which, int32_t value, int lm)
 {
    int32_t tmp = lm << 15;
@@ -743,29 +784,33 @@ static INLINE int16_t i32_to_i16_saturate(unsigned int which, int32_t value, int
    if(value < (-32768 + tmp))
    {
       // set flag here
-      FLAGS |= 1 << (24 - which);
+      if(Flags) FLAGS |= 1 << (24 - which);
       return -32768 + tmp;
    }
 
    if(value > 32767)
    {
       // Set flag here
-      FLAGS |= 1 << (24 - which);
+      if(Flags) FLAGS |= 1 << (24 - which);
       return 32767;
    }
 
    return(value);
 }
 
+template<bool Flags>
 static INLINE int16_t Lm_B_PTZ(unsigned int which, int32_t value, int32_t ftv_value, int lm)
 {
    int32_t tmp = lm << 15;
 
-   if(ftv_value < -32768)
-      FLAGS |= 1 << (24 - which);
+   if(Flags)
+   {
+      if(ftv_value < -32768)
+         FLAGS |= 1 << (24 - which);
 
-   if(ftv_value > 32767)
-      FLAGS |= 1 << (24 - which);
+      if(ftv_value > 32767)
+         FLAGS |= 1 << (24 - which);
+   }
 
    clamp(&value, (-32768 + tmp), 32767);
 
@@ -775,12 +820,13 @@ static INLINE int16_t Lm_B_PTZ(unsigned int which, int32_t value, int32_t ftv_va
 
 /* Convert a 64bit signed average value to an unsigned halfword
  * while updating the overflow flags */
+template<bool Flags>
 static INLINE uint16_t i64_to_otz(int64_t average, int unchained)
 {
    int32_t value = average >> 12;
    /* Not sure if we should have it as int64, or just chain 
     * on to and special case when the F flags are set. */
-   if(!unchained)
+   if(Flags && !unchained)
    {
       if(FLAGS & (1 << 15))
       {
@@ -798,30 +844,31 @@ static INLINE uint16_t i64_to_otz(int64_t average, int unchained)
    if(value < 0)
    {
       // Set flag here
-      FLAGS |= 1 << 18;	// Tested with AVSZ3
+      if(Flags) FLAGS |= 1 << 18;	// Tested with AVSZ3
       return 0;
    }
    else if(value > 65535)
    {
       // Set flag here.
-      FLAGS |= 1 << 18;	// Tested with AVSZ3
+      if(Flags) FLAGS |= 1 << 18;	// Tested with AVSZ3
       return 65535;
    }
 
    return value;
 }
 
+template<bool Flags>
 static INLINE int32_t i32_to_i11_saturate(uint8_t flag, int32_t value)
 {
    if(value < -0x400)
    {
-      FLAGS |= 1 << (14 - flag);
+      if(Flags) FLAGS |= 1 << (14 - flag);
       return -0x400;
    }
 
    if(value > 0x3ff)
    {
-      FLAGS |= 1 << (14 - flag);
+      if(Flags) FLAGS |= 1 << (14 - flag);
       return 0x3ff;
    }
 
@@ -829,58 +876,74 @@ static INLINE int32_t i32_to_i11_saturate(uint8_t flag, int32_t value)
 }
 
 // limit to 4096, not 4095
+template<bool Flags>
 static INLINE int32_t Lm_H(int32_t depth)
 {
    if(depth < 0)
    {
-      FLAGS |= 1 << 12;
+      if(Flags) FLAGS |= 1 << 12;
       return 0;
    }
 
    if(depth > 4096)
    {
-      FLAGS |= 1 << 12;
+      if(Flags) FLAGS |= 1 << 12;
       return 4096;
    }
 
    return depth;
 }
 
+template<bool Flags>
 static INLINE uint8_t MAC_to_COLOR(uint8_t flag, int32_t mac)
 {
    int32_t c = mac >> 4;
 
    if (c < 0)
    {
-      FLAGS |= 1 << (21 - flag);	/* Tested with GPF */
+      if(Flags) FLAGS |= 1 << (21 - flag);	/* Tested with GPF */
       return 0;
    }
    if (c > 0xff)
    {
-      FLAGS |= 1 << (21 - flag);	/* Tested with GPF */
+      if(Flags) FLAGS |= 1 << (21 - flag);	/* Tested with GPF */
       return 0xff;
    }
    return c;
 }
 
+template<bool Flags>
 static INLINE void MAC_to_RGB_FIFO(void)
 {
    RGB_FIFO[0] = RGB_FIFO[1];
    RGB_FIFO[1] = RGB_FIFO[2];
-   RGB_FIFO[2].R = MAC_to_COLOR(0, MAC[1]);
-   RGB_FIFO[2].G = MAC_to_COLOR(1, MAC[2]);
-   RGB_FIFO[2].B = MAC_to_COLOR(2, MAC[3]);
+   RGB_FIFO[2].R = MAC_to_COLOR<Flags>(0, MAC[1]);
+   RGB_FIFO[2].G = MAC_to_COLOR<Flags>(1, MAC[2]);
+   RGB_FIFO[2].B = MAC_to_COLOR<Flags>(2, MAC[3]);
    RGB_FIFO[2].CD = RGB.CD;
 }
 
 
+template<bool Flags>
 static INLINE void MAC_to_IR(int lm)
 {
-   IR1 = i32_to_i16_saturate(0, MAC[1], lm);
-   IR2 = i32_to_i16_saturate(1, MAC[2], lm);
-   IR3 = i32_to_i16_saturate(2, MAC[3], lm);
+   IR1 = i32_to_i16_saturate<Flags>(0, MAC[1], lm);
+   IR2 = i32_to_i16_saturate<Flags>(1, MAC[2], lm);
+   IR3 = i32_to_i16_saturate<Flags>(2, MAC[3], lm);
+}
+
+/* True if (crv << 12) plus any three 16x16 products can't leave the 44-bit range (the
+ * most each product adds is 2^30), so the step-by-step overflow checks and truncation
+ * in MultiplyMatrixByVector<Flags>() and RTP<Flags>() would do nothing.  That's the usual case; only
+ * translation/background values within 2^20 of the int32 limits fail it. */
+static INLINE bool CRV_FitsI44(const int32_t *crv)
+{
+   return ((uint32_t)crv[0] + 0x7FF00000U) < 0xFFE00000U &&
+          ((uint32_t)crv[1] + 0x7FF00000U) < 0xFFE00000U &&
+          ((uint32_t)crv[2] + 0x7FF00000U) < 0xFFE00000U;
 }
 
+template<bool Flags>
 static INLINE void MultiplyMatrixByVector(const gtematrix *matrix, const int16_t *v, const int32_t *crv, uint32_t sf, int lm)
 {
    unsigned i;
@@ -892,25 +955,36 @@ static INLINE void MultiplyMatrixByVector(const gtematrix *matrix, const int16_t
          for(i = 0; i < 3; i++)
          {
             int64_t tmp = (uint64_t)(int64_t)crv[i] << 12;
-            tmp = i64_to_i44(i, tmp + (matrix->MX[i][0] * v[0]));
-            i32_to_i16_saturate(i, tmp >> sf, false);
+            tmp = i64_to_i44<Flags>(i, tmp + (matrix->MX[i][0] * v[0]));
+            i32_to_i16_saturate<Flags>(i, tmp >> sf, false);
 
-            tmp = i64_to_i44(i, (matrix->MX[i][1] * v[1]));
-            tmp = i64_to_i44(i, tmp + (matrix->MX[i][2] * v[2]));
+            tmp = i64_to_i44<Flags>(i, (matrix->MX[i][1] * v[1]));
+            tmp = i64_to_i44<Flags>(i, tmp + (matrix->MX[i][2] * v[2]));
 
             /* Store the results in the accumulator */
             MAC[1 + i] = tmp >> sf;
          }
       }
+      else if(MDFN_LIKELY(CRV_FitsI44(crv)))
+      {
+         for(i = 0; i < 3; i++)
+         {
+            int64_t tmp = (uint64_t)(int64_t)crv[i] << 12;
+
+            tmp += (int64_t)(matrix->MX[i][0] * v[0]) + matrix->MX[i][1] * v[1] + matrix->MX[i][2] * v[2];
+
+            MAC[1 + i] = tmp >> sf;
+         }
+      }
       else
       {
          for(i = 0; i < 3; i++)
          {
             int64_t tmp = (uint64_t)(int64_t)crv[i] << 12;
 
-            tmp = i64_to_i44(i, tmp + (matrix->MX[i][0] * v[0]));
-            tmp = i64_to_i44(i, tmp + (matrix->MX[i][1] * v[1]));
-            tmp = i64_to_i44(i, tmp + (matrix->MX[i][2] * v[2]));
+            tmp = i64_to_i44<Flags>(i, tmp + (matrix->MX[i][0] * v[0]));
+            tmp = i64_to_i44<Flags>(i, tmp + (matrix->MX[i][1] * v[1]));
+            tmp = i64_to_i44<Flags>(i, tmp + (matrix->MX[i][2] * v[2]));
 
             /* Store the results in the accumulator */
             MAC[1 + i] = tmp >> sf;
@@ -939,11 +1013,11 @@ static INLINE void MultiplyMatrixByVector(const gtematrix *matrix, const int16_t
                mulr[2] = (int16_t)CR[i];
             }
 
-            tmp = i64_to_i44(i, tmp + (mulr[0] * v[0]));
-            i32_to_i16_saturate(i, tmp >> sf, false);
+            tmp = i64_to_i44<Flags>(i, tmp + (mulr[0] * v[0]));
+            i32_to_i16_saturate<Flags>(i, tmp >> sf, false);
 
-            tmp = i64_to_i44(i, (mulr[1] * v[1]));
-            tmp = i64_to_i44(i, tmp + (mulr[2] * v[2]));
+            tmp = i64_to_i44<Flags>(i, (mulr[1] * v[1]));
+            tmp = i64_to_i44<Flags>(i, tmp + (mulr[2] * v[2]));
 
             /* Store the results in the accumulator */
             MAC[1 + i] = tmp >> sf;
@@ -969,9 +1043,9 @@ static INLINE void MultiplyMatrixByVector(const gtematrix *matrix, const int16_t
                mulr[2] = (int16_t)CR[i];
             }
 
-            tmp = i64_to_i44(i, tmp + (mulr[0] * v[0]));
-            tmp = i64_to_i44(i, tmp + (mulr[1] * v[1]));
-            tmp = i64_to_i44(i, tmp + (mulr[2] * v[2]));
+            tmp = i64_to_i44<Flags>(i, tmp + (mulr[0] * v[0]));
+            tmp = i64_to_i44<Flags>(i, tmp + (mulr[1] * v[1]));
+            tmp = i64_to_i44<Flags>(i, tmp + (mulr[2] * v[2]));
 
             /* Store the results in the accumulator */
             MAC[1 + i] = tmp >> sf;
@@ -979,10 +1053,11 @@ static INLINE void MultiplyMatrixByVector(const gtematrix *matrix, const int16_t
       }
    }
 
-   MAC_to_IR(lm);
+   MAC_to_IR<Flags>(lm);
 }
 
 /* SQR - Square Vector */
+template<bool Flags>
 static int32_t SQR(uint32_t instr)
 {
    unsigned i;
@@ -995,7 +1070,7 @@ static int32_t SQR(uint32_t instr)
       MAC[i]     = (ir * ir) >> sf;
    }
 
-   MAC_to_IR(lm);
+   MAC_to_IR<Flags>(lm);
 
    return(5);
 }
@@ -1003,6 +1078,7 @@ static int32_t SQR(uint32_t instr)
 
 /* MVMVA - Multiply Vector by Matrix And Vector Add */
 
+template<bool Flags>
 static int32_t MVMVA(uint32_t instr)
 {
    int16_t v[3];
@@ -1025,11 +1101,12 @@ static int32_t MVMVA(uint32_t instr)
       v[2] = Vectors[v_i][2];
    }
 
-   MultiplyMatrixByVector(&Matrices.All[mx], v, cv, sf, lm);
+   MultiplyMatrixByVector<Flags>(&Matrices.All[mx], v, cv, sf, lm);
 
    return(8);
 }
 
+template<bool Flags>
 static INLINE uint32_t Divide(uint32_t dividend, uint32_t divisor)
 {
    if((divisor * 2) > dividend)
@@ -1047,18 +1124,23 @@ static INLINE uint32_t Divide(uint32_t dividend, uint32_t divisor)
    /* If the Z coordinate is smaller than or equal to half the 
     * projection plane distance, we clip it */
 
-   FLAGS |= 1 << 17;
+   if(Flags) FLAGS |= 1 << 17;
    return 0x1FFFF;
 }
 
+template<bool Flags>
 static INLINE void check_mac_overflow(int64_t value)
 {
-   if(value < -2147483648LL)
-      FLAGS |= 1 << 15;
-   if(value > 2147483647LL)
-      FLAGS |= 1 << 16;
+   if(Flags)
+   {
+      if(value < -2147483648LL)
+         FLAGS |= 1 << 15;
+      if(value > 2147483647LL)
+         FLAGS |= 1 << 16;
+   }
 }
 
+template<bool Flags>
 static INLINE void TransformXY(int64_t h_div_sz, float precise_h_div_sz, uint16 z)
 {
    float fofx       = ((float)OFX / (float)(1 << 16));
@@ -1068,15 +1150,15 @@ static INLINE void TransformXY(int64_t h_div_sz, float precise_h_div_sz, uint16
    int64_t screen_x = (int64_t)OFX + IR1 * h_div_sz * ((widescreen_hack) ? 0.75 : 1.00);
    int64_t screen_y = (int64_t)OFY + IR2 * h_div_sz;
 
-   check_mac_overflow(screen_x);
-   check_mac_overflow(screen_y);
+   check_mac_overflow<Flags>(screen_x);
+   check_mac_overflow<Flags>(screen_y);
 
    screen_x = (int32_t)(screen_x >> 16);
    screen_y = (int32_t)(screen_y >> 16);
 
    /* Push onto the XY FIFO */
-   XY_FIFO[3].X = i32_to_i11_saturate(0, screen_x);
-   XY_FIFO[3].Y = i32_to_i11_saturate(1, screen_y);
+   XY_FIFO[3].X = i32_to_i11_saturate<Flags>(0, screen_x);
+   XY_FIFO[3].Y = i32_to_i11_saturate<Flags>(1, screen_y);
 
    XY_FIFO[0] = XY_FIFO[1];
    XY_FIFO[1] = XY_FIFO[2];
@@ -1090,12 +1172,16 @@ static INLINE void TransformXY(int64_t h_div_sz, float precise_h_div_sz, uint16
    precise_x = float_max(-0x400, float_min(precise_x, 0x3ff));
    precise_y = float_max(-0x400, float_min(precise_y, 0x3ff));
 
-   uint32 value = *((uint32*)&XY_FIFO[3]);
-   PGXP_pushSXYZ2f(precise_x, precise_y, (float)z, value);
+   if(!FlagsReplaying)
+   {
+      uint32 value = *((uint32*)&XY_FIFO[3]);
+      PGXP_pushSXYZ2f(precise_x, precise_y, (float)z, value);
+   }
 }
 
 /* Perform depth queuing calculations using the projection
  * factor computed by the 'RTP' command */
+template<bool Flags>
 static INLINE void depth_queuing(int64_t h_div_sz)
 {
    int64_t factor = (int64_t)h_div_sz;
@@ -1103,19 +1189,20 @@ static INLINE void depth_queuing(int64_t h_div_sz)
    int64_t dqb    = (int64_t)DQB;
    uint64_t depth = dqb + dqa * factor;
 
-   check_mac_overflow(depth);
+   check_mac_overflow<Flags>(depth);
 
    MAC[0] = (int32_t)depth;
 
    /* compute 16bit IR value */
    depth = depth >> 12;
 
-   IR0    = Lm_H(((int64_t)depth));
+   IR0    = Lm_H<Flags>(((int64_t)depth));
 }
 
 /* Rotate, Translate and Perspective transform a single vector
  * Returns the projection factor that's also used for depth 
  * queuing */
+template<bool Flags>
 static int64_t RTP(uint32_t instr, uint32_t vector_index)
 {
    unsigned i, c;
@@ -1131,8 +1218,24 @@ static int64_t RTP(uint32_t instr, uint32_t vector_index)
    const gtematrix *matrix = &Matrices.Rot;
    const int32_t *crv      = CRVectors.T;
 
+   if(MDFN_LIKELY(CRV_FitsI44(crv)))
+   {
+      const int16_t *v = Vectors[vector_index];
+      int64_t res = 0;
+
+      for(i = 0; i < 3; i++)
+      {
+         res  = (uint64_t)(int64_t)crv[i] << 12;
+         res += (int64_t)(matrix->MX[i][0] * v[0]) + matrix->MX[i][1] * v[1] + matrix->MX[i][2] * v[2];
+
+         MAC[1 + i] = res >> sf;
+      }
+
+      z_shifted_no_shift = (int32_t)(res);
+      z_shifted          = (int32_t)(res >> 12);
+   }
    /* Iterate over the matrix rows */
-   for(i = 0; i < 3; i++)
+   else for(i = 0; i < 3; i++)
    {
       /* Start with the translation. Convert translation vector
        * component from i32 to i64 with 12 fractional bits. */
@@ -1147,7 +1250,7 @@ static int64_t RTP(uint32_t instr, uint32_t vector_index)
 
          /* The operation is done using 44bit signed
           * arithmetics. */
-         res = i64_to_i44(c, res + rot);
+         res = i64_to_i44<Flags>(c, res + rot);
       }
 
       /* Store the result in the accumulator */
@@ -1163,15 +1266,15 @@ static int64_t RTP(uint32_t instr, uint32_t vector_index)
     * convert them to 16bit values in the IR vector, saturating
     * them in case of an overflow. */
 
-   IR1 = i32_to_i16_saturate(0, MAC[1], lm); /* 16bit clamped x coordinate */
-   IR2 = i32_to_i16_saturate(1, MAC[2], lm); /* 16bit clamped y coordinate */
-   IR3 = Lm_B_PTZ(2, MAC[3], z_shifted, lm); /* 16bit clamped z coordinate */
+   IR1 = i32_to_i16_saturate<Flags>(0, MAC[1], lm); /* 16bit clamped x coordinate */
+   IR2 = i32_to_i16_saturate<Flags>(1, MAC[2], lm); /* 16bit clamped y coordinate */
+   IR3 = Lm_B_PTZ<Flags>(2, MAC[3], z_shifted, lm); /* 16bit clamped z coordinate */
 
    /* Push 'z_saturated' onto the Z_FIFO */
    Z_FIFO[0] = Z_FIFO[1];
    Z_FIFO[1] = Z_FIFO[2];
    Z_FIFO[2] = Z_FIFO[3];
-   Z_FIFO[3] = i64_to_otz(z_shifted_no_shift, true);
+   Z_FIFO[3] = i64_to_otz<Flags>(z_shifted_no_shift, true);
 
    /* Step 3: perspective projection against the screen plane
     *
@@ -1179,111 +1282,120 @@ static int64_t RTP(uint32_t instr, uint32_t vector_index)
     * distance by the Z coordinate */
 
    /* Projection factor: 1.16 unsigned */
-   projection_factor = Divide(H, Z_FIFO[3]);
+   projection_factor = Divide<Flags>(H, Z_FIFO[3]);
 
    precise_h_div_sz  = (float)H / float_max(H/2.f, (float)Z_FIFO[3]); 
 
-   TransformXY(projection_factor, precise_h_div_sz, Z_FIFO[3]);
+   TransformXY<Flags>(projection_factor, precise_h_div_sz, Z_FIFO[3]);
 
    return projection_factor;
 }
 
+template<bool Flags>
 static int32_t RTPS(uint32_t instr)
 {
-   int64_t projection_factor = RTP(instr, 0);
-   depth_queuing(projection_factor);
+   int64_t projection_factor = RTP<Flags>(instr, 0);
+   depth_queuing<Flags>(projection_factor);
 
    return(15);
 }
 
 /* RTPT - Rotate, Translate and Perspective Transform Triple.
  * Operates on v0, v1 and v2 */
+template<bool Flags>
 static int32_t RTPT(uint32_t instr)
 {
    int64_t projection_factor;
-   RTP(instr, 0);
-   RTP(instr, 1);
-   projection_factor = RTP(instr, 2);
-   depth_queuing(projection_factor);
+   RTP<Flags>(instr, 0);
+   RTP<Flags>(instr, 1);
+   projection_factor = RTP<Flags>(instr, 2);
+   depth_queuing<Flags>(projection_factor);
 
    return(23);
 }
 
+template<bool Flags>
 static INLINE void NormColor(uint32_t sf, int lm, uint32_t v)
 {
    int16_t tmp_vector[3];
 
-   MultiplyMatrixByVector(&Matrices.Light, Vectors[v], CRVectors.Null, sf, lm);
+   MultiplyMatrixByVector<Flags>(&Matrices.Light, Vectors[v], CRVectors.Null, sf, lm);
 
    tmp_vector[0] = IR1; tmp_vector[1] = IR2; tmp_vector[2] = IR3;
-   MultiplyMatrixByVector(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
+   MultiplyMatrixByVector<Flags>(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
 
-   MAC_to_RGB_FIFO();
+   MAC_to_RGB_FIFO<Flags>();
 }
 
+template<bool Flags>
 static int32_t NCS(uint32_t instr)
 {
    const uint32_t sf = (instr & (1 << 19)) ? 12 : 0;
    const int      lm = (instr >> 10) & 1;
 
-   NormColor(sf, lm, 0);
+   NormColor<Flags>(sf, lm, 0);
 
    return(14);
 }
 
+template<bool Flags>
 static int32_t NCT(uint32_t instr)
 {
    unsigned i;
    const uint32_t sf = (instr & (1 << 19)) ? 12 : 0;
    const int      lm = (instr >> 10) & 1;
 
-   NormColor(sf, lm, 0);
-   NormColor(sf, lm, 1);
-   NormColor(sf, lm, 2);
+   NormColor<Flags>(sf, lm, 0);
+   NormColor<Flags>(sf, lm, 1);
+   NormColor<Flags>(sf, lm, 2);
 
    return(30);
 }
 
 /* NCC - Normal Color Color */
+template<bool Flags>
 static INLINE void NCC(uint32_t vector_index, uint32_t sf, int lm)
 {
    int16_t tmp_vector[3];
 
-   MultiplyMatrixByVector(&Matrices.Light, Vectors[vector_index], CRVectors.Null, sf, lm);
+   MultiplyMatrixByVector<Flags>(&Matrices.Light, Vectors[vector_index], CRVectors.Null, sf, lm);
 
    tmp_vector[0] = IR1; tmp_vector[1] = IR2; tmp_vector[2] = IR3;
-   MultiplyMatrixByVector(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
+   MultiplyMatrixByVector<Flags>(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
 
    MAC[1] = ((RGB.R << 4) * IR1) >> sf;
    MAC[2] = ((RGB.G << 4) * IR2) >> sf;
    MAC[3] = ((RGB.B << 4) * IR3) >> sf;
 
-   MAC_to_IR(lm);
-   MAC_to_RGB_FIFO();
+   MAC_to_IR<Flags>(lm);
+   MAC_to_RGB_FIFO<Flags>();
 }
 
+template<bool Flags>
 static int32_t NCCS(uint32_t instr)
 {
    const uint32_t sf = (instr & (1 << 19)) ? 12 : 0;
    const int      lm = (instr >> 10) & 1;
 
-   NCC(0, sf, lm);
+   NCC<Flags>(0, sf, lm);
    return(17);
 }
 
 
+template<bool Flags>
 static int32_t NCCT(uint32_t instr)
 {
    const uint32_t sf = (instr & (1 << 19)) ? 12 : 0;
    const int      lm = (instr >> 10) & 1;
 
-   NCC(0, sf, lm);
-   NCC(1, sf, lm);
-   NCC(2, sf, lm);
+   NCC<Flags>(0, sf, lm);
+   NCC<Flags>(1, sf, lm);
+   NCC<Flags>(2, sf, lm);
 
    return(39);
 }
 
+template<bool Flags>
 static INLINE void DPC(uint32_t instr)
 {
    int i;
@@ -1297,17 +1409,18 @@ static INLINE void DPC(uint32_t instr)
 
    for(i = 0; i < 3; i++)
    {
-      MAC[1 + i] = i64_to_i44(i, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[i] << 12) - (int32)((uint32)RGB_temp[i] << 12))) >> sf;
-      MAC[1 + i] = i64_to_i44(i, ((int64_t)((uint64_t)(int64_t)RGB_temp[i] << 12) + IR0 * i32_to_i16_saturate(i, MAC[1 + i], false))) >> sf;
+      MAC[1 + i] = i64_to_i44<Flags>(i, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[i] << 12) - (int32)((uint32)RGB_temp[i] << 12))) >> sf;
+      MAC[1 + i] = i64_to_i44<Flags>(i, ((int64_t)((uint64_t)(int64_t)RGB_temp[i] << 12) + IR0 * i32_to_i16_saturate<Flags>(i, MAC[1 + i], false))) >> sf;
    }
 
-   MAC_to_IR(lm);
+   MAC_to_IR<Flags>(lm);
 
-   MAC_to_RGB_FIFO();
+   MAC_to_RGB_FIFO<Flags>();
 }
 
 
 /* DCPL - Depth Cue Color Light */
+template<bool Flags>
 static int32_t DCPL(uint32_t instr)
 {
    int i;
@@ -1322,19 +1435,20 @@ static int32_t DCPL(uint32_t instr)
 
    for(i = 0; i < 3; i++)
    {
-      MAC[1 + i] = i64_to_i44(i, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[i] << 12) - RGB_temp[i] * IR_temp[i])) >> sf;
-      MAC[1 + i] = i64_to_i44(i, (RGB_temp[i] * IR_temp[i] + IR0 * i32_to_i16_saturate(i, MAC[1 + i], false))) >> sf;
+      MAC[1 + i] = i64_to_i44<Flags>(i, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[i] << 12) - RGB_temp[i] * IR_temp[i])) >> sf;
+      MAC[1 + i] = i64_to_i44<Flags>(i, (RGB_temp[i] * IR_temp[i] + IR0 * i32_to_i16_saturate<Flags>(i, MAC[1 + i], false))) >> sf;
    }
 
-   MAC_to_IR(lm);
+   MAC_to_IR<Flags>(lm);
 
-   MAC_to_RGB_FIFO();
+   MAC_to_RGB_FIFO<Flags>();
 
 
    return(8);
 }
 
 
+template<bool Flags>
 static int32_t DPCS(uint32_t instr)
 {
    int i;
@@ -1349,58 +1463,61 @@ static int32_t DPCS(uint32_t instr)
 
    for(i = 0; i < 3; i++)
    {
-      MAC[1 + i] = i64_to_i44(i, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[i] << 12) - (int32)((uint32)RGB_temp[i] << 12))) >> sf;
-      MAC[1 + i] = i64_to_i44(i, ((int64_t)((uint64_t)(int64_t)RGB_temp[i] << 12) + IR0 * i32_to_i16_saturate(i, MAC[1 + i], false))) >> sf;
+      MAC[1 + i] = i64_to_i44<Flags>(i, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[i] << 12) - (int32)((uint32)RGB_temp[i] << 12))) >> sf;
+      MAC[1 + i] = i64_to_i44<Flags>(i, ((int64_t)((uint64_t)(int64_t)RGB_temp[i] << 12) + IR0 * i32_to_i16_saturate<Flags>(i, MAC[1 + i], false))) >> sf;
    }
 
-   MAC_to_IR(lm);
-   MAC_to_RGB_FIFO();
+   MAC_to_IR<Flags>(lm);
+   MAC_to_RGB_FIFO<Flags>();
 
    return(8);
 }
 
 /* DPCT - Depth Cue Triple */
+template<bool Flags>
 static int32_t DPCT(uint32_t instr)
 {
    /* Each call uses the oldest entry in the RGB FIFO
     * and pushes the result at the top so the three calls
     * will process and replace the entire contents of the FIFO. */
-   DPC(instr);
-   DPC(instr);
-   DPC(instr);
+   DPC<Flags>(instr);
+   DPC<Flags>(instr);
+   DPC<Flags>(instr);
 
    return(17);
 }
 
 /* INTPL - Interpolate Between a vector and the far color */
 
+template<bool Flags>
 static int32_t INTPL(uint32_t instr)
 {
    const uint32_t sf = (instr & (1 << 19)) ? 12 : 0;
    const int      lm = (instr >> 10) & 1;
 
-   MAC[1] = i64_to_i44(0, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[0] << 12) - (int32)((uint32)(int32)IR1 << 12))) >> sf;
-   MAC[2] = i64_to_i44(1, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[1] << 12) - (int32)((uint32)(int32)IR2 << 12))) >> sf;
-   MAC[3] = i64_to_i44(2, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[2] << 12) - (int32)((uint32)(int32)IR3 << 12))) >> sf;
+   MAC[1] = i64_to_i44<Flags>(0, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[0] << 12) - (int32)((uint32)(int32)IR1 << 12))) >> sf;
+   MAC[2] = i64_to_i44<Flags>(1, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[1] << 12) - (int32)((uint32)(int32)IR2 << 12))) >> sf;
+   MAC[3] = i64_to_i44<Flags>(2, ((int64_t)((uint64_t)(int64_t)CRVectors.FC[2] << 12) - (int32)((uint32)(int32)IR3 << 12))) >> sf;
 
-   MAC[1] = i64_to_i44(0, ((int64_t)((uint64_t)(int64_t)IR1 << 12) + IR0 * i32_to_i16_saturate(0, MAC[1], false)) >> sf);
-   MAC[2] = i64_to_i44(1, ((int64_t)((uint64_t)(int64_t)IR2 << 12) + IR0 * i32_to_i16_saturate(1, MAC[2], false)) >> sf);
-   MAC[3] = i64_to_i44(2, ((int64_t)((uint64_t)(int64_t)IR3 << 12) + IR0 * i32_to_i16_saturate(2, MAC[3], false)) >> sf);
+   MAC[1] = i64_to_i44<Flags>(0, ((int64_t)((uint64_t)(int64_t)IR1 << 12) + IR0 * i32_to_i16_saturate<Flags>(0, MAC[1], false)) >> sf);
+   MAC[2] = i64_to_i44<Flags>(1, ((int64_t)((uint64_t)(int64_t)IR2 << 12) + IR0 * i32_to_i16_saturate<Flags>(1, MAC[2], false)) >> sf);
+   MAC[3] = i64_to_i44<Flags>(2, ((int64_t)((uint64_t)(int64_t)IR3 << 12) + IR0 * i32_to_i16_saturate<Flags>(2, MAC[3], false)) >> sf);
 
-   MAC_to_IR(lm);
-   MAC_to_RGB_FIFO();
+   MAC_to_IR<Flags>(lm);
+   MAC_to_RGB_FIFO<Flags>();
 
    return(8);
 }
 
 
+template<bool Flags>
 static INLINE void NormColorDepthCue(uint32_t instr, uint32_t v)
 {
    int16_t tmp_vector[3];
    const uint32_t sf = (instr & (1 << 19)) ? 12 : 0;
    const int      lm = (instr >> 10) & 1;
 
-   MultiplyMatrixByVector(&Matrices.Light, Vectors[v], CRVectors.Null, sf, lm);
+   MultiplyMatrixByVector<Flags>(&Matrices.Light, Vectors[v], CRVectors.Null, sf, lm);
 
    /* Use the custom 4th vector to store the intermediate
     * values. This vector does not exist in the real hardware
@@ -1409,48 +1526,52 @@ static INLINE void NormColorDepthCue(uint32_t instr, uint32_t v)
    tmp_vector[0] = IR1;
    tmp_vector[1] = IR2;
    tmp_vector[2] = IR3;
-   MultiplyMatrixByVector(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
+   MultiplyMatrixByVector<Flags>(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
 
-   DCPL(instr);
+   DCPL<Flags>(instr);
 }
 
 /* NCDS - Normal Color Depth Cue Single vector */
+template<bool Flags>
 static int32_t NCDS(uint32_t instr)
 {
-   NormColorDepthCue(instr, 0);
+   NormColorDepthCue<Flags>(instr, 0);
 
    return(19);
 }
 
 /* NDCT - Normal Color Depth Cue Triple */
+template<bool Flags>
 static int32_t NCDT(uint32_t instr)
 {
-   NormColorDepthCue(instr, 0);
-   NormColorDepthCue(instr, 1);
-   NormColorDepthCue(instr, 2);
+   NormColorDepthCue<Flags>(instr, 0);
+   NormColorDepthCue<Flags>(instr, 1);
+   NormColorDepthCue<Flags>(instr, 2);
 
    return(44);
 }
 
 /* CC - Color Color */
+template<bool Flags>
 static int32_t CC(uint32_t instr)
 {
    const uint32_t     sf = (instr & (1 << 19)) ? 12 : 0;
    const int          lm = (instr >> 10) & 1;
    int16_t tmp_vector[3] = {IR1, IR2, IR3 };
 
-   MultiplyMatrixByVector(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
+   MultiplyMatrixByVector<Flags>(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
 
    MAC[1] = ((RGB.R << 4) * IR1) >> sf;
    MAC[2] = ((RGB.G << 4) * IR2) >> sf;
    MAC[3] = ((RGB.B << 4) * IR3) >> sf;
 
-   MAC_to_IR(lm);
-   MAC_to_RGB_FIFO();
+   MAC_to_IR<Flags>(lm);
+   MAC_to_RGB_FIFO<Flags>();
 
    return(11);
 }
 
+template<bool Flags>
 static int32_t CDP(uint32_t instr)
 {
    int16_t tmp_vector[3];
@@ -1460,9 +1581,9 @@ static int32_t CDP(uint32_t instr)
    tmp_vector[0] = IR1;
    tmp_vector[1] = IR2;
    tmp_vector[2] = IR3;
-   MultiplyMatrixByVector(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
+   MultiplyMatrixByVector<Flags>(&Matrices.Color, tmp_vector, CRVectors.B, sf, lm);
 
-   DCPL(instr);
+   DCPL<Flags>(instr);
 
    return(13);
 }
@@ -1486,7 +1607,7 @@ static int32_t NCLIP(uint32_t instr)
        PGXP_NLCIP_valid(*((uint32*)&XY_FIFO[0]), *((uint32*)&XY_FIFO[1]), *((uint32*)&XY_FIFO[2])))
 	   sum = PGXP_NCLIP();
 
-   check_mac_overflow(sum);
+   check_mac_overflow<true>(sum);
 
    MAC[0] = sum;
 
@@ -1507,10 +1628,10 @@ static int32_t AVSZ3(uint32_t instr)
    int64_t zsf3    = ZSF3;
    int64_t average = zsf3 * sum;
 
-   check_mac_overflow(average);
+   check_mac_overflow<true>(average);
 
    MAC[0] = (int32_t)average;
-   OTZ    = i64_to_otz(MAC[0], false);
+   OTZ    = i64_to_otz<true>(MAC[0], false);
 
    return(5);
 }
@@ -1530,10 +1651,10 @@ static int32_t AVSZ4(uint32_t instr)
    int64_t zsf4    = ZSF4;
    int64_t average = zsf4 * sum;
 
-   check_mac_overflow(average);
+   check_mac_overflow<true>(average);
 
    MAC[0] = (int32_t)average;
-   OTZ    = i64_to_otz(MAC[0], false);
+   OTZ    = i64_to_otz<true>(MAC[0], false);
 
    return(5);
 }
@@ -1541,6 +1662,7 @@ static int32_t AVSZ4(uint32_t instr)
 
 // -32768 * -32768 - 32767 * -32768 = 2147450880
 // (2 ^ 31) - 1 =		      2147483647
+template<bool Flags>
 static int32_t OP(uint32_t instr)
 {
    const uint32_t sf = (instr & (1 << 19)) ? 12 : 0;
@@ -1556,11 +1678,12 @@ static int32_t OP(uint32_t instr)
    MAC[2] = (r2 * ir1 - r0 * ir3) >> sf;
    MAC[3] = (r0 * ir2 - r1 * ir1) >> sf;
 
-   MAC_to_IR(lm);
+   MAC_to_IR<Flags>(lm);
 
    return(6);
 }
 
+template<bool Flags>
 static int32_t GPF(uint32_t instr)
 {
    const uint32_t sf = (instr & (1 << 19)) ? 12 : 0;
@@ -1570,25 +1693,26 @@ static int32_t GPF(uint32_t instr)
    MAC[2] = (IR0 * IR2) >> sf;
    MAC[3] = (IR0 * IR3) >> sf;
 
-   MAC_to_IR(lm);
+   MAC_to_IR<Flags>(lm);
 
-   MAC_to_RGB_FIFO();
+   MAC_to_RGB_FIFO<Flags>();
 
    return(5);
 }
 
+template<bool Flags>
 static int32_t GPL(uint32_t instr)
 {
    const uint32_t sf = (instr & (1 << 19)) ? 12 : 0;
    const int      lm = (instr >> 10) & 1;
 
-   MAC[1] = i64_to_i44(0, (int64_t)((uint64_t)(int64_t)MAC[1] << sf) + (IR0 * IR1)) >> sf;
-   MAC[2] = i64_to_i44(1, (int64_t)((uint64_t)(int64_t)MAC[2] << sf) + (IR0 * IR2)) >> sf;
-   MAC[3] = i64_to_i44(2, (int64_t)((uint64_t)(int64_t)MAC[3] << sf) + (IR0 * IR3)) >> sf;
+   MAC[1] = i64_to_i44<Flags>(0, (int64_t)((uint64_t)(int64_t)MAC[1] << sf) + (IR0 * IR1)) >> sf;
+   MAC[2] = i64_to_i44<Flags>(1, (int64_t)((uint64_t)(int64_t)MAC[2] << sf) + (IR0 * IR2)) >> sf;
+   MAC[3] = i64_to_i44<Flags>(2, (int64_t)((uint64_t)(int64_t)MAC[3] << sf) + (IR0 * IR3)) >> sf;
 
-   MAC_to_IR(lm);
+   MAC_to_IR<Flags>(lm);
 
-   MAC_to_RGB_FIFO();
+   MAC_to_RGB_FIFO<Flags>();
 
    return(5);
 }
@@ -1619,20 +1743,19 @@ static int32_t GPL(uint32_t instr)
  opcode = operation code 
 */
 
-int32_t GTE_Instruction(uint32_t instr)
+template<bool Flags>
+static int32_t Execute(uint32_t instr)
 {
    const unsigned code = instr & 0x3F;
    int32_t ret = 1;
 
-   FLAGS = 0;
-
    switch(code)
    {
       default: 
          break;
       case 0x00:	// alternate?
       case 0x01:
-         ret = RTPS(instr);
+         ret = RTPS<Flags>(instr);
          break;
 
          /*
@@ -1672,7 +1795,7 @@ int32_t GTE_Instruction(uint32_t instr)
 */
 
       case 0x0C:
-         ret = OP(instr);
+         ret = OP<Flags>(instr);
          break;
 
          /*
@@ -1687,23 +1810,23 @@ int32_t GTE_Instruction(uint32_t instr)
             */
 
       case 0x10:
-         ret = DPCS(instr);
+         ret = DPCS<Flags>(instr);
          break;
 
       case 0x11:
-         ret = INTPL(instr);
+         ret = INTPL<Flags>(instr);
          break;
 
       case 0x12:
-         ret = MVMVA(instr);
+         ret = MVMVA<Flags>(instr);
          break;
 
       case 0x13:
-         ret = NCDS(instr);
+         ret = NCDS<Flags>(instr);
          break;
 
       case 0x14:
-         ret = CDP(instr);
+         ret = CDP<Flags>(instr);
          break;
 
 
@@ -1713,7 +1836,7 @@ int32_t GTE_Instruction(uint32_t instr)
             */
 
       case 0x16:
-         ret = NCDT(instr);
+         ret = NCDT<Flags>(instr);
          break;
 
          /*
@@ -1728,11 +1851,11 @@ int32_t GTE_Instruction(uint32_t instr)
             */
 
       case 0x1B:
-         ret = NCCS(instr);
+         ret = NCCS<Flags>(instr);
          break;
 
       case 0x1C:
-         ret = CC(instr);
+         ret = CC<Flags>(instr);
          break;
 
          /*
@@ -1741,7 +1864,7 @@ int32_t GTE_Instruction(uint32_t instr)
             */
 
       case 0x1E:
-         ret = NCS(instr);
+         ret = NCS<Flags>(instr);
          break;
 
          /*
@@ -1750,7 +1873,7 @@ int32_t GTE_Instruction(uint32_t instr)
             */
 
       case 0x20:
-         ret = NCT(instr);
+         ret = NCT<Flags>(instr);
          break;
          /*
             case 0x21:
@@ -1776,16 +1899,16 @@ int32_t GTE_Instruction(uint32_t instr)
             */
 
       case 0x28:
-         ret = SQR(instr);
+         ret = SQR<Flags>(instr);
          break;
 
 	  case 0x1A:	// Alternate for 0x29?
       case 0x29:
-         ret = DCPL(instr);
+         ret = DCPL<Flags>(instr);
          break;
 
       case 0x2A:
-         ret = DPCT(instr);
+         ret = DPCT<Flags>(instr);
          break;
 
          /*
@@ -1810,7 +1933,7 @@ int32_t GTE_Instruction(uint32_t instr)
             */
 
       case 0x30:
-         ret = RTPT(instr);
+         ret = RTPT<Flags>(instr);
          break;
 
          /*
@@ -1852,26 +1975,105 @@ int32_t GTE_Instruction(uint32_t instr)
             */
 
       case 0x3D:
-         ret = GPF(instr);
+         ret = GPF<Flags>(instr);
          break;
 
       case 0x3E:
-         ret = GPL(instr);
+         ret = GPL<Flags>(instr);
          break;
 
       case 0x3F:
-         ret = NCCT(instr);
+         ret = NCCT<Flags>(instr);
          break;
    }
 
-   // Overclock: force all GTE instruction to have 1 cycle latency
-   if (psx_cpu_overclock)
-      ret = 1;
+   return(ret);
+}
 
+static INLINE void UpdateFlagRegister(void)
+{
    if(FLAGS & 0x7f87e000)
       FLAGS |= 1 << 31;
 
    CR[31] = FLAGS;
+}
+
+static INLINE void SaveReplayState(gte_replay_state *st)
+{
+   memcpy(st->Vectors, Vectors, sizeof(Vectors));
+   st->RGB = RGB;
+   memcpy(st->IR, IR, sizeof(IR));
+   memcpy(st->MAC, MAC, sizeof(MAC));
+   memcpy(st->RGB_FIFO, RGB_FIFO, sizeof(RGB_FIFO));
+   st->widescreen_hack = widescreen_hack;
+}
+
+static INLINE void LoadReplayState(const gte_replay_state *st)
+{
+   memcpy(Vectors, st->Vectors, sizeof(Vectors));
+   RGB = st->RGB;
+   memcpy(IR, st->IR, sizeof(IR));
+   memcpy(MAC, st->MAC, sizeof(MAC));
+   memcpy(RGB_FIFO, st->RGB_FIFO, sizeof(RGB_FIFO));
+   widescreen_hack = st->widescreen_hack;
+}
+
+static void ResolvePendingFlags(void)
+{
+   gte_replay_state current;
+   gtexy xy_fifo[4];
+   uint16_t z_fifo[4];
+
+   if(MDFN_LIKELY(!FlagsPending))
+      return;
+
+   FlagsPending = false;
+
+   /* The FIFO pushes aren't inputs to the FLAGS, but they need undoing too */
+   SaveReplayState(&current);
+   memcpy(xy_fifo, XY_FIFO, sizeof(XY_FIFO));
+   memcpy(z_fifo, Z_FIFO, sizeof(Z_FIFO));
+   LoadReplayState(&ReplayState);
+
+   FlagsReplaying = true;
+   FLAGS = 0;
+   Execute<true>(ReplayInstr);
+   FlagsReplaying = false;
+
+   LoadReplayState(&current);
+   memcpy(XY_FIFO, xy_fifo, sizeof(XY_FIFO));
+   memcpy(Z_FIFO, z_fifo, sizeof(Z_FIFO));
+
+   UpdateFlagRegister();
+}
+
+int32_t GTE_Instruction(uint32_t instr)
+{
+   const unsigned code = instr & 0x3F;
+   int32_t ret;
+
+   /* NCLIP's result can come from PGXP, and AVSZ3/AVSZ4 read back the FLAGS they set */
+   if(psx_gte_lazy_flags && code != 0x06 && code != 0x2D && code != 0x2E)
+   {
+      SaveReplayState(&ReplayState);
+      ReplayInstr  = instr;
+      FlagsPending = true;
+
+      ret = Execute<false>(instr);
+   }
+   else
+   {
+      FlagsPending = false;
+      FLAGS = 0;
+
+      ret = Execute<true>(instr);
+
+      UpdateFlagRegister();
+   }
+
+   // Overclock: force all GTE instruction to have 1 cycle latency
+   if (psx_cpu_overclock)
+      ret = 1;
 
    return(ret - 1);
 }
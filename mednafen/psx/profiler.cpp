@@ -0,0 +1,441 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "psx.h"
+#include "profiler.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#define PROF_SLOTS         ((0x200000 + 0x80000) >> 2)   // RAM(mirrors folded) then BIOS, one per word.
+#define PROF_STACK_DEPTH   128
+#define PROF_MAX_NODES     65536
+#define PROF_REPORT_LINES  64
+
+struct ProfCounter
+{
+   uint64_t cycles;
+   uint32_t count;
+};
+
+struct ProfFrame
+{
+   uint32_t ret;
+   uint32_t node;	// Caller's.
+   bool exception;	// Entered through PROF_Exception(); may return to ret or ret + 4.
+};
+
+struct ProfNode
+{
+   uint32_t func;
+   uint32_t parent;
+   uint64_t cycles;	// Self.
+   std::map<uint32_t, uint32_t> children;
+};
+
+static ProfCounter *ProfPC;		// Per instruction.
+static ProfCounter *ProfBlock;	// Per block head, with cycles up to the next control transfer.
+static uint8_t *ProfFunc;		// Non-zero for call targets.
+
+static std::vector<ProfNode> ProfNodes;	// Call tree, [0] being the root.
+static ProfFrame ProfStack[PROF_STACK_DEPTH];
+static unsigned ProfDepth;
+static uint32_t ProfCurNode;
+
+static int ProfLastSlot;
+static int ProfBlockSlot;
+static uint32_t ProfLastPC;
+static uint32_t ProfLastInstr;
+static uint32_t ProfBranchInstr;	// The one before ProfLastInstr; the branch, if ProfLastInstr was its delay slot.
+static uint32_t ProfExceptionPC;	// Handler PROF_Exception() entered, ~0U if none.
+static int32_t ProfLastTS;
+
+static uint64_t ProfTotalCycles;
+static uint64_t ProfTotalInstructions;
+
+static INLINE int PROF_Slot(uint32_t pc)
+{
+   const uint32_t phys = pc & 0x1FFFFFFF;
+
+   if(phys < 0x00800000)
+      return (phys & 0x1FFFFF) >> 2;
+
+   if(phys >= 0x1FC00000 && phys < 0x1FC80000)
+      return (0x200000 + (phys & 0x7FFFF)) >> 2;
+
+   return -1;
+}
+
+static uint32_t PROF_SlotAddress(int slot)
+{
+   if(slot < (0x200000 >> 2))
+      return 0x80000000 | (slot << 2);
+
+   return 0xBFC00000 | ((slot << 2) - 0x200000);
+}
+
+static std::string PROF_Label(uint32_t address)
+{
+   char buf[16];
+
+   snprintf(buf, sizeof(buf), "sub_%08x", address);
+   return buf;
+}
+
+void PROF_Init(void)
+{
+   ProfNode root;
+
+   PROF_Kill();
+
+   ProfPC = (ProfCounter *)calloc(PROF_SLOTS, sizeof(ProfCounter));
+   ProfBlock = (ProfCounter *)calloc(PROF_SLOTS, sizeof(ProfCounter));
+   ProfFunc = (uint8_t *)calloc(PROF_SLOTS, sizeof(uint8_t));
+
+   root.func = 0;
+   root.parent = 0;
+   root.cycles = 0;
+   ProfNodes.push_back(root);
+
+   ProfDepth = 0;
+   ProfCurNode = 0;
+   ProfLastSlot = -1;
+   ProfBlockSlot = -1;
+   ProfLastPC = ~0U;
+   ProfLastInstr = 0;
+   ProfBranchInstr = 0;
+   ProfExceptionPC = ~0U;
+   ProfLastTS = 0;
+   ProfTotalCycles = 0;
+   ProfTotalInstructions = 0;
+}
+
+void PROF_Kill(void)
+{
+   if(ProfPC)
+      free(ProfPC);
+   ProfPC = NULL;
+
+   if(ProfBlock)
+      free(ProfBlock);
+   ProfBlock = NULL;
+
+   if(ProfFunc)
+      free(ProfFunc);
+   ProfFunc = NULL;
+
+   ProfNodes.clear();
+}
+
+static INLINE void PROF_Account(int32_t timestamp)
+{
+   const int32_t delta = timestamp - ProfLastTS;
+
+   ProfLastTS = timestamp;
+
+   if(delta <= 0)
+      return;
+
+   ProfTotalCycles += delta;
+
+   if(ProfLastSlot >= 0)
+      ProfPC[ProfLastSlot].cycles += delta;
+
+   if(ProfBlockSlot >= 0)
+      ProfBlock[ProfBlockSlot].cycles += delta;
+
+   ProfNodes[ProfCurNode].cycles += delta;
+}
+
+void PROF_Begin(int32_t timestamp)
+{
+   ProfLastTS = timestamp;
+}
+
+void PROF_End(int32_t timestamp)
+{
+   if(ProfPC)
+      PROF_Account(timestamp);
+}
+
+static bool PROF_IsCall(uint32_t instr)
+{
+   const uint32_t op = instr >> 26;
+
+   if(op == 0x03)						// JAL
+      return true;
+
+   if(op == 0x00 && (instr & 0x3F) == 0x09)		// JALR
+      return true;
+
+   if(op == 0x01 && ((instr >> 16) & 0x1E) == 0x10)	// BLTZAL, BGEZAL
+      return true;
+
+   return false;
+}
+
+static void PROF_Call(uint32_t ret, uint32_t target, bool exception)
+{
+   std::map<uint32_t, uint32_t>::iterator it = ProfNodes[ProfCurNode].children.find(target);
+   uint32_t child;
+
+   if(it != ProfNodes[ProfCurNode].children.end())
+      child = it->second;
+   else
+   {
+      ProfNode n;
+
+      if(ProfNodes.size() >= PROF_MAX_NODES)
+         return;	// Charged to the caller from here on.
+
+      n.func = target;
+      n.parent = ProfCurNode;
+      n.cycles = 0;
+
+      child = ProfNodes.size();
+      ProfNodes.push_back(n);
+      ProfNodes[ProfCurNode].children[target] = child;
+   }
+
+   // Calls that never return(thread switches, longjmp()) would otherwise fill the stack.
+   if(ProfDepth == PROF_STACK_DEPTH)
+   {
+      memmove(&ProfStack[0], &ProfStack[1], sizeof(ProfStack[0]) * (PROF_STACK_DEPTH - 1));
+      ProfDepth--;
+   }
+
+   ProfStack[ProfDepth].ret = ret;
+   ProfStack[ProfDepth].node = ProfCurNode;
+   ProfStack[ProfDepth].exception = exception;
+   ProfDepth++;
+
+   ProfCurNode = child;
+}
+
+static void PROF_Transfer(uint32_t pc, int slot)
+{
+   unsigned i;
+
+   ProfBlockSlot = slot;
+
+   if(slot >= 0)
+      ProfBlock[slot].count++;
+
+   if(pc == ProfExceptionPC)
+   {
+      ProfExceptionPC = ~0U;
+      return;
+   }
+
+   if(PROF_IsCall(ProfBranchInstr))
+   {
+      if(slot >= 0)
+         ProfFunc[slot] = 1;
+
+      PROF_Call(ProfLastPC + 4, pc, false);
+      return;
+   }
+
+   for(i = ProfDepth; i > 0; i--)
+   {
+      const ProfFrame *f = &ProfStack[i - 1];
+
+      if(f->ret == pc || (f->exception && (f->ret + 4) == pc))
+      {
+         ProfCurNode = f->node;
+         ProfDepth = i - 1;
+         break;
+      }
+   }
+}
+
+void PROF_Instruction(uint32_t pc, uint32_t instr, int32_t timestamp)
+{
+   const int slot = PROF_Slot(pc);
+
+   if(!ProfPC)
+      return;
+
+   PROF_Account(timestamp);
+
+   if(pc != ProfLastPC + 4)
+      PROF_Transfer(pc, slot);
+
+   ProfTotalInstructions++;
+
+   if(slot >= 0)
+      ProfPC[slot].count++;
+
+   ProfLastSlot = slot;
+   ProfBranchInstr = ProfLastInstr;
+   ProfLastInstr = instr;
+   ProfLastPC = pc;
+}
+
+void PROF_Exception(uint32_t epc, uint32_t handler)
+{
+   const int slot = PROF_Slot(handler);
+
+   if(!ProfPC)
+      return;
+
+   if(slot >= 0)
+      ProfFunc[slot] = 1;
+
+   PROF_Call(epc, handler, true);
+   ProfExceptionPC = handler;
+}
+
+struct ProfByCycles
+{
+   const ProfCounter *c;
+
+   bool operator()(int a, int b) const
+   {
+      return c[a].cycles > c[b].cycles;
+   }
+};
+
+static double PROF_Percent(uint64_t cycles)
+{
+   return ProfTotalCycles ? (cycles * 100.0 / ProfTotalCycles) : 0.0;
+}
+
+static void PROF_SortSlots(const ProfCounter *c, int count, std::vector<int> &slots)
+{
+   ProfByCycles cmp;
+   size_t n;
+
+   slots.clear();
+
+   for(int i = 0; i < count; i++)
+   {
+      if(c[i].count)
+         slots.push_back(i);
+   }
+
+   cmp.c = c;
+   n = std::min<size_t>(slots.size(), PROF_REPORT_LINES);
+   std::partial_sort(slots.begin(), slots.begin() + n, slots.end(), cmp);
+   slots.resize(n);
+}
+
+static void PROF_WriteReport(FILE *fp)
+{
+   std::vector<int> slots;
+   std::vector<ProfCounter> funcs(PROF_SLOTS + 1);	// [PROF_SLOTS] is code before any known function.
+   int func = PROF_SLOTS;
+   size_t i;
+
+   fprintf(fp, "Instructions: %llu\n", (unsigned long long)ProfTotalInstructions);
+   fprintf(fp, "Cycles:       %llu\n", (unsigned long long)ProfTotalCycles);
+
+   fprintf(fp, "\nHottest instructions:\n");
+   fprintf(fp, "  %-8s %12s %14s %7s  %s\n", "PC", "count", "cycles", "%", "instruction");
+   PROF_SortSlots(ProfPC, PROF_SLOTS, slots);
+
+   for(i = 0; i < slots.size(); i++)
+   {
+      const ProfCounter *c = &ProfPC[slots[i]];
+      const uint32_t address = PROF_SlotAddress(slots[i]);
+
+      fprintf(fp, "  %08x %12u %14llu %6.2f%%  %s\n", address, c->count, (unsigned long long)c->cycles, PROF_Percent(c->cycles),
+            DisassembleMIPS(address, CPU->PeekMem32(address)).c_str());
+   }
+
+   fprintf(fp, "\nHottest blocks:\n");
+   fprintf(fp, "  %-8s %12s %14s %7s %10s  %s\n", "head", "entries", "cycles", "%", "cycles/run", "first instruction");
+   PROF_SortSlots(ProfBlock, PROF_SLOTS, slots);
+
+   for(i = 0; i < slots.size(); i++)
+   {
+      const ProfCounter *c = &ProfBlock[slots[i]];
+      const uint32_t address = PROF_SlotAddress(slots[i]);
+
+      fprintf(fp, "  %08x %12u %14llu %6.2f%% %10llu  %s\n", address, c->count, (unsigned long long)c->cycles, PROF_Percent(c->cycles),
+            (unsigned long long)(c->cycles / c->count), DisassembleMIPS(address, CPU->PeekMem32(address)).c_str());
+   }
+
+   // Each instruction is charged to the closest call target at or below it.
+   memset(&funcs[0], 0, sizeof(ProfCounter) * funcs.size());
+
+   for(int s = 0; s < PROF_SLOTS; s++)
+   {
+      if(s == (0x200000 >> 2))
+         func = PROF_SLOTS;	// BIOS functions don't extend into RAM, nor vice versa.
+
+      if(ProfFunc[s])
+         func = s;
+
+      funcs[func].cycles += ProfPC[s].cycles;
+      funcs[func].count += ProfPC[s].count;
+   }
+
+   fprintf(fp, "\nHottest functions(self):\n");
+   fprintf(fp, "  %-12s %12s %14s %7s\n", "function", "instructions", "cycles", "%");
+   PROF_SortSlots(&funcs[0], PROF_SLOTS + 1, slots);
+
+   for(i = 0; i < slots.size(); i++)
+   {
+      const ProfCounter *c = &funcs[slots[i]];
+      const std::string label = (slots[i] == PROF_SLOTS) ? "[unknown]" : PROF_Label(PROF_SlotAddress(slots[i]));
+
+      fprintf(fp, "  %-12s %12u %14llu %6.2f%%\n", label.c_str(), c->count, (unsigned long long)c->cycles, PROF_Percent(c->cycles));
+   }
+}
+
+static void PROF_WriteFolded(FILE *fp)
+{
+   for(size_t i = 0; i < ProfNodes.size(); i++)
+   {
+      std::string stack;
+
+      if(!ProfNodes[i].cycles)
+         continue;
+
+      for(uint32_t n = i; n; n = ProfNodes[n].parent)
+         stack = PROF_Label(ProfNodes[n].func) + (stack.empty() ? "" : ";") + stack;
+
+      if(stack.empty())
+         stack = "[unknown]";
+
+      fprintf(fp, "%s %llu\n", stack.c_str(), (unsigned long long)ProfNodes[i].cycles);
+   }
+}
+
+void PROF_Dump(const char *report_path, const char *folded_path)
+{
+   FILE *fp;
+
+   if(!ProfPC)
+      return;
+
+   if((fp = fopen(report_path, "w")))
+   {
+      PROF_WriteReport(fp);
+      fclose(fp);
+   }
+
+   if((fp = fopen(folded_path, "w")))
+   {
+      PROF_WriteFolded(fp);
+      fclose(fp);
+   }
+}
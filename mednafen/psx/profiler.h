@@ -0,0 +1,28 @@
+#ifndef __MDFN_PSX_PROFILER_H
+#define __MDFN_PSX_PROFILER_H
+
+#include <stdint.h>
+
+//
+// Guest code profiler, built with HAVE_CPU_PROFILER=1.  PS_CPU then always runs the
+// DebugMode interpreter, which reports every instruction fetched; instruction counts and
+// cycles are kept per PC, per basic block(branch target) and per call stack.
+//
+// DebugMode also turns off idle loop skipping, BIOS call HLE and the cached interpreter and
+// dynarec cores, whatever the core options say, so the profile is of the plain interpreter
+// running every guest instruction: the BIOS calls and idle loops show up, and the cycles
+// are the interpreter's.
+//
+void PROF_Init(void);
+void PROF_Kill(void);
+
+void PROF_Begin(int32_t timestamp);
+void PROF_End(int32_t timestamp);
+void PROF_Instruction(uint32_t pc, uint32_t instr, int32_t timestamp);
+void PROF_Exception(uint32_t epc, uint32_t handler);
+
+// Writes a report of the hottest instructions, blocks and functions to report_path, and
+// the call stacks in flamegraph.pl's folded format to folded_path.
+void PROF_Dump(const char *report_path, const char *folded_path);
+
+#endif
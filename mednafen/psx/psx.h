@@ -83,7 +83,43 @@ void PSX_SetEventNT(const int type, const int32_t next_timestamp);
 
 void PSX_SetDMACycleSteal(unsigned stealage);
 
-void PSX_GPULineHook(const int32_t timestamp, const int32_t line_timestamp, bool vsync, uint32_t *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock_offset, const unsigned pix_clock, const unsigned pix_clock_divide);
+//
+// Self-modifying code tracking for main RAM.  Code caches mark the 4KiB pages(physical address,
+// mirrors folded) they've decoded or translated, and every store to a marked page clears its bit and
+// calls the registered invalidation callbacks with the page's address.  Stores to unmarked pages
+// only pay for the bitmap test.  The BIOS is ROM, so it isn't tracked.
+//
+#define PSX_CODE_PAGE_SHIFT         12
+#define PSX_CODE_PAGE_COUNT         ((2048 * 1024) >> PSX_CODE_PAGE_SHIFT)
+
+typedef void (*psx_code_invalidate_t)(void *data, uint32_t page_address);
+
+extern uint32_t PSX_CodePageMap[PSX_CODE_PAGE_COUNT / 32];
+
+void PSX_AddCodeInvalidateCB(psx_code_invalidate_t cb, void *data);
+void PSX_RemoveCodeInvalidateCB(psx_code_invalidate_t cb, void *data);
+void PSX_InvalidateCodePage(uint32_t A);
+
+static INLINE void PSX_MarkCodePage(uint32_t A)
+{
+   const uint32_t page = (A & 0x1FFFFF) >> PSX_CODE_PAGE_SHIFT;
+
+   PSX_CodePageMap[page >> 5] |= 1U << (page & 0x1F);
+}
+
+static INLINE void PSX_CodeWriteCheck(uint32_t A)
+{
+   const uint32_t page = (A & 0x1FFFFF) >> PSX_CODE_PAGE_SHIFT;
+
+   if(MDFN_UNLIKELY(PSX_CodePageMap[page >> 5] & (1U << (page & 0x1F))))
+      PSX_InvalidateCodePage(A);
+}
+
+void PSX_GPULineHook(const int32_t timestamp, const int32_t line_timestamp, bool vsync, surface_pixel *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock_offset, const unsigned pix_clock, const unsigned pix_clock_divide);
+
+// Whether PSX_GPULineHook() needs each line's pixels as it's called(for the light guns);
+// otherwise the GPU may output them later and pass NULL.
+bool PSX_GPULineHookNeedsPixels(void);
 
 uint32_t PSX_GetRandU32(uint32_t mina, uint32_t maxa);
 
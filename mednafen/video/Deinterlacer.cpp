@@ -141,7 +141,7 @@ void Deinterlacer::InternalProcess(MDFN_Surface *surface, MDFN_Rect &DisplayRect
    const T* src = surface->pixels + ((y * 2) + field + DisplayRect.y) * surface->pitchinpix + DisplayRect.x;
    T* dest = FieldBuffer->pixels + y * FieldBuffer->pitchinpix;
 
-   memcpy(dest, src, *src_lw * sizeof(uint32));
+   memcpy(dest, src, *src_lw * sizeof(T));
    LWBuffer[y] = *src_lw;
 
    StateValid = true;
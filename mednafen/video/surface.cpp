@@ -31,7 +31,7 @@ MDFN_PixelFormat::MDFN_PixelFormat()
 
 MDFN_PixelFormat::MDFN_PixelFormat(const unsigned int p_colorspace, const uint8 p_rs, const uint8 p_gs, const uint8 p_bs, const uint8 p_as)
 {
-   bpp = 32;
+   bpp = SURFACE_BPP;
    colorspace = p_colorspace;
 
    Rshift = p_rs;
@@ -68,7 +68,7 @@ bool MDFN_Surface::Init(void *const p_pixels, const uint32 p_width, const uint32
    if(!rpix)
       return false;
 
-   pixels = (uint32 *)rpix;
+   pixels = (surface_pixel *)rpix;
 
    w = p_width;
    h = p_height;
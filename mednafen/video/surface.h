@@ -1,12 +1,28 @@
 #ifndef __MDFN_SURFACE_H
 #define __MDFN_SURFACE_H
 
+// The surface is RGB565 when built with NEED_BPP=16, XRGB8888 otherwise.  MAKECOLOR takes
+// 8-bit components either way, and drops the low bits for RGB565.
+#if defined(WANT_16BPP)
+#define SURFACE_BPP 16
+#define RED_SHIFT 11
+#define GREEN_SHIFT 5
+#define BLUE_SHIFT 0
+#define ALPHA_SHIFT 0
+#define MAKECOLOR(r, g, b, a) ((((r) >> 3) << RED_SHIFT) | (((g) >> 2) << GREEN_SHIFT) | (((b) >> 3) << BLUE_SHIFT))
+
+typedef uint16 surface_pixel;
+#else
+#define SURFACE_BPP 32
 #define RED_SHIFT 16
 #define GREEN_SHIFT 8
 #define BLUE_SHIFT 0
 #define ALPHA_SHIFT 24
 #define MAKECOLOR(r, g, b, a) ((r << RED_SHIFT) | (g << GREEN_SHIFT) | (b << BLUE_SHIFT) | (a << ALPHA_SHIFT))
 
+typedef uint32 surface_pixel;
+#endif
+
 struct MDFN_PaletteEntry
 {
  uint8 r, g, b;
@@ -56,19 +72,25 @@ class MDFN_PixelFormat
 
  uint8 Ashift;  // [...] alpha component.
 
- // Gets the R/G/B/A values for the passed 32-bit surface pixel value
+ // Gets the R/G/B/A values for the passed surface pixel value
  INLINE void DecodeColor(uint32 value, int &r, int &g, int &b, int &a) const
  {
+#if SURFACE_BPP == 16
+    r = ((value >> RED_SHIFT) & 0x1F) << 3;
+    g = ((value >> GREEN_SHIFT) & 0x3F) << 2;
+    b = ((value >> BLUE_SHIFT) & 0x1F) << 3;
+    a = 0;
+#else
     r = (value >> RED_SHIFT) & 0xFF;
     g = (value >> GREEN_SHIFT) & 0xFF;
     b = (value >> BLUE_SHIFT) & 0xFF;
     a = (value >> ALPHA_SHIFT) & 0xFF;
+#endif
  }
 
 }; // MDFN_PixelFormat;
 
-// Supports 32-bit RGBA
-//  16-bit is WIP
+// Supports 32-bit RGBA and 16-bit RGB565, chosen at build time(see SURFACE_BPP)
 class MDFN_Surface //typedef struct
 {
  public:
@@ -78,7 +100,7 @@ class MDFN_Surface //typedef struct
 
  ~MDFN_Surface();
 
- uint32 *pixels;
+ surface_pixel *pixels;
 
  // w, h, and pitch32 should always be > 0
  int32 w;
@@ -96,20 +118,27 @@ class MDFN_Surface //typedef struct
 
  void SetFormat(const MDFN_PixelFormat &new_format, bool convert);
 
- // Gets the R/G/B/A values for the passed 32-bit surface pixel value
+ // Gets the R/G/B/A values for the passed surface pixel value
  INLINE void DecodeColor(uint32 value, int &r, int &g, int &b, int &a) const
  {
+#if SURFACE_BPP == 16
+    r = ((value >> RED_SHIFT) & 0x1F) << 3;
+    g = ((value >> GREEN_SHIFT) & 0x3F) << 2;
+    b = ((value >> BLUE_SHIFT) & 0x1F) << 3;
+    a = 0;
+#else
     r = (value >> RED_SHIFT) & 0xFF;
     g = (value >> GREEN_SHIFT) & 0xFF;
     b = (value >> BLUE_SHIFT) & 0xFF;
     a = (value >> ALPHA_SHIFT) & 0xFF;
+#endif
  }
 
  INLINE void DecodeColor(uint32 value, int &r, int &g, int &b) const
  {
-    r = (value >> RED_SHIFT) & 0xFF;
-    g = (value >> GREEN_SHIFT) & 0xFF;
-    b = (value >> BLUE_SHIFT) & 0xFF;
+    int a;
+
+    DecodeColor(value, r, g, b, a);
  }
  private:
  bool Init(void *const p_pixels, const uint32 p_width, const uint32 p_height, const uint32 p_pitchinpix, const MDFN_PixelFormat &nf);